@@ -279,6 +279,9 @@ void AppMenuModel::updateApplicationMenu(const QString &serviceName, const QStri
     }
 
     m_importer = new KDBusMenuImporter(serviceName, menuObjectPath, this);
+    // The submenus get popped up right from the menu bar
+    m_importer->setPrefetchDepth(1);
+    m_importer->setLayoutCacheEnabled(true);
     QMetaObject::invokeMethod(m_importer, "updateMenu", Qt::QueuedConnection);
 
     connect(m_importer.data(), &DBusMenuImporter::menuUpdated, this, [=](QMenu *menu) {
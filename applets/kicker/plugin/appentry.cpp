@@ -113,6 +113,22 @@ KService::Ptr AppEntry::service() const
     return m_service;
 }
 
+bool AppEntry::setService(KService::Ptr service, NameFormat nameFormat)
+{
+    const QString oldName = m_name;
+    const QString oldDescription = m_description;
+    const bool iconChanged = m_service->icon() != service->icon();
+
+    m_service = service;
+    init(nameFormat);
+
+    if (iconChanged) {
+        m_icon = QIcon();
+    }
+
+    return iconChanged || m_name != oldName || m_description != oldDescription;
+}
+
 QString AppEntry::id() const
 {
     if (!m_id.isEmpty()) {
@@ -332,3 +348,22 @@ AbstractModel *AppGroupEntry::childModel() const
 {
     return m_childModel;
 }
+
+KServiceGroup::Ptr AppGroupEntry::serviceGroup() const
+{
+    return m_group;
+}
+
+bool AppGroupEntry::setServiceGroup(KServiceGroup::Ptr group)
+{
+    const bool iconChanged = m_group->icon() != group->icon();
+    const bool nameChanged = m_group->caption() != group->caption();
+
+    m_group = group;
+
+    if (iconChanged) {
+        m_icon = QIcon();
+    }
+
+    return iconChanged || nameChanged;
+}
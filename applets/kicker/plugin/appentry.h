@@ -40,6 +40,12 @@ public:
     QString description() const override;
     KService::Ptr service() const;
 
+    /**
+     * Switches to @p service, the same application read from a newer KSycoca database.
+     * @returns whether the name, description or icon changed
+     */
+    bool setService(KService::Ptr service, NameFormat nameFormat);
+
     QString id() const override;
     QUrl url() const override;
 
@@ -76,6 +82,14 @@ public:
     bool hasChildren() const override;
     AbstractModel *childModel() const override;
 
+    KServiceGroup::Ptr serviceGroup() const;
+
+    /**
+     * Switches to @p group, the same group read from a newer KSycoca database.
+     * @returns whether the name or icon changed
+     */
+    bool setServiceGroup(KServiceGroup::Ptr group);
+
 private:
     KServiceGroup::Ptr m_group;
     mutable QIcon m_icon;
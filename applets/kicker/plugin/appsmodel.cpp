@@ -80,6 +80,7 @@ AppsModel::~AppsModel()
 {
     if (m_deleteEntriesOnDestruction) {
         qDeleteAll(m_entryList);
+        qDeleteAll(m_removedEntries);
     }
 }
 
@@ -473,6 +474,22 @@ static bool containsSameStorageId(const QList<AbstractEntry *> &entryList, KServ
     });
 }
 
+// Identify the entries which can be taken over when the KSycoca database changed
+static QString appKey(KService::Ptr service)
+{
+    return QLatin1String("app:") + service->storageId();
+}
+
+static QString groupKey(KServiceGroup::Ptr group)
+{
+    return QLatin1String("group:") + group->relPath();
+}
+
+static QString separatorKey(int index)
+{
+    return QLatin1String("separator:") + QString::number(index);
+}
+
 void AppsModel::refreshInternal()
 {
     if (m_staticEntryList) {
@@ -506,8 +523,7 @@ void AppsModel::refreshInternal()
                 KServiceGroup::Ptr subGroup(static_cast<KServiceGroup *>(p.data()));
 
                 if (!subGroup->noDisplay() && subGroup->childCount() > 0) {
-                    AppGroupEntry *groupEntry = new AppGroupEntry(this, subGroup, m_paginate, m_pageSize, m_flat, m_sorted, m_showSeparators, m_appNameFormat);
-                    m_entryList << groupEntry;
+                    m_entryList << groupEntry(subGroup);
                 }
             } else if (p->isType(KST_KService) && m_showTopLevelItems) {
                 const KService::Ptr service(static_cast<KService *>(p.data()));
@@ -517,7 +533,7 @@ void AppsModel::refreshInternal()
                 }
 
                 if (!containsSameStorageId(m_entryList, service)) {
-                    m_entryList << new AppEntry(this, service, m_appNameFormat);
+                    m_entryList << appEntry(service);
                 }
             } else if (p->isType(KST_KServiceSeparator) && m_showSeparators && m_showTopLevelItems) {
                 if (!m_entryList.count()) {
@@ -528,7 +544,7 @@ void AppsModel::refreshInternal()
                     continue;
                 }
 
-                m_entryList << new SeparatorEntry(this);
+                m_entryList << separatorEntry();
                 ++m_separatorCount;
             }
         }
@@ -544,14 +560,16 @@ void AppsModel::refreshInternal()
             sortEntries();
         }
 
-        m_changeTimer = new QTimer(this);
-        m_changeTimer->setSingleShot(true);
-        m_changeTimer->setInterval(100);
-        connect(m_changeTimer, SIGNAL(timeout()), this, SLOT(refresh()));
+        if (!m_changeTimer) {
+            m_changeTimer = new QTimer(this);
+            m_changeTimer->setSingleShot(true);
+            m_changeTimer->setInterval(100);
+            connect(m_changeTimer, &QTimer::timeout, this, &AppsModel::refreshIncrementally);
 
-        connect(KSycoca::self(), &KSycoca::databaseChanged, this, [this]() {
-            m_changeTimer->start();
-        });
+            connect(KSycoca::self(), &KSycoca::databaseChanged, this, [this]() {
+                m_changeTimer->start();
+            });
+        }
     } else {
         KServiceGroup::Ptr group = KServiceGroup::group(m_entryPath);
         processServiceGroup(group);
@@ -596,6 +614,134 @@ void AppsModel::refreshInternal()
     }
 }
 
+void AppsModel::refreshIncrementally()
+{
+    if (!m_complete) {
+        return;
+    }
+
+    if (m_staticEntryList) {
+        return;
+    }
+
+    if (rootModel() == this && !m_appletInterface) {
+        return;
+    }
+
+    QSet<AbstractEntry *> changedEntries;
+    updateEntries(changedEntries);
+
+    if (favoritesModel()) {
+        favoritesModel()->refresh();
+    }
+}
+
+QList<AbstractEntry *> AppsModel::rebuildEntryList(const QList<AbstractEntry *> &reusableEntries, QSet<AbstractEntry *> &changedEntries)
+{
+    int separatorIndex = 0;
+
+    for (AbstractEntry *entry : reusableEntries) {
+        if (entry->type() == AbstractEntry::RunnableType) {
+            m_reusableEntries.insert(appKey(static_cast<AppEntry *>(entry)->service()), entry);
+        } else if (const AppGroupEntry *groupEntry = dynamic_cast<const AppGroupEntry *>(entry)) {
+            m_reusableEntries.insert(groupKey(groupEntry->serviceGroup()), entry);
+        } else if (entry->type() == AbstractEntry::SeparatorType) {
+            m_reusableEntries.insert(separatorKey(separatorIndex++), entry);
+        }
+    }
+
+    // The reusable entries are still referenced by the current list, refreshInternal()
+    // must not delete them
+    const QList<AbstractEntry *> currentEntries = m_entryList;
+    m_entryList.clear();
+
+    refreshInternal();
+
+    const QList<AbstractEntry *> entryList = m_entryList;
+    m_entryList = currentEntries;
+
+    m_reusableEntries.clear();
+    changedEntries.unite(m_changedEntries);
+    m_changedEntries.clear();
+
+    return entryList;
+}
+
+void AppsModel::updateEntries(QSet<AbstractEntry *> &changedEntries)
+{
+    if (m_staticEntryList) {
+        return;
+    }
+
+    if (m_paginate) {
+        // Pages are cut from the sorted list, any change shifts all of them
+        refresh();
+        return;
+    }
+
+    const int separatorCount = m_separatorCount;
+    const QList<AbstractEntry *> previousEntries = m_entryList;
+
+    applyEntryList(rebuildEntryList(m_entryList, changedEntries), changedEntries);
+    updateChildModels(previousEntries, changedEntries);
+
+    if (m_separatorCount != separatorCount) {
+        Q_EMIT separatorCountChanged();
+    }
+}
+
+void AppsModel::updateChildModels(const QList<AbstractEntry *> &previousEntries, QSet<AbstractEntry *> &changedEntries)
+{
+    const QSet<AbstractEntry *> previous(previousEntries.cbegin(), previousEntries.cend());
+
+    // New groups were built from the current database already
+    for (AbstractEntry *entry : std::as_const(m_entryList)) {
+        if (dynamic_cast<AppGroupEntry *>(entry) && previous.contains(entry)) {
+            if (AppsModel *model = qobject_cast<AppsModel *>(entry->childModel())) {
+                model->updateEntries(changedEntries);
+            }
+        }
+    }
+}
+
+void AppsModel::applyEntryList(const QList<AbstractEntry *> &entryList, const QSet<AbstractEntry *> &changedEntries)
+{
+    const int oldCount = m_entryList.count();
+
+    const QList<AbstractEntry *> removedEntries = Kicker::updateRows(this, m_entryList, entryList);
+
+    if (!changedEntries.isEmpty()) {
+        for (int i = 0; i < m_entryList.count(); ++i) {
+            if (changedEntries.contains(m_entryList.at(i))) {
+                const QModelIndex idx = index(i, 0);
+                Q_EMIT dataChanged(idx, idx);
+            }
+        }
+    }
+
+    if (m_deleteEntriesOnDestruction && !removedEntries.isEmpty()) {
+        for (AbstractEntry *entry : removedEntries) {
+            if (dynamic_cast<AppGroupEntry *>(entry) && entry->childModel()) {
+                entry->childModel()->deleteLater();
+            }
+        }
+
+        // Models sharing these entries, like the one listing all applications,
+        // may only be updated after this one
+        if (m_removedEntries.isEmpty()) {
+            QTimer::singleShot(0, this, [this]() {
+                qDeleteAll(m_removedEntries);
+                m_removedEntries.clear();
+            });
+        }
+        m_removedEntries += removedEntries;
+    }
+
+    if (m_entryList.count() != oldCount) {
+        Q_EMIT countChanged();
+    }
+}
+
 void AppsModel::processServiceGroup(KServiceGroup::Ptr group)
 {
     if (!group || !group->isValid()) {
@@ -648,7 +794,7 @@ void AppsModel::processServiceGroup(KServiceGroup::Ptr group)
             }
 
             if (!containsSameStorageId(m_entryList, service)) {
-                m_entryList << new AppEntry(this, service, m_appNameFormat);
+                m_entryList << appEntry(service);
             }
         } else if (p->isType(KST_KServiceSeparator) && m_showSeparators) {
             if (!m_entryList.count()) {
@@ -659,7 +805,7 @@ void AppsModel::processServiceGroup(KServiceGroup::Ptr group)
                 continue;
             }
 
-            m_entryList << new SeparatorEntry(this);
+            m_entryList << separatorEntry();
             ++m_separatorCount;
         } else if (p->isType(KST_KServiceGroup)) {
             const KServiceGroup::Ptr subGroup(static_cast<KServiceGroup *>(p.data()));
@@ -673,8 +819,7 @@ void AppsModel::processServiceGroup(KServiceGroup::Ptr group)
                 const KServiceGroup::Ptr serviceGroup(static_cast<KServiceGroup *>(p.data()));
                 processServiceGroup(serviceGroup);
             } else {
-                AppGroupEntry *groupEntry = new AppGroupEntry(this, subGroup, m_paginate, m_pageSize, m_flat, m_sorted, m_showSeparators, m_appNameFormat);
-                m_entryList << groupEntry;
+                m_entryList << groupEntry(subGroup);
             }
         }
     }
@@ -693,6 +838,41 @@ void AppsModel::sortEntries()
     });
 }
 
+AbstractEntry *AppsModel::appEntry(KService::Ptr service)
+{
+    if (AbstractEntry *entry = m_reusableEntries.take(appKey(service))) {
+        if (static_cast<AppEntry *>(entry)->setService(service, m_appNameFormat)) {
+            m_changedEntries.insert(entry);
+        }
+
+        return entry;
+    }
+
+    return new AppEntry(this, service, m_appNameFormat);
+}
+
+AbstractEntry *AppsModel::groupEntry(KServiceGroup::Ptr group)
+{
+    if (AbstractEntry *entry = m_reusableEntries.take(groupKey(group))) {
+        if (static_cast<AppGroupEntry *>(entry)->setServiceGroup(group)) {
+            m_changedEntries.insert(entry);
+        }
+
+        return entry;
+    }
+
+    return new AppGroupEntry(this, group, m_paginate, m_pageSize, m_flat, m_sorted, m_showSeparators, m_appNameFormat);
+}
+
+AbstractEntry *AppsModel::separatorEntry()
+{
+    if (AbstractEntry *entry = m_reusableEntries.take(separatorKey(m_separatorCount))) {
+        return entry;
+    }
+
+    return new SeparatorEntry(this);
+}
+
 void AppsModel::entryChanged(AbstractEntry *entry)
 {
     int i = m_entryList.indexOf(entry);
@@ -9,7 +9,9 @@
 
 #include "abstractmodel.h"
 #include "appentry.h"
+#include "listdiff.h"
 
+#include <QHash>
 #include <QQmlParserStatus>
 
 #include <KServiceGroup>
@@ -90,6 +92,14 @@ public:
 
     void entryChanged(AbstractEntry *entry) override;
 
+    /**
+     * Replaces the entries with @p entryList, emitting row signals only for the rows
+     * which were removed, moved or inserted and dataChanged for the kept rows whose
+     * entry is in @p changedEntries. Entries which are gone are deleted if the model
+     * owns its entries.
+     */
+    void applyEntryList(const QList<AbstractEntry *> &entryList, const QSet<AbstractEntry *> &changedEntries);
+
     void classBegin() override;
     void componentComplete() override;
 
@@ -109,9 +119,22 @@ Q_SIGNALS:
 protected Q_SLOTS:
     void refresh() override;
 
+    // Brings the model up to date with a changed KSycoca database without resetting it
+    virtual void refreshIncrementally();
+
 protected:
     void refreshInternal();
 
+    /**
+     * Builds the entries for the current KSycoca database like refreshInternal(), but
+     * takes over the applications, groups and separators which are in @p reusableEntries
+     * already. Reused entries whose data changed are added to @p changedEntries.
+     * The new list is returned, m_entryList is left alone.
+     */
+    QList<AbstractEntry *> rebuildEntryList(const QList<AbstractEntry *> &reusableEntries, QSet<AbstractEntry *> &changedEntries);
+    void updateEntries(QSet<AbstractEntry *> &changedEntries);
+    void updateChildModels(const QList<AbstractEntry *> &previousEntries, QSet<AbstractEntry *> &changedEntries);
+
     bool m_complete;
 
     bool m_paginate;
@@ -126,9 +149,16 @@ protected:
     QObject *m_appletInterface;
 
 private:
+    template<typename T, typename Model, typename KeyFunction>
+    friend QList<T> Kicker::updateRows(Model *model, QList<T> &current, const QList<T> &target, KeyFunction key);
+
     void processServiceGroup(KServiceGroup::Ptr group);
     void sortEntries();
 
+    AbstractEntry *appEntry(KService::Ptr service);
+    AbstractEntry *groupEntry(KServiceGroup::Ptr group);
+    AbstractEntry *separatorEntry();
+
     bool m_autoPopulate;
 
     QString m_description;
@@ -139,5 +169,10 @@ private:
     bool m_sorted;
     AppEntry::NameFormat m_appNameFormat;
     QStringList m_hiddenEntries;
+    // Entries taken over by rebuildEntryList(), by their entryKey()
+    QHash<QString, AbstractEntry *> m_reusableEntries;
+    QSet<AbstractEntry *> m_changedEntries;
+    // Entries removed by applyEntryList(), deleted once the models sharing them caught up
+    QList<AbstractEntry *> m_removedEntries;
     static MenuEntryEditor *m_menuEntryEditor;
 };
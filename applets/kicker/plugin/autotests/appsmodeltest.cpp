@@ -0,0 +1,263 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QSignalSpy>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <KDesktopFile>
+#include <KSycoca>
+
+#include "appentry.h"
+#include "appsmodel.h"
+#include "rootmodel.h"
+
+static const int s_menuSize = 2000;
+
+class AppsModelTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void testOneApplicationChange();
+    void benchmarkOneApplicationChange();
+    void testCategorizedApplicationChange();
+    void benchmarkRefreshIncrementally();
+
+private:
+    // The menu as AppsModel sorted it, with the application not installed yet at @p installed
+    QList<AbstractEntry *> menu(int installed) const;
+    // Writes the installed application @p i, in the Development and Utility categories every tenth time
+    void writeInstalledApplication(int i, const QString &icon);
+    // Lets KSycoca pick up the changed application, however soon after the last build
+    void rebuildDatabase(int i);
+    // The all applications model by first letter of a RootModel, and its group for @p letter
+    AbstractModel *letterModel(RootModel *rootModel, const QString &letter) const;
+
+    QTemporaryDir m_applicationsDir;
+    QList<AbstractEntry *> m_entries;
+};
+
+void AppsModelTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    QVERIFY(m_applicationsDir.isValid());
+
+    // One more than the menu holds, to be installed
+    for (int i = 0; i <= s_menuSize; ++i) {
+        const QString path = m_applicationsDir.filePath(QStringLiteral("application%1.desktop").arg(i));
+        {
+            KDesktopFile file(path);
+            KConfigGroup group = file.desktopGroup();
+            group.writeEntry("Type", "Application");
+            group.writeEntry("Name", QStringLiteral("Application %1").arg(i, 4, 10, QLatin1Char('0')));
+            group.writeEntry("Exec", QStringLiteral("application%1").arg(i));
+        }
+        m_entries << new AppEntry(nullptr, KService::Ptr(new KService(path)), AppEntry::NameOnly);
+    }
+
+    // The same menu installed, for the models reading KSycoca
+    const QString appsPath = QStandardPaths::writableLocation(QStandardPaths::ApplicationsLocation);
+    QDir(appsPath).removeRecursively();
+    QVERIFY(QDir().mkpath(appsPath));
+
+    const QString menusPath = QStandardPaths::writableLocation(QStandardPaths::GenericConfigLocation) + QLatin1String("/menus");
+    QVERIFY(QDir().mkpath(menusPath));
+    QFile menuFile(menusPath + QLatin1String("/applications.menu"));
+    QVERIFY(menuFile.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    menuFile.write(
+        "<!DOCTYPE Menu PUBLIC \"-//freedesktop//DTD Menu 1.0//EN\" \"http://www.freedesktop.org/standards/menu-spec/1.0/menu.dtd\">\n"
+        "<Menu>\n"
+        "  <Name>Applications</Name>\n"
+        "  <DefaultAppDirs/>\n"
+        "  <Menu><Name>Development</Name><Include><Category>Development</Category></Include></Menu>\n"
+        "  <Menu><Name>Utilities</Name><Include><Category>Utility</Category></Include></Menu>\n"
+        "</Menu>\n");
+    menuFile.close();
+    qunsetenv("XDG_MENU_PREFIX");
+
+    for (int i = 0; i < s_menuSize; ++i) {
+        writeInstalledApplication(i, QStringLiteral("application-x-executable"));
+    }
+
+    QFile::remove(KSycoca::absoluteFilePath());
+    KSycoca::self()->ensureCacheValid();
+}
+
+void AppsModelTest::cleanupTestCase()
+{
+    qDeleteAll(m_entries);
+}
+
+void AppsModelTest::writeInstalledApplication(int i, const QString &icon)
+{
+    const QString appsPath = QStandardPaths::writableLocation(QStandardPaths::ApplicationsLocation);
+    KDesktopFile file(appsPath + QStringLiteral("/installed%1.desktop").arg(i));
+    KConfigGroup group = file.desktopGroup();
+    group.writeEntry("Type", "Application");
+    group.writeEntry("Name", QStringLiteral("Installed %1").arg(i, 4, 10, QLatin1Char('0')));
+    group.writeEntry("Exec", QStringLiteral("installed%1").arg(i));
+    group.writeEntry("Icon", icon);
+    group.writeEntry("Categories", i % 10 == 0 ? "Development;Utility;" : (i % 2 ? "Utility;" : "Development;"));
+}
+
+void AppsModelTest::rebuildDatabase(int i)
+{
+    const QString path = QStandardPaths::writableLocation(QStandardPaths::ApplicationsLocation) + QStringLiteral("/installed%1.desktop").arg(i);
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.setFileTime(QDateTime::currentDateTime().addSecs(2), QFileDevice::FileModificationTime));
+    file.close();
+
+    KSycoca::self()->ensureCacheValid();
+}
+
+AbstractModel *AppsModelTest::letterModel(RootModel *rootModel, const QString &letter) const
+{
+    AbstractModel *allModel = rootModel->modelForRow(0);
+    if (!allModel) {
+        return nullptr;
+    }
+
+    for (int i = 0; i < allModel->count(); ++i) {
+        if (allModel->labelForRow(i) == letter) {
+            return allModel->modelForRow(i);
+        }
+    }
+
+    return nullptr;
+}
+
+QList<AbstractEntry *> AppsModelTest::menu(int installed) const
+{
+    QList<AbstractEntry *> ret = m_entries.mid(0, s_menuSize);
+    if (installed >= 0) {
+        ret.insert(installed, m_entries.at(s_menuSize));
+    }
+    return ret;
+}
+
+void AppsModelTest::testOneApplicationChange()
+{
+    AppsModel model(menu(-1), false);
+    QCOMPARE(model.count(), s_menuSize);
+
+    QSignalSpy resetSpy(&model, &QAbstractItemModel::modelReset);
+    QSignalSpy insertSpy(&model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy removeSpy(&model, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy changeSpy(&model, &QAbstractItemModel::dataChanged);
+
+    // An application gets installed while another one changes its icon
+    const QList<AbstractEntry *> after = menu(1000);
+    model.applyEntryList(after, {after.at(10)});
+
+    QCOMPARE(model.count(), s_menuSize + 1);
+    QCOMPARE(resetSpy.count(), 0);
+    QCOMPARE(removeSpy.count(), 0);
+    QCOMPARE(insertSpy.count(), 1);
+    QCOMPARE(insertSpy.first().at(1).toInt(), 1000);
+    QCOMPARE(insertSpy.first().at(2).toInt(), 1000);
+    QCOMPARE(changeSpy.count(), 1);
+    QCOMPARE(changeSpy.first().at(0).toModelIndex().row(), 10);
+
+    // And is removed again
+    model.applyEntryList(menu(-1), {});
+    QCOMPARE(model.count(), s_menuSize);
+    QCOMPARE(resetSpy.count(), 0);
+    QCOMPARE(removeSpy.count(), 1);
+    QCOMPARE(removeSpy.first().at(1).toInt(), 1000);
+}
+
+void AppsModelTest::benchmarkOneApplicationChange()
+{
+    // Installing an application and removing it again, on a 2,000 entry menu
+    const QList<AbstractEntry *> before = menu(-1);
+    const QList<AbstractEntry *> after = menu(1000);
+    AppsModel model(before, false);
+
+    QBENCHMARK {
+        model.applyEntryList(after, {});
+        model.applyEntryList(before, {});
+    }
+
+    QCOMPARE(model.count(), s_menuSize);
+}
+
+void AppsModelTest::testCategorizedApplicationChange()
+{
+    RootModel rootModel;
+    rootModel.setShowAllApps(true);
+    rootModel.setShowAllAppsCategorized(true);
+    rootModel.setShowRecentApps(false);
+    rootModel.setShowRecentDocs(false);
+    rootModel.setShowPowerSession(false);
+    rootModel.componentComplete();
+
+    // Every tenth application is in both categories, but listed only once
+    AbstractModel *model = letterModel(&rootModel, QStringLiteral("I"));
+    QVERIFY(model);
+    QCOMPARE(model->count(), s_menuSize);
+
+    QSignalSpy resetSpy(model, &QAbstractItemModel::modelReset);
+    QSignalSpy insertSpy(model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy removeSpy(model, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy changeSpy(model, &QAbstractItemModel::dataChanged);
+
+    // One of these changes its icon
+    writeInstalledApplication(10, QStringLiteral("utilities-terminal"));
+    rebuildDatabase(10);
+
+    QTRY_COMPARE(changeSpy.count(), 1);
+    QCOMPARE(changeSpy.first().at(0).toModelIndex().row(), 10);
+    QCOMPARE(letterModel(&rootModel, QStringLiteral("I")), model);
+    QCOMPARE(model->count(), s_menuSize);
+    QCOMPARE(resetSpy.count(), 0);
+    QCOMPARE(insertSpy.count(), 0);
+    QCOMPARE(removeSpy.count(), 0);
+
+    writeInstalledApplication(10, QStringLiteral("application-x-executable"));
+    rebuildDatabase(10);
+    QTRY_COMPARE(changeSpy.count(), 2);
+    QCOMPARE(model->count(), s_menuSize);
+}
+
+void AppsModelTest::benchmarkRefreshIncrementally()
+{
+    // The refresh after one application of the installed 2,000 entry menu changed,
+    // with all applications shown by first letter as well
+    RootModel rootModel;
+    rootModel.setShowAllApps(true);
+    rootModel.setShowAllAppsCategorized(true);
+    rootModel.setShowRecentApps(false);
+    rootModel.setShowRecentDocs(false);
+    rootModel.setShowPowerSession(false);
+    rootModel.componentComplete();
+
+    AbstractModel *model = letterModel(&rootModel, QStringLiteral("I"));
+    QVERIFY(model);
+    QSignalSpy changeSpy(model, &QAbstractItemModel::dataChanged);
+
+    writeInstalledApplication(20, QStringLiteral("utilities-terminal"));
+    rebuildDatabase(20);
+
+    // Applied right away, before the timer started on KSycoca::databaseChanged
+    QBENCHMARK_ONCE {
+        QMetaObject::invokeMethod(&rootModel, "refreshIncrementally");
+    }
+
+    QCOMPARE(changeSpy.count(), 1);
+    QCOMPARE(model->count(), s_menuSize);
+}
+
+QTEST_MAIN(AppsModelTest)
+
+#include "appsmodeltest.moc"
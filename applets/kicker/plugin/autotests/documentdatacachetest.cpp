@@ -0,0 +1,109 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QSignalSpy>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <KFilePlacesModel>
+
+#include "documentdatacache.h"
+
+class DocumentDataCacheTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void testConstantWorkPerRow();
+    void testPlaces();
+    void testInvalidate();
+
+private:
+    QUrl fileUrl(const QString &fileName) const;
+
+    QTemporaryDir m_dir;
+};
+
+void DocumentDataCacheTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    QVERIFY(m_dir.isValid());
+}
+
+QUrl DocumentDataCacheTest::fileUrl(const QString &fileName) const
+{
+    return QUrl::fromLocalFile(m_dir.filePath(fileName));
+}
+
+void DocumentDataCacheTest::testConstantWorkPerRow()
+{
+    KFilePlacesModel places;
+    DocumentDataCache cache(&places);
+
+    // A view repainting 15 rows of recent files over and over again
+    for (int repaint = 0; repaint < 100; ++repaint) {
+        for (int row = 0; row < 15; ++row) {
+            const DocumentDataCache::Data data = cache.data(fileUrl(QStringLiteral("document%1.txt").arg(row)));
+            QCOMPARE(data.text, QStringLiteral("document%1.txt").arg(row));
+        }
+    }
+
+    // Only the first repaint resolved the files against the places
+    QCOMPARE(cache.resolveCount(), 15);
+}
+
+void DocumentDataCacheTest::testPlaces()
+{
+    KFilePlacesModel places;
+    DocumentDataCache cache(&places);
+    QSignalSpy invalidatedSpy(&cache, &DocumentDataCache::invalidated);
+
+    const QUrl placeUrl = QUrl::fromLocalFile(m_dir.path());
+    const QUrl documentUrl = fileUrl(QStringLiteral("folder/document.txt"));
+
+    QVERIFY(!cache.data(documentUrl).description.startsWith(QLatin1String("Test Place")));
+
+    // Adding a place changes the description of the files in it
+    places.addPlace(QStringLiteral("Test Place"), placeUrl, QStringLiteral("folder-favorites"));
+    QCOMPARE(invalidatedSpy.count(), 1);
+    QCOMPARE(cache.data(documentUrl).description, QStringLiteral("Test Place/folder"));
+
+    const DocumentDataCache::Data placeData = cache.data(placeUrl);
+    QCOMPARE(placeData.text, QStringLiteral("Test Place"));
+    QVERIFY(placeData.description.isEmpty());
+
+    places.removePlace(places.closestItem(placeUrl));
+    QCOMPARE(invalidatedSpy.count(), 2);
+    QVERIFY(!cache.data(documentUrl).description.startsWith(QLatin1String("Test Place")));
+}
+
+void DocumentDataCacheTest::testInvalidate()
+{
+    KFilePlacesModel places;
+    DocumentDataCache cache(&places);
+
+    const QUrl url = fileUrl(QStringLiteral("document.txt"));
+    cache.data(url);
+    cache.data(url);
+    QCOMPARE(cache.resolveCount(), 1);
+
+    // Changed resources are resolved again, the others stay cached
+    cache.invalidate(url);
+    cache.data(url);
+    cache.data(fileUrl(QStringLiteral("other.txt")));
+    cache.data(fileUrl(QStringLiteral("other.txt")));
+    QCOMPARE(cache.resolveCount(), 3);
+
+    cache.clear();
+    cache.data(url);
+    QCOMPARE(cache.resolveCount(), 4);
+}
+
+QTEST_MAIN(DocumentDataCacheTest)
+
+#include "documentdatacachetest.moc"
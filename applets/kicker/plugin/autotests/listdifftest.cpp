@@ -0,0 +1,199 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QAbstractItemModelTester>
+#include <QAbstractListModel>
+#include <QSignalSpy>
+#include <QTest>
+
+#include "listdiff.h"
+
+struct Entry {
+    QString name;
+};
+
+class EntryListModel : public QAbstractListModel
+{
+public:
+    explicit EntryListModel(const QList<const Entry *> &entries)
+        : m_entries(entries)
+    {
+    }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override
+    {
+        return parent.isValid() ? 0 : m_entries.count();
+    }
+
+    QVariant data(const QModelIndex &index, int role) const override
+    {
+        if (!checkIndex(index, CheckIndexOption::IndexIsValid) || role != Qt::DisplayRole) {
+            return QVariant();
+        }
+        return m_entries.at(index.row())->name;
+    }
+
+    QList<const Entry *> entries() const
+    {
+        return m_entries;
+    }
+
+    QList<const Entry *> update(const QList<const Entry *> &entries)
+    {
+        return Kicker::updateRows(this, m_entries, entries);
+    }
+
+private:
+    template<typename T, typename Model, typename KeyFunction>
+    friend QList<T> Kicker::updateRows(Model *model, QList<T> &current, const QList<T> &target, KeyFunction key);
+
+    QList<const Entry *> m_entries;
+};
+
+class ListDiffTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void testUpdateRows_data();
+    void testUpdateRows();
+    void testOneApplicationChange();
+    void benchmarkOneApplicationChange();
+
+private:
+    QList<const Entry *> entries(const QString &letters) const;
+
+    // The menu used by the benchmark, sorted by name like AppsModel sorts it
+    QList<const Entry *> menu(int size, int installed, int removed, int renamed) const;
+
+    std::vector<Entry> m_entries;
+};
+
+void ListDiffTest::initTestCase()
+{
+    // One entry per letter, plus enough applications for a big menu
+    for (char letter = 'a'; letter <= 'z'; ++letter) {
+        m_entries.push_back({QString(QLatin1Char(letter))});
+    }
+    for (int i = 0; i <= 2000; ++i) {
+        m_entries.push_back({QStringLiteral("Application %1").arg(i, 4, 10, QLatin1Char('0'))});
+    }
+}
+
+QList<const Entry *> ListDiffTest::entries(const QString &letters) const
+{
+    QList<const Entry *> ret;
+    for (const QChar &letter : letters) {
+        ret << &m_entries.at(letter.unicode() - 'a');
+    }
+    return ret;
+}
+
+QList<const Entry *> ListDiffTest::menu(int size, int installed, int removed, int renamed) const
+{
+    QList<const Entry *> ret;
+    for (int i = 0; i < size; ++i) {
+        if (i != removed && i != renamed) {
+            ret << &m_entries.at(26 + i);
+        }
+    }
+    if (installed >= 0) {
+        ret.insert(installed, &m_entries.at(26 + size));
+    }
+    if (renamed >= 0) {
+        // Renamed to sort last
+        ret << &m_entries.at(26 + renamed);
+    }
+    return ret;
+}
+
+void ListDiffTest::testUpdateRows_data()
+{
+    QTest::addColumn<QString>("before");
+    QTest::addColumn<QString>("after");
+    QTest::addColumn<QString>("removed");
+
+    QTest::newRow("unchanged") << "abcd" << "abcd" << "";
+    QTest::newRow("from nothing") << "" << "abc" << "";
+    QTest::newRow("to nothing") << "abc" << "" << "abc";
+    QTest::newRow("insert in between") << "abcd" << "abxycd" << "";
+    QTest::newRow("append") << "abcd" << "abcdx" << "";
+    QTest::newRow("remove in between") << "abcdef" << "abef" << "cd";
+    QTest::newRow("remove separate rows") << "abcdef" << "bdf" << "ace";
+    QTest::newRow("move down") << "abcdef" << "bcdeaf" << "";
+    QTest::newRow("move up") << "abcdef" << "aebcdf" << "";
+    QTest::newRow("swap") << "abcd" << "dbca" << "";
+    QTest::newRow("reverse") << "abcdef" << "fedcba" << "";
+    QTest::newRow("everything") << "abcdefgh" << "xgbhyzfd" << "ace";
+    QTest::newRow("replace all") << "abc" << "xyz" << "abc";
+}
+
+void ListDiffTest::testUpdateRows()
+{
+    QFETCH(QString, before);
+    QFETCH(QString, after);
+    QFETCH(QString, removed);
+
+    EntryListModel model(entries(before));
+    QAbstractItemModelTester tester(&model, QAbstractItemModelTester::FailureReportingMode::QtTest);
+    QSignalSpy resetSpy(&model, &QAbstractItemModel::modelReset);
+
+    // Rows which are kept have to keep their persistent indexes
+    QList<QPersistentModelIndex> persistentIndexes;
+    for (int row = 0; row < model.rowCount(); ++row) {
+        persistentIndexes << QPersistentModelIndex(model.index(row));
+    }
+
+    QCOMPARE(model.update(entries(after)), entries(removed));
+    QCOMPARE(model.entries(), entries(after));
+    QCOMPARE(resetSpy.count(), 0);
+
+    for (int i = 0; i < before.size(); ++i) {
+        const QPersistentModelIndex &index = persistentIndexes.at(i);
+        if (removed.contains(before.at(i))) {
+            QVERIFY(!index.isValid());
+        } else {
+            QCOMPARE(index.row(), after.indexOf(before.at(i)));
+        }
+    }
+}
+
+void ListDiffTest::testOneApplicationChange()
+{
+    EntryListModel model(menu(2000, -1, -1, -1));
+    QSignalSpy removeSpy(&model, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy moveSpy(&model, &QAbstractItemModel::rowsMoved);
+    QSignalSpy insertSpy(&model, &QAbstractItemModel::rowsInserted);
+
+    // An application gets installed, another one removed and a third one renamed
+    const QList<const Entry *> target = menu(2000, 500, 1000, 10);
+    QCOMPARE(model.update(target).count(), 1);
+    QCOMPARE(model.entries(), target);
+
+    QCOMPARE(removeSpy.count(), 1);
+    QCOMPARE(moveSpy.count(), 1);
+    QCOMPARE(insertSpy.count(), 1);
+}
+
+void ListDiffTest::benchmarkOneApplicationChange()
+{
+    // Installing an application and removing it again, on a 2,000 entry menu
+    const QList<const Entry *> before = menu(2000, -1, -1, -1);
+    const QList<const Entry *> after = menu(2000, 1000, -1, -1);
+    EntryListModel model(before);
+
+    QBENCHMARK {
+        model.update(after);
+        model.update(before);
+    }
+
+    QCOMPARE(model.entries(), before);
+}
+
+QTEST_GUILESS_MAIN(ListDiffTest)
+
+#include "listdifftest.moc"
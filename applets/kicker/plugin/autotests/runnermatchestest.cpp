@@ -0,0 +1,305 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QAbstractItemModelTester>
+#include <QJsonObject>
+#include <QSignalSpy>
+#include <QTest>
+
+#include <KPluginMetaData>
+#include <KRunner/AbstractRunner>
+#include <KRunner/QueryMatch>
+
+#include "runnermatchesmodel.h"
+#include "runnermodel.h"
+
+// Produces matches for every candidate containing the query, like most runners do
+class SyntheticRunner : public Plasma::AbstractRunner
+{
+public:
+    SyntheticRunner(const QString &id, const QStringList &candidates)
+        : Plasma::AbstractRunner(nullptr,
+                                 KPluginMetaData(QJsonObject{{QStringLiteral("KPlugin"), QJsonObject{{QStringLiteral("Id"), id}, {QStringLiteral("Name"), id}}}},
+                                                 QString()),
+                                 QVariantList())
+        , m_prefix(id + QLatin1Char('/'))
+        , m_candidates(candidates)
+    {
+    }
+
+    void match(Plasma::RunnerContext &context) override
+    {
+        Q_UNUSED(context)
+    }
+
+    // Asking again gives the same matches, like RunnerManager keeps reporting them
+    QList<Plasma::QueryMatch> matches(const QString &query)
+    {
+        auto it = m_matches.constFind(query);
+        if (it != m_matches.constEnd()) {
+            return *it;
+        }
+
+        QList<Plasma::QueryMatch> &ret = m_matches[query];
+        for (const QString &candidate : qAsConst(m_candidates)) {
+            const int position = candidate.indexOf(query, 0, Qt::CaseInsensitive);
+            if (position == -1) {
+                continue;
+            }
+
+            Plasma::QueryMatch match(this);
+            match.setId(m_prefix + candidate);
+            match.setText(candidate);
+            match.setRelevance(position == 0 ? 1 : 0.5);
+            ret << match;
+
+            if (ret.count() == 20) {
+                break;
+            }
+        }
+        return ret;
+    }
+
+private:
+    QString m_prefix;
+    QStringList m_candidates;
+    QHash<QString, QList<Plasma::QueryMatch>> m_matches;
+};
+
+class RunnerMatchesTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void testTypingSession();
+    void testDuplicateIds();
+    void testNewMatchesOnly();
+    void testMaxUpdateRate();
+    void benchmarkTypingSession();
+
+private:
+    // What RunnerManager reports once the first @p finished runners are done with @p query
+    QList<Plasma::QueryMatch> batch(const QString &query, int finished) const;
+    // The matches of the model in row @p row of @p model
+    static QList<Plasma::QueryMatch> matches(RunnerModel &model, int row);
+
+    QList<SyntheticRunner *> m_runners;
+    // Every batch RunnerManager would report for the recorded session, runners
+    // finish one after another and each batch holds all matches so far
+    QVector<QList<Plasma::QueryMatch>> m_batches;
+};
+
+void RunnerMatchesTest::initTestCase()
+{
+    const QStringList words{QStringLiteral("Firefox"),
+                            QStringLiteral("Fire"),
+                            QStringLiteral("Konsole"),
+                            QStringLiteral("Kate"),
+                            QStringLiteral("Kontact"),
+                            QStringLiteral("Files"),
+                            QStringLiteral("Fonts"),
+                            QStringLiteral("Finder"),
+                            QStringLiteral("Firewall"),
+                            QStringLiteral("Config"),
+                            QStringLiteral("Office"),
+                            QStringLiteral("Notes")};
+
+    for (const QString &runner : {QStringLiteral("services"), QStringLiteral("bookmarks"), QStringLiteral("baloosearch")}) {
+        QStringList candidates;
+        for (const QString &first : words) {
+            for (const QString &second : words) {
+                candidates << QStringLiteral("%1 %2 (%3)").arg(first, second, runner);
+            }
+        }
+        m_runners << new SyntheticRunner(runner, candidates);
+    }
+
+    // Typing "firefox", two backspaces, then starting over with "konsole"
+    const QStringList session{QStringLiteral("f"),
+                              QStringLiteral("fi"),
+                              QStringLiteral("fir"),
+                              QStringLiteral("fire"),
+                              QStringLiteral("firef"),
+                              QStringLiteral("firefo"),
+                              QStringLiteral("firefox"),
+                              QStringLiteral("firefo"),
+                              QStringLiteral("firef"),
+                              QStringLiteral("k"),
+                              QStringLiteral("ko"),
+                              QStringLiteral("kon"),
+                              QStringLiteral("kons"),
+                              QStringLiteral("konso"),
+                              QStringLiteral("konsol"),
+                              QStringLiteral("konsole")};
+
+    for (const QString &query : session) {
+        for (int finished = 1; finished <= m_runners.count(); ++finished) {
+            m_batches << batch(query, finished);
+        }
+    }
+}
+
+QList<Plasma::QueryMatch> RunnerMatchesTest::batch(const QString &query, int finished) const
+{
+    QList<Plasma::QueryMatch> ret;
+    for (int i = 0; i < finished; ++i) {
+        ret << m_runners.at(i)->matches(query);
+    }
+    return ret;
+}
+
+QList<Plasma::QueryMatch> RunnerMatchesTest::matches(RunnerModel &model, int row)
+{
+    auto *matchesModel = qobject_cast<RunnerMatchesModel *>(model.modelForRow(row));
+    return matchesModel ? matchesModel->matches() : QList<Plasma::QueryMatch>();
+}
+
+void RunnerMatchesTest::cleanupTestCase()
+{
+    m_batches.clear();
+    qDeleteAll(m_runners);
+}
+
+void RunnerMatchesTest::testTypingSession()
+{
+    RunnerMatchesModel model(QString(), QStringLiteral("Search results"), nullptr);
+    QAbstractItemModelTester tester(&model, QAbstractItemModelTester::FailureReportingMode::QtTest);
+    QSignalSpy resetSpy(&model, &QAbstractItemModel::modelReset);
+    int keptRows = 0;
+
+    for (const auto &batch : qAsConst(m_batches)) {
+        // Matches which stay keep their rows
+        QHash<QString, QPersistentModelIndex> rows;
+        for (int row = 0; row < model.rowCount(); ++row) {
+            rows.insert(model.matches().at(row).id(), QPersistentModelIndex(model.index(row, 0)));
+        }
+
+        model.setMatches(batch);
+
+        QCOMPARE(model.matches(), batch);
+        for (auto it = rows.cbegin(); it != rows.cend(); ++it) {
+            if (it->isValid()) {
+                QCOMPARE(model.matches().at(it->row()).id(), it.key());
+                ++keptRows;
+            }
+        }
+    }
+
+    QCOMPARE(resetSpy.count(), 0);
+    // Refining the query keeps most of the matches of the previous keystroke
+    QVERIFY(keptRows > 0);
+}
+
+void RunnerMatchesTest::testDuplicateIds()
+{
+    SyntheticRunner *runner = m_runners.first();
+    QList<Plasma::QueryMatch> matches;
+    for (const QString &text : {QStringLiteral("a"), QStringLiteral("b"), QStringLiteral("c")}) {
+        Plasma::QueryMatch match(runner);
+        match.setText(text);
+        matches << match;
+    }
+
+    RunnerMatchesModel model(QString(), QStringLiteral("Search results"), nullptr);
+    QAbstractItemModelTester tester(&model, QAbstractItemModelTester::FailureReportingMode::QtTest);
+    model.setMatches(matches);
+    QCOMPARE(model.matches(), matches);
+
+    matches.removeAt(1);
+    model.setMatches(matches);
+    QCOMPARE(model.matches(), matches);
+}
+
+void RunnerMatchesTest::testNewMatchesOnly()
+{
+    RunnerModel model;
+    model.setMaxUpdateRate(0);
+
+    QMetaObject::invokeMethod(&model, "matchesChanged", Q_ARG(QList<Plasma::QueryMatch>, batch(QStringLiteral("fire"), 1)));
+    QCOMPARE(model.count(), 1);
+
+    auto *servicesModel = qobject_cast<RunnerMatchesModel *>(model.modelForRow(0));
+    QVERIFY(servicesModel);
+    QCOMPARE(servicesModel->runnerId(), QStringLiteral("services"));
+    QSignalSpy insertSpy(servicesModel, &QAbstractItemModel::rowsInserted);
+    QSignalSpy removeSpy(servicesModel, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy moveSpy(servicesModel, &QAbstractItemModel::rowsMoved);
+    QSignalSpy changeSpy(servicesModel, &QAbstractItemModel::dataChanged);
+
+    // The other runners finishing leave the model of the first one alone
+    for (int finished = 2; finished <= m_runners.count(); ++finished) {
+        QMetaObject::invokeMethod(&model, "matchesChanged", Q_ARG(QList<Plasma::QueryMatch>, batch(QStringLiteral("fire"), finished)));
+        QCOMPARE(model.count(), finished);
+    }
+    QCOMPARE(insertSpy.count(), 0);
+    QCOMPARE(removeSpy.count(), 0);
+    QCOMPARE(moveSpy.count(), 0);
+    QCOMPARE(changeSpy.count(), 0);
+
+    for (int row = 0; row < model.count(); ++row) {
+        QList<Plasma::QueryMatch> expected = m_runners.at(row)->matches(QStringLiteral("fire"));
+        std::sort(expected.rbegin(), expected.rend());
+        QCOMPARE(matches(model, row), expected);
+    }
+
+    // A new query starts over
+    QMetaObject::invokeMethod(&model, "matchesChanged", Q_ARG(QList<Plasma::QueryMatch>, batch(QStringLiteral("kon"), 1)));
+    QVERIFY(insertSpy.count() > 0 || removeSpy.count() > 0);
+    QList<Plasma::QueryMatch> expected = m_runners.first()->matches(QStringLiteral("kon"));
+    std::sort(expected.rbegin(), expected.rend());
+    QCOMPARE(servicesModel->matches(), expected);
+    QVERIFY(matches(model, 1).isEmpty());
+}
+
+void RunnerMatchesTest::testMaxUpdateRate()
+{
+    RunnerModel model;
+    model.setMaxUpdateRate(10);
+    QSignalSpy insertSpy(&model, &QAbstractItemModel::rowsInserted);
+
+    // The first batch is applied right away
+    QMetaObject::invokeMethod(&model, "matchesChanged", Q_ARG(QList<Plasma::QueryMatch>, batch(QStringLiteral("fire"), 1)));
+    QCOMPARE(model.count(), 1);
+    QCOMPARE(insertSpy.count(), 1);
+
+    // Those arriving within the next 100ms are collapsed into the latest one
+    QMetaObject::invokeMethod(&model, "matchesChanged", Q_ARG(QList<Plasma::QueryMatch>, batch(QStringLiteral("fire"), 2)));
+    QMetaObject::invokeMethod(&model, "matchesChanged", Q_ARG(QList<Plasma::QueryMatch>, batch(QStringLiteral("fire"), 3)));
+    QCOMPARE(model.count(), 1);
+
+    QTRY_COMPARE(model.count(), 3);
+    QCOMPARE(insertSpy.count(), 2);
+
+    // Turning the limit off applies pending and later batches right away
+    QMetaObject::invokeMethod(&model, "matchesChanged", Q_ARG(QList<Plasma::QueryMatch>, batch(QStringLiteral("kon"), 1)));
+    model.setMaxUpdateRate(0);
+    QList<Plasma::QueryMatch> expected = m_runners.first()->matches(QStringLiteral("kon"));
+    std::sort(expected.rbegin(), expected.rend());
+    QCOMPARE(matches(model, 0), expected);
+
+    QMetaObject::invokeMethod(&model, "matchesChanged", Q_ARG(QList<Plasma::QueryMatch>, batch(QStringLiteral("fire"), 1)));
+    expected = m_runners.first()->matches(QStringLiteral("fire"));
+    std::sort(expected.rbegin(), expected.rend());
+    QCOMPARE(matches(model, 0), expected);
+}
+
+void RunnerMatchesTest::benchmarkTypingSession()
+{
+    RunnerMatchesModel model(QString(), QStringLiteral("Search results"), nullptr);
+
+    QBENCHMARK {
+        for (const auto &batch : qAsConst(m_batches)) {
+            model.setMatches(batch);
+        }
+        model.setMatches({});
+    }
+}
+
+QTEST_GUILESS_MAIN(RunnerMatchesTest)
+
+#include "runnermatchestest.moc"
@@ -0,0 +1,100 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "documentdatacache.h"
+
+#include <KFileItem>
+#include <KFilePlacesModel>
+
+DocumentDataCache::DocumentDataCache(KFilePlacesModel *placesModel, QObject *parent)
+    : QObject(parent)
+    , m_placesModel(placesModel)
+    , m_resolveCount(0)
+{
+    connect(m_placesModel, &QAbstractItemModel::rowsInserted, this, &DocumentDataCache::placesChanged);
+    connect(m_placesModel, &QAbstractItemModel::rowsRemoved, this, &DocumentDataCache::placesChanged);
+    connect(m_placesModel, &QAbstractItemModel::rowsMoved, this, &DocumentDataCache::placesChanged);
+    connect(m_placesModel, &QAbstractItemModel::dataChanged, this, &DocumentDataCache::placesChanged);
+    connect(m_placesModel, &QAbstractItemModel::layoutChanged, this, &DocumentDataCache::placesChanged);
+    connect(m_placesModel, &QAbstractItemModel::modelReset, this, &DocumentDataCache::placesChanged);
+}
+
+DocumentDataCache::~DocumentDataCache()
+{
+}
+
+DocumentDataCache::Data DocumentDataCache::data(const QUrl &url)
+{
+    auto it = m_data.constFind(url);
+
+    if (it == m_data.constEnd()) {
+        it = m_data.insert(url, resolve(url));
+        ++m_resolveCount;
+    }
+
+    return *it;
+}
+
+void DocumentDataCache::invalidate(const QUrl &url)
+{
+    m_data.remove(url);
+}
+
+void DocumentDataCache::clear()
+{
+    m_data.clear();
+}
+
+int DocumentDataCache::resolveCount() const
+{
+    return m_resolveCount;
+}
+
+void DocumentDataCache::placesChanged()
+{
+    if (m_data.isEmpty()) {
+        return;
+    }
+
+    m_data.clear();
+
+    Q_EMIT invalidated();
+}
+
+DocumentDataCache::Data DocumentDataCache::resolve(const QUrl &url) const
+{
+    // Avoid calling QT_LSTAT and accessing recent documents
+    const KFileItem fileItem(url, KFileItem::SkipMimeTypeFromContent);
+
+    Data data;
+    data.text = fileItem.text();
+    data.icon = QIcon::fromTheme(fileItem.iconName(), QIcon::fromTheme(QStringLiteral("unknown")));
+    data.description = fileItem.localPath();
+
+    const auto index = m_placesModel->closestItem(fileItem.url());
+
+    if (index.isValid()) {
+        // the current file has a parent in placesModel
+        const auto parentUrl = m_placesModel->url(index);
+
+        if (parentUrl == fileItem.url()) {
+            // if the current item is a place
+            data.text = m_placesModel->text(index);
+            data.icon = m_placesModel->icon(index);
+            data.description.clear();
+
+            return data;
+        }
+
+        data.description.truncate(data.description.lastIndexOf(QLatin1Char('/')));
+        data.description.replace(0, parentUrl.path().length(), m_placesModel->text(index));
+    } else {
+        // remove filename
+        data.description.truncate(data.description.lastIndexOf(QLatin1Char('/')));
+    }
+
+    return data;
+}
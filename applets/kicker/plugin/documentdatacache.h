@@ -0,0 +1,63 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QHash>
+#include <QIcon>
+#include <QObject>
+#include <QUrl>
+
+class KFilePlacesModel;
+
+/**
+ * Display data of recently used files, resolved against the places once per file.
+ *
+ * Finding the closest place of a file walks every bookmark and device of the places
+ * model, looking up the icon needs the MIME type. Models ask for this data on every
+ * repaint of every visible row, so it is kept per url until the places or the file's
+ * resource change.
+ */
+class DocumentDataCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Data {
+        // The place's name if the file is a place, the file name otherwise
+        QString text;
+        QIcon icon;
+        // The folder the file is in, starting with the name of the place it is in
+        QString description;
+    };
+
+    explicit DocumentDataCache(KFilePlacesModel *placesModel, QObject *parent = nullptr);
+    ~DocumentDataCache() override;
+
+    Data data(const QUrl &url);
+
+    void invalidate(const QUrl &url);
+    void clear();
+
+    /**
+     * How many urls were resolved against the places so far
+     */
+    int resolveCount() const;
+
+Q_SIGNALS:
+    /**
+     * Emitted when the places changed, all data needs to be fetched again
+     */
+    void invalidated() const;
+
+private:
+    void placesChanged();
+    Data resolve(const QUrl &url) const;
+
+    KFilePlacesModel *m_placesModel;
+    QHash<QUrl, Data> m_data;
+    int m_resolveCount;
+};
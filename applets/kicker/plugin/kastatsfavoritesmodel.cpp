@@ -11,6 +11,7 @@
 #include "contactentry.h"
 #include "debug.h"
 #include "fileentry.h"
+#include "kastatsquerypool.h"
 
 #include <QFileInfo>
 #include <QSortFilterProxyModel>
@@ -171,15 +172,15 @@ public:
         : q(parent)
         , m_query(LinkedResources | Agent{AGENT_APPLICATIONS, AGENT_CONTACTS, AGENT_DOCUMENTS} | Type::any() | Activity::current() | Activity::global()
                   | Limit::all())
-        , m_watcher(m_query)
+        , m_watcher(KAStatsQueryPool::self()->resultWatcher(m_query))
         , m_clientId(clientId)
     {
-        // Connecting the watcher
-        connect(&m_watcher, &ResultWatcher::resultLinked, [this](const QString &resource) {
+        // Connecting the watcher, which is shared with the other favorites models
+        connect(m_watcher.get(), &ResultWatcher::resultLinked, this, [this](const QString &resource) {
             addResult(resource, -1);
         });
 
-        connect(&m_watcher, &ResultWatcher::resultUnlinked, [this](const QString &resource) {
+        connect(m_watcher.get(), &ResultWatcher::resultUnlinked, this, [this](const QString &resource) {
             removeResult(resource);
         });
 
@@ -201,11 +202,12 @@ public:
 
         // Loading the results without emitting any model signals
         qCDebug(KICKER_DEBUG) << "Query is" << m_query;
-        ResultSet results(m_query);
+        // The other favorites models ran the same query already
+        const QStringList resources = KAStatsQueryPool::self()->resources(m_query);
 
-        for (const auto &result : results) {
-            qCDebug(KICKER_DEBUG) << "Got " << result.resource() << " -->";
-            addResult(result.resource(), -1, false);
+        for (const QString &resource : resources) {
+            qCDebug(KICKER_DEBUG) << "Got " << resource << " -->";
+            addResult(resource, -1, false);
         }
 
         // Normalizing all the ids
@@ -421,7 +423,7 @@ public:
     KAStatsFavoritesModel *const q;
     KActivities::Consumer m_activities;
     Query m_query;
-    ResultWatcher m_watcher;
+    std::shared_ptr<ResultWatcher> m_watcher;
     QString m_clientId;
 
     QVector<NormalizedId> m_items;
@@ -581,7 +583,7 @@ void KAStatsFavoritesModel::addFavoriteTo(const QString &id, const Activity &act
     if (url.isEmpty())
         return;
 
-    d->m_watcher.linkToActivity(QUrl(url), activity, Agent(agentForUrl(url)));
+    d->m_watcher->linkToActivity(QUrl(url), activity, Agent(agentForUrl(url)));
 }
 
 void KAStatsFavoritesModel::removeFavoriteFrom(const QString &id, const Activity &activity)
@@ -598,7 +600,7 @@ void KAStatsFavoritesModel::removeFavoriteFrom(const QString &id, const Activity
     if (url.isEmpty())
         return;
 
-    d->m_watcher.unlinkFromActivity(QUrl(url), activity, Agent(agentForUrl(url)));
+    d->m_watcher->unlinkFromActivity(QUrl(url), activity, Agent(agentForUrl(url)));
 }
 
 void KAStatsFavoritesModel::setFavoriteOn(const QString &id, const QString &activityId)
@@ -616,8 +618,8 @@ void KAStatsFavoritesModel::setFavoriteOn(const QString &id, const QString &acti
         d->m_ignoredItems << url;
     }
 
-    d->m_watcher.unlinkFromActivity(QUrl(url), Activity::any(), Agent(agentForUrl(url)));
-    d->m_watcher.linkToActivity(QUrl(url), activityId, Agent(agentForUrl(url)));
+    d->m_watcher->unlinkFromActivity(QUrl(url), Activity::any(), Agent(agentForUrl(url)));
+    d->m_watcher->linkToActivity(QUrl(url), activityId, Agent(agentForUrl(url)));
 }
 
 void KAStatsFavoritesModel::moveRow(int from, int to)
@@ -0,0 +1,131 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "kastatsquerypool.h"
+
+#include <QDate>
+
+#include <KActivities/Consumer>
+#include <KActivities/Stats/Query>
+#include <KActivities/Stats/ResultModel>
+#include <KActivities/Stats/ResultSet>
+#include <KActivities/Stats/ResultWatcher>
+
+using namespace KActivities::Stats;
+
+KAStatsQueryPool *KAStatsQueryPool::self()
+{
+    // Never destroyed: models and watchers still held at exit call back into the pool
+    static KAStatsQueryPool *pool = new KAStatsQueryPool;
+    return pool;
+}
+
+KAStatsQueryPool::KAStatsQueryPool()
+    : m_activities(new KActivities::Consumer)
+{
+}
+
+QString KAStatsQueryPool::currentActivity(const Query &query) const
+{
+    return query.activities().contains(QStringLiteral(":current")) ? m_activities->currentActivity() : QString();
+}
+
+QString KAStatsQueryPool::key(const Query &query)
+{
+    const QLatin1Char separator('\x1f');
+
+    return QString::number(query.selection()) + separator + query.types().join(QLatin1Char(',')) + separator + query.agents().join(QLatin1Char(','))
+        + separator + query.activities().join(QLatin1Char(',')) + separator + query.urlFilters().join(QLatin1Char(',')) + separator
+        + QString::number(query.ordering()) + separator + QString::number(query.offset()) + separator + QString::number(query.limit()) + separator
+        + query.dateStart().toString(Qt::ISODate) + separator + query.dateEnd().toString(Qt::ISODate);
+}
+
+std::shared_ptr<ResultModel> KAStatsQueryPool::resultModel(const Query &query)
+{
+    const QString queryKey = key(query);
+
+    if (auto model = m_resultModels.value(queryKey).lock()) {
+        return model;
+    }
+
+    // Users might drop the model from within one of its signals
+    std::shared_ptr<ResultModel> model(new ResultModel(query), [this, queryKey](ResultModel *model) {
+        m_resultModels.remove(queryKey);
+        model->deleteLater();
+    });
+
+    if (model->canFetchMore(QModelIndex())) {
+        model->fetchMore(QModelIndex());
+    }
+
+    m_resultModels.insert(queryKey, model);
+
+    return model;
+}
+
+std::shared_ptr<ResultWatcher> KAStatsQueryPool::resultWatcher(const Query &query)
+{
+    const QString queryKey = key(query);
+
+    if (auto watcher = m_resultWatchers.value(queryKey).lock()) {
+        return watcher;
+    }
+
+    std::shared_ptr<ResultWatcher> watcher(new ResultWatcher(query), [this, queryKey](ResultWatcher *watcher) {
+        m_resultWatchers.remove(queryKey);
+        m_resources.remove(queryKey);
+        watcher->deleteLater();
+    });
+
+    // Keeps the snapshot of resources() up to date, if someone asked for one
+    QObject::connect(watcher.get(), &ResultWatcher::resultLinked, watcher.get(), [this, queryKey](const QString &resource) {
+        auto it = m_resources.find(queryKey);
+        if (it != m_resources.end() && !it->resources.contains(resource)) {
+            it->resources.append(resource);
+        }
+    });
+    QObject::connect(watcher.get(), &ResultWatcher::resultUnlinked, watcher.get(), [this, queryKey](const QString &resource) {
+        auto it = m_resources.find(queryKey);
+        if (it != m_resources.end()) {
+            it->resources.removeAll(resource);
+        }
+    });
+    QObject::connect(watcher.get(), &ResultWatcher::resultsInvalidated, watcher.get(), [this, queryKey]() {
+        m_resources.remove(queryKey);
+    });
+
+    m_resultWatchers.insert(queryKey, watcher);
+
+    return watcher;
+}
+
+QStringList KAStatsQueryPool::resources(const Query &query)
+{
+    const QString queryKey = key(query);
+    const QString activity = currentActivity(query);
+
+    // The watcher of a query for the current activity outlives switching activities
+    auto it = m_resources.constFind(queryKey);
+    if (it != m_resources.constEnd() && it->activity == activity) {
+        return it->resources;
+    }
+
+    QStringList resources;
+    const ResultSet results(query);
+    for (const auto &result : results) {
+        resources << result.resource();
+    }
+
+    // Without a watcher nobody would tell us when the snapshot gets outdated
+    const std::shared_ptr<ResultWatcher> watcher = m_resultWatchers.value(queryKey).lock();
+    if (!watcher) {
+        return resources;
+    }
+
+    m_resources.insert(queryKey, Snapshot{activity, resources});
+
+    return resources;
+}
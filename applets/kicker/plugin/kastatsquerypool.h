@@ -0,0 +1,78 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+#include <memory>
+
+namespace KActivities
+{
+class Consumer;
+
+namespace Stats
+{
+class Query;
+class ResultModel;
+class ResultWatcher;
+}
+}
+
+/**
+ * Process-wide pool of activity stats queries.
+ *
+ * Every Kicker, Kickoff and Dashboard instance asks for the same recent and favorite
+ * resources. Asking the pool instead of creating models and watchers directly makes
+ * all of them share one model, respectively one watcher, per query definition, so the
+ * query runs and each resource event is processed once per process instead of once
+ * per applet. A model or watcher lives as long as someone holds on to it.
+ *
+ * Only to be used from the main thread.
+ */
+class KAStatsQueryPool
+{
+public:
+    static KAStatsQueryPool *self();
+
+    /**
+     * @returns the model for @p query, with its first batch of results fetched
+     */
+    std::shared_ptr<KActivities::Stats::ResultModel> resultModel(const KActivities::Stats::Query &query);
+    std::shared_ptr<KActivities::Stats::ResultWatcher> resultWatcher(const KActivities::Stats::Query &query);
+
+    /**
+     * @returns the resources @p query yields, in its order
+     *
+     * While someone holds the watcher for @p query, the result set is only run once and
+     * the watcher keeps the snapshot up to date for everyone else asking. A snapshot of a
+     * query for the current activity only holds until another activity becomes current.
+     */
+    QStringList resources(const KActivities::Stats::Query &query);
+
+    /**
+     * Queries with equal keys have the same definition
+     */
+    static QString key(const KActivities::Stats::Query &query);
+
+private:
+    KAStatsQueryPool();
+
+    // The activity :current stands for in @p query right now, empty if it does not use it
+    QString currentActivity(const KActivities::Stats::Query &query) const;
+
+    struct Snapshot {
+        QString activity;
+        QStringList resources;
+    };
+
+    KActivities::Consumer *m_activities;
+    QHash<QString, std::weak_ptr<KActivities::Stats::ResultModel>> m_resultModels;
+    QHash<QString, std::weak_ptr<KActivities::Stats::ResultWatcher>> m_resultWatchers;
+    QHash<QString, Snapshot> m_resources;
+};
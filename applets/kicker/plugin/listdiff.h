@@ -0,0 +1,150 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QModelIndex>
+#include <QPair>
+#include <QSet>
+
+#include <type_traits>
+
+namespace Kicker
+{
+/**
+ * Turns @p current, the rows of the flat list model @p model, into @p target.
+ *
+ * Items are identified by what @p key returns for them; items with the same key
+ * are told apart by their order. Rows which are gone are removed, rows which changed
+ * place are moved and new rows are inserted, each step wrapped into the matching
+ * begin/end calls of @p model, so that attached views only update the affected rows
+ * instead of going through a model reset. Moving a single item, e.g. a renamed
+ * application, results in a single row move. Kept rows whose item is not equal to
+ * the new one take it over and get dataChanged.
+ *
+ * @p model needs to befriend this function to give it access to the protected
+ * QAbstractItemModel row change functions.
+ *
+ * @returns the items of @p current which are not part of @p target
+ */
+template<typename T, typename Model, typename KeyFunction>
+QList<T> updateRows(Model *model, QList<T> &current, const QList<T> &target, KeyFunction key)
+{
+    using Key = QPair<std::decay_t<decltype(key(target.first()))>, int>;
+
+    const auto keysOf = [&key](const QList<T> &items) {
+        QList<Key> keys;
+        keys.reserve(items.count());
+        QHash<typename Key::first_type, int> occurrences;
+        for (const T &item : items) {
+            const auto itemKey = key(item);
+            keys << Key(itemKey, occurrences[itemKey]++);
+        }
+        return keys;
+    };
+
+    QList<Key> currentKeys = keysOf(current);
+    const QList<Key> targetKeys = keysOf(target);
+    const QSet<Key> targetKeySet(targetKeys.cbegin(), targetKeys.cend());
+    QList<T> removed;
+
+    // Remove from the back so that the rows in front keep their numbers
+    for (int row = current.count() - 1; row >= 0; --row) {
+        if (targetKeySet.contains(currentKeys.at(row))) {
+            continue;
+        }
+
+        const int last = row;
+
+        while (row > 0 && !targetKeySet.contains(currentKeys.at(row - 1))) {
+            --row;
+        }
+
+        model->beginRemoveRows(QModelIndex(), row, last);
+        removed = current.mid(row, last - row + 1) + removed;
+        current.erase(current.begin() + row, current.begin() + last + 1);
+        currentKeys.erase(currentKeys.begin() + row, currentKeys.begin() + last + 1);
+        model->endRemoveRows();
+    }
+
+    // What is left are the kept items, possibly in a different order
+    const QSet<Key> keptKeys(currentKeys.cbegin(), currentKeys.cend());
+
+    for (int row = 0; row < target.count();) {
+        if (row < current.count() && currentKeys.at(row) == targetKeys.at(row)) {
+            ++row;
+            continue;
+        }
+
+        if (keptKeys.contains(targetKeys.at(row))) {
+            if (row + 1 < current.count() && currentKeys.at(row + 1) == targetKeys.at(row)) {
+                // The item in this row went further down, move it towards its new place
+                const int to = qMin<int>(targetKeys.indexOf(currentKeys.at(row), row + 1), current.count() - 1);
+                model->beginMoveRows(QModelIndex(), row, row, QModelIndex(), to + 1);
+                current.move(row, to);
+                currentKeys.move(row, to);
+                model->endMoveRows();
+            } else {
+                const int from = currentKeys.indexOf(targetKeys.at(row), row + 1);
+                model->beginMoveRows(QModelIndex(), from, from, QModelIndex(), row);
+                current.move(from, row);
+                currentKeys.move(from, row);
+                model->endMoveRows();
+                ++row;
+            }
+
+            continue;
+        }
+
+        int last = row;
+
+        while (last + 1 < target.count() && !keptKeys.contains(targetKeys.at(last + 1))) {
+            ++last;
+        }
+
+        model->beginInsertRows(QModelIndex(), row, last);
+        for (int i = row; i <= last; ++i) {
+            current.insert(i, target.at(i));
+            currentKeys.insert(i, targetKeys.at(i));
+        }
+        model->endInsertRows();
+
+        row = last + 1;
+    }
+
+    // Kept items may have been replaced by a newer version
+    int firstChanged = -1;
+
+    for (int row = 0; row <= current.count(); ++row) {
+        if (row < current.count() && !(current.at(row) == target.at(row))) {
+            current[row] = target.at(row);
+
+            if (firstChanged == -1) {
+                firstChanged = row;
+            }
+        } else if (firstChanged != -1) {
+            Q_EMIT model->dataChanged(model->index(firstChanged, 0), model->index(row - 1, 0));
+            firstChanged = -1;
+        }
+    }
+
+    return removed;
+}
+
+/**
+ * Like the above, for items which are identified by themselves, e.g. pointers.
+ */
+template<typename T, typename Model>
+QList<T> updateRows(Model *model, QList<T> &current, const QList<T> &target)
+{
+    return updateRows(model, current, target, [](const T &item) {
+        return item;
+    });
+}
+
+}
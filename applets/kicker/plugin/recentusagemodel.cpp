@@ -9,7 +9,9 @@
 #include "appentry.h"
 #include "appsmodel.h"
 #include "debug.h"
+#include "documentdatacache.h"
 #include "kastatsfavoritesmodel.h"
+#include "kastatsquerypool.h"
 #include <kio_version.h>
 
 #include <config-X11.h>
@@ -62,7 +64,7 @@ InvalidAppsFilterProxy::InvalidAppsFilterProxy(AbstractModel *parentModel, QAbst
     connect(parentModel, &AbstractModel::favoritesModelChanged, this, &InvalidAppsFilterProxy::connectNewFavoritesModel);
     connectNewFavoritesModel();
 
-    sourceModel->setParent(this);
+    // The activities model is shared, see KAStatsQueryPool
     setSourceModel(sourceModel);
 }
 
@@ -122,7 +124,10 @@ RecentUsageModel::RecentUsageModel(QObject *parent, IncludeUsage usage, int orde
     , m_ordering((Ordering)ordering)
     , m_complete(false)
     , m_placesModel(new KFilePlacesModel(this))
+    , m_documentDataCache(new DocumentDataCache(m_placesModel, this))
 {
+    connect(m_documentDataCache, &DocumentDataCache::invalidated, this, &RecentUsageModel::documentDataChanged);
+
     refresh();
 }
 
@@ -245,25 +250,38 @@ QVariant RecentUsageModel::appData(const QString &resource, int role) const
     return QVariant();
 }
 
-QModelIndex RecentUsageModel::findPlaceForKFileItem(const KFileItem &fileItem) const
+static QUrl documentUrl(const QString &resource)
 {
-    const auto index = m_placesModel->closestItem(fileItem.url());
-    if (index.isValid()) {
-        const auto parentUrl = m_placesModel->url(index);
-        if (parentUrl == fileItem.url()) {
-            return index;
-        }
+    QUrl url(resource);
+
+    if (url.scheme().isEmpty()) {
+        url.setScheme(QStringLiteral("file"));
     }
-    return QModelIndex();
+
+    return url;
 }
 
-QVariant RecentUsageModel::docData(const QString &resource, int role) const
+void RecentUsageModel::documentDataChanged()
 {
-    QUrl url(resource);
+    if (rowCount() > 0) {
+        Q_EMIT dataChanged(index(0, 0), index(rowCount() - 1, 0), {Qt::DisplayRole, Qt::DecorationRole, Kicker::DescriptionRole});
+    }
+}
 
-    if (url.scheme().isEmpty()) {
-        url.setScheme(QStringLiteral("file"));
+void RecentUsageModel::invalidateDocumentData(int first, int last)
+{
+    for (int row = first; row <= last; ++row) {
+        const QString &resource = resourceAt(row);
+
+        if (!resource.startsWith(QLatin1String("applications:"))) {
+            m_documentDataCache->invalidate(documentUrl(resource));
+        }
     }
+}
+
+QVariant RecentUsageModel::docData(const QString &resource, int role) const
+{
+    const QUrl url = documentUrl(resource);
 
     auto getFileItem = [=]() {
         // Avoid calling QT_LSTAT and accessing recent documents
@@ -275,43 +293,15 @@ QVariant RecentUsageModel::docData(const QString &resource, int role) const
     }
 
     if (role == Qt::DisplayRole) {
-        auto fileItem = getFileItem();
-        const auto index = findPlaceForKFileItem(fileItem);
-        if (index.isValid()) {
-            return m_placesModel->text(index);
-        }
-        return fileItem.text();
+        return m_documentDataCache->data(url).text;
     } else if (role == Qt::DecorationRole) {
-        auto fileItem = getFileItem();
-        const auto index = findPlaceForKFileItem(fileItem);
-        if (index.isValid()) {
-            return m_placesModel->icon(index);
-        }
-        return QIcon::fromTheme(fileItem.iconName(), QIcon::fromTheme(QStringLiteral("unknown")));
+        return m_documentDataCache->data(url).icon;
     } else if (role == Kicker::GroupRole) {
         return i18n("Files");
     } else if (role == Kicker::FavoriteIdRole || role == Kicker::UrlRole) {
         return url.toString();
     } else if (role == Kicker::DescriptionRole) {
-        auto fileItem = getFileItem();
-        QString desc = fileItem.localPath();
-
-        const auto index = m_placesModel->closestItem(fileItem.url());
-        if (index.isValid()) {
-            // the current file has a parent in placesModel
-            const auto parentUrl = m_placesModel->url(index);
-            if (parentUrl == fileItem.url()) {
-                // if the current item is a place
-                return QString();
-            }
-            desc.truncate(desc.lastIndexOf(QChar('/')));
-            const auto text = m_placesModel->text(index);
-            desc.replace(0, parentUrl.path().length(), text);
-        } else {
-            // remove filename
-            desc.truncate(desc.lastIndexOf(QChar('/')));
-        }
-        return desc;
+        return m_documentDataCache->data(url).description;
     } else if (role == Kicker::UrlRole) {
         return url;
     } else if (role == Kicker::HasActionListRole) {
@@ -518,7 +508,17 @@ void RecentUsageModel::refresh()
     QAbstractItemModel *oldModel = sourceModel();
     disconnectSignals();
     setSourceModel(nullptr);
-    delete oldModel;
+
+    // The activities model outlives us when shared, don't leave our handlers on it
+    for (const QMetaObject::Connection &connection : qAsConst(m_documentDataConnections)) {
+        disconnect(connection);
+    }
+    m_documentDataConnections.clear();
+
+    // Only the proxies are ours
+    if (oldModel != m_activitiesModel) {
+        delete oldModel;
+    }
 
     // clang-format off
     auto query = UsedResources
@@ -543,15 +543,11 @@ void RecentUsageModel::refresh()
     }
     }
 
-    m_activitiesModel = new ResultModel(query);
+    // Other instances asking for the same items share the model
+    m_resultModel = KAStatsQueryPool::self()->resultModel(query);
+    m_activitiesModel = m_resultModel.get();
     QAbstractItemModel *model = m_activitiesModel;
 
-    QModelIndex index;
-
-    if (model->canFetchMore(index)) {
-        model->fetchMore(index);
-    }
-
     if (m_usage != OnlyDocs) {
         model = new InvalidAppsFilterProxy(this, model);
     }
@@ -560,5 +556,17 @@ void RecentUsageModel::refresh()
         model = new GroupSortProxy(this, model);
     }
 
+    // Connected before the forwarding, so that views don't get the outdated data
+    m_documentDataCache->clear();
+    m_documentDataConnections = {
+        connect(model, &QAbstractItemModel::dataChanged, this, [this](const QModelIndex &topLeft, const QModelIndex &bottomRight) {
+            invalidateDocumentData(topLeft.row(), bottomRight.row());
+        }),
+        connect(model, &QAbstractItemModel::rowsAboutToBeRemoved, this, [this](const QModelIndex &parent, int first, int last) {
+            Q_UNUSED(parent)
+            invalidateDocumentData(first, last);
+        }),
+    };
+
     setSourceModel(model);
 }
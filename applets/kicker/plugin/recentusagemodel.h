@@ -13,8 +13,10 @@
 #include <QSortFilterProxyModel>
 #include <KActivities/Stats/ResultModel>
 
+#include <memory>
+
 class QModelIndex;
-class KFileItem;
+class DocumentDataCache;
 
 class GroupSortProxy : public QSortFilterProxyModel
 {
@@ -105,13 +107,17 @@ private:
 
     QString forgetAllActionName() const;
 
-    QModelIndex findPlaceForKFileItem(const KFileItem &fileItem) const;
+    void documentDataChanged();
+    void invalidateDocumentData(int first, int last);
 
     IncludeUsage m_usage;
     QPointer<QAbstractItemModel> m_activitiesModel;
+    std::shared_ptr<KActivities::Stats::ResultModel> m_resultModel;
+    QList<QMetaObject::Connection> m_documentDataConnections;
 
     Ordering m_ordering;
 
     bool m_complete;
     KFilePlacesModel *m_placesModel;
+    DocumentDataCache *m_documentDataCache;
 };
@@ -65,6 +65,8 @@ RootModel::RootModel(QObject *parent)
     , m_recentAppsModel(nullptr)
     , m_recentDocsModel(nullptr)
     , m_recentContactsModel(nullptr)
+    , m_allModel(nullptr)
+    , m_appsOffset(0)
 {
 }
 
@@ -289,40 +291,7 @@ void RootModel::refresh()
     m_recentContactsModel = nullptr;
 
     if (m_showAllApps) {
-        QHash<QString, AbstractEntry *> appsHash;
-
-        std::function<void(AbstractEntry *)> processEntry = [&](AbstractEntry *entry) {
-            if (entry->type() == AbstractEntry::RunnableType) {
-                AppEntry *appEntry = static_cast<AppEntry *>(entry);
-                appsHash.insert(appEntry->service()->menuId(), appEntry);
-            } else if (entry->type() == AbstractEntry::GroupType) {
-                GroupEntry *groupEntry = static_cast<GroupEntry *>(entry);
-                AbstractModel *model = groupEntry->childModel();
-
-                if (!model) {
-                    return;
-                }
-
-                for (int i = 0; i < model->count(); ++i) {
-                    processEntry(static_cast<AbstractEntry *>(model->index(i, 0).internalPointer()));
-                }
-            }
-        };
-
-        for (AbstractEntry *entry : qAsConst(m_entryList)) {
-            processEntry(entry);
-        }
-
-        QList<AbstractEntry *> apps(appsHash.values());
-        QCollator c;
-
-        std::sort(apps.begin(), apps.end(), [&c](AbstractEntry *a, AbstractEntry *b) {
-            if (a->type() != b->type()) {
-                return a->type() > b->type();
-            } else {
-                return c.compare(a->name(), b->name()) < 0;
-            }
-        });
+        const QList<AbstractEntry *> apps = allApps(m_entryList);
 
         if (!m_showAllAppsCategorized && !m_paginate) { // The app list built above goes into a model.
             allModel = new AppsModel(apps, false, this);
@@ -359,27 +328,7 @@ void RootModel::refresh()
             allModel = new AppsModel(groups, true, this);
         } else { // We turn the apps list into a subtree of apps by starting letter.
             QList<AbstractEntry *> groups;
-            QHash<QString, QList<AbstractEntry *>> m_categoryHash;
-
-            for (const AbstractEntry *groupEntry : std::as_const(m_entryList)) {
-                AbstractModel *model = groupEntry->childModel();
-
-                if (!model)
-                    continue;
-
-                for (int i = 0; i < model->count(); ++i) {
-                    AbstractEntry *appEntry = static_cast<AbstractEntry *>(model->index(i, 0).internalPointer());
-
-                    if (appEntry->name().isEmpty()) {
-                        continue;
-                    }
-
-                    const QChar &first = appEntry->name().at(0).toUpper();
-                    m_categoryHash[first.isDigit() ? QStringLiteral("0-9") : first].append(appEntry);
-                }
-            }
-
-            QHashIterator<QString, QList<AbstractEntry *>> i(m_categoryHash);
+            QHashIterator<QString, QList<AbstractEntry *>> i(appsByFirstLetter(m_entryList));
 
             while (i.hasNext()) {
                 i.next();
@@ -394,6 +343,8 @@ void RootModel::refresh()
         allModel->setDescription(QStringLiteral("KICKER_ALL_MODEL")); // Intentionally no i18n.
     }
 
+    m_allModel = allModel;
+
     int separatorPosition = 0;
 
     if (allModel) {
@@ -443,9 +394,12 @@ void RootModel::refresh()
         ++separatorPosition;
     }
 
+    m_appsOffset = separatorPosition;
+
     if (m_showSeparators && separatorPosition > 0) {
         m_entryList.insert(separatorPosition, new SeparatorEntry(this));
         ++m_separatorCount;
+        ++m_appsOffset;
     }
 
     m_systemModel = new SystemModel(this);
@@ -464,3 +418,182 @@ void RootModel::refresh()
 
     Q_EMIT refreshed();
 }
+
+void RootModel::refreshIncrementally()
+{
+    if (!m_complete) {
+        return;
+    }
+
+    if (m_paginate) {
+        // The pages of all applications are cut from the sorted list, any change shifts all of them
+        refresh();
+        return;
+    }
+
+    // Only the applications and groups between the special groups in front and
+    // Power / Session at the end depend on the database
+    const int appsEnd = m_entryList.count() - (m_showPowerSession ? 1 : 0);
+    const int separatorCount = m_separatorCount;
+    const QList<AbstractEntry *> previousEntries = m_entryList;
+    QSet<AbstractEntry *> changedEntries;
+
+    const QList<AbstractEntry *> apps = rebuildEntryList(m_entryList.mid(m_appsOffset, appsEnd - m_appsOffset), changedEntries);
+    applyEntryList(m_entryList.mid(0, m_appsOffset) + apps + m_entryList.mid(appsEnd), changedEntries);
+
+    if (m_appsOffset > 0 && m_entryList.at(m_appsOffset - 1)->type() == AbstractEntry::SeparatorType) {
+        ++m_separatorCount;
+    }
+
+    updateChildModels(previousEntries, changedEntries);
+
+    if (m_allModel) {
+        if (m_showAllAppsCategorized) {
+            updateCategorizedAllModel(apps, changedEntries);
+        } else {
+            m_allModel->applyEntryList(allApps(apps), changedEntries);
+        }
+    }
+
+    m_favorites->refresh();
+
+    if (m_separatorCount != separatorCount) {
+        Q_EMIT separatorCountChanged();
+    }
+}
+
+static void sortByName(QList<AbstractEntry *> &entries)
+{
+    QCollator c;
+
+    std::sort(entries.begin(), entries.end(), [&c](AbstractEntry *a, AbstractEntry *b) {
+        if (a->type() != b->type()) {
+            return a->type() > b->type();
+        } else {
+            return c.compare(a->name(), b->name()) < 0;
+        }
+    });
+}
+
+QList<AbstractEntry *> RootModel::allApps(const QList<AbstractEntry *> &entryList) const
+{
+    QHash<QString, AbstractEntry *> appsHash;
+
+    std::function<void(AbstractEntry *)> processEntry = [&](AbstractEntry *entry) {
+        if (entry->type() == AbstractEntry::RunnableType) {
+            AppEntry *appEntry = static_cast<AppEntry *>(entry);
+            appsHash.insert(appEntry->service()->menuId(), appEntry);
+        } else if (entry->type() == AbstractEntry::GroupType) {
+            GroupEntry *groupEntry = static_cast<GroupEntry *>(entry);
+            AbstractModel *model = groupEntry->childModel();
+
+            if (!model) {
+                return;
+            }
+
+            for (int i = 0; i < model->count(); ++i) {
+                processEntry(static_cast<AbstractEntry *>(model->index(i, 0).internalPointer()));
+            }
+        }
+    };
+
+    for (AbstractEntry *entry : entryList) {
+        processEntry(entry);
+    }
+
+    QList<AbstractEntry *> apps(appsHash.values());
+    sortByName(apps);
+
+    return apps;
+}
+
+// Applications can be in several categories, but a letter group lists them only once,
+// like the AppsModel built from it in the first place
+static QList<AbstractEntry *> withoutDuplicateApps(const QList<AbstractEntry *> &entries)
+{
+    QList<AbstractEntry *> ret;
+    QSet<QString> storageIds;
+
+    for (AbstractEntry *entry : entries) {
+        if (entry->type() == AbstractEntry::RunnableType) {
+            const QString storageId = static_cast<AppEntry *>(entry)->service()->storageId();
+
+            if (storageIds.contains(storageId)) {
+                continue;
+            }
+
+            storageIds.insert(storageId);
+        }
+
+        ret << entry;
+    }
+
+    return ret;
+}
+
+QHash<QString, QList<AbstractEntry *>> RootModel::appsByFirstLetter(const QList<AbstractEntry *> &entryList) const
+{
+    QHash<QString, QList<AbstractEntry *>> categoryHash;
+
+    for (const AbstractEntry *groupEntry : entryList) {
+        AbstractModel *model = groupEntry->childModel();
+
+        if (!model)
+            continue;
+
+        for (int i = 0; i < model->count(); ++i) {
+            AbstractEntry *appEntry = static_cast<AbstractEntry *>(model->index(i, 0).internalPointer());
+
+            if (appEntry->name().isEmpty()) {
+                continue;
+            }
+
+            const QChar &first = appEntry->name().at(0).toUpper();
+            categoryHash[first.isDigit() ? QStringLiteral("0-9") : first].append(appEntry);
+        }
+    }
+
+    return categoryHash;
+}
+
+void RootModel::updateCategorizedAllModel(const QList<AbstractEntry *> &entryList, const QSet<AbstractEntry *> &changedEntries)
+{
+    QHash<QString, QList<AbstractEntry *>> categoryHash = appsByFirstLetter(entryList);
+    QList<AbstractEntry *> groups;
+    QList<AbstractModel *> removedModels;
+
+    for (int i = 0; i < m_allModel->count(); ++i) {
+        AbstractEntry *groupEntry = static_cast<AbstractEntry *>(m_allModel->index(i, 0).internalPointer());
+        AppsModel *model = qobject_cast<AppsModel *>(groupEntry->childModel());
+        QList<AbstractEntry *> apps = categoryHash.take(groupEntry->name());
+
+        if (!model) {
+            continue;
+        }
+
+        if (apps.isEmpty()) {
+            removedModels << model;
+            continue;
+        }
+
+        apps = withoutDuplicateApps(apps);
+        sortByName(apps);
+        model->applyEntryList(apps, changedEntries);
+        groups << groupEntry;
+    }
+
+    QHashIterator<QString, QList<AbstractEntry *>> i(categoryHash);
+
+    while (i.hasNext()) {
+        i.next();
+        AppsModel *model = new AppsModel(i.value(), false, this);
+        model->setDescription(i.key());
+        groups.append(new GroupEntry(this, i.key(), QString(), model));
+    }
+
+    m_allModel->applyEntryList(groups, {});
+
+    for (AbstractModel *model : std::as_const(removedModels)) {
+        model->deleteLater();
+    }
+}
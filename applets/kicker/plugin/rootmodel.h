@@ -96,8 +96,13 @@ Q_SIGNALS:
 
 protected Q_SLOTS:
     void refresh() override;
+    void refreshIncrementally() override;
 
 private:
+    QList<AbstractEntry *> allApps(const QList<AbstractEntry *> &entryList) const;
+    QHash<QString, QList<AbstractEntry *>> appsByFirstLetter(const QList<AbstractEntry *> &entryList) const;
+    void updateCategorizedAllModel(const QList<AbstractEntry *> &entryList, const QSet<AbstractEntry *> &changedEntries);
+
     KAStatsFavoritesModel *m_favorites;
     SystemModel *m_systemModel;
 
@@ -113,4 +118,8 @@ private:
     RecentUsageModel *m_recentAppsModel;
     RecentUsageModel *m_recentDocsModel;
     RecentContactsModel *m_recentContactsModel;
+
+    AppsModel *m_allModel;
+    // Row of the first entry built by AppsModel::refreshInternal()
+    int m_appsOffset;
 };
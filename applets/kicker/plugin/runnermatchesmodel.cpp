@@ -210,40 +210,14 @@ bool RunnerMatchesModel::trigger(int row, const QString &actionId, const QVarian
 
 void RunnerMatchesModel::setMatches(const QList<Plasma::QueryMatch> &matches)
 {
-    int oldCount = m_matches.count();
-    int newCount = matches.count();
+    const int oldCount = m_matches.count();
 
-    bool emitCountChange = (oldCount != newCount);
+    // Merge by id, so that matches which are still there keep their rows and delegates
+    Kicker::updateRows(this, m_matches, matches, [](const Plasma::QueryMatch &match) {
+        return match.id();
+    });
 
-    int ceiling = qMin(oldCount, newCount);
-    bool emitDataChange = false;
-
-    for (int row = 0; row < ceiling; ++row) {
-        if (!(m_matches.at(row) == matches.at(row))) {
-            emitDataChange = true;
-            m_matches[row] = matches.at(row);
-        }
-    }
-
-    if (emitDataChange) {
-        Q_EMIT dataChanged(index(0, 0), index(ceiling - 1, 0));
-    }
-
-    if (newCount > oldCount) {
-        beginInsertRows(QModelIndex(), oldCount, newCount - 1);
-
-        m_matches = matches;
-
-        endInsertRows();
-    } else if (newCount < oldCount) {
-        beginRemoveRows(QModelIndex(), newCount, oldCount - 1);
-
-        m_matches = matches;
-
-        endRemoveRows();
-    }
-
-    if (emitCountChange) {
+    if (m_matches.count() != oldCount) {
         Q_EMIT countChanged();
     }
 }
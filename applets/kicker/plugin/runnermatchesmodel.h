@@ -8,6 +8,7 @@
 #pragma once
 
 #include "abstractmodel.h"
+#include "listdiff.h"
 
 #include <KRunner/QueryMatch>
 
@@ -42,11 +43,18 @@ public:
         return m_name;
     }
 
+    QList<Plasma::QueryMatch> matches() const
+    {
+        return m_matches;
+    }
     void setMatches(const QList<Plasma::QueryMatch> &matches);
 
     AbstractModel *favoritesModel() override;
 
 private:
+    template<typename T, typename Model, typename KeyFunction>
+    friend QList<T> Kicker::updateRows(Model *model, QList<T> &current, const QList<T> &target, KeyFunction key);
+
     QString m_runnerId;
     QString m_name;
     Plasma::RunnerManager *m_runnerManager;
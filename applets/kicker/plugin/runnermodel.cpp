@@ -21,10 +21,16 @@ RunnerModel::RunnerModel(QObject *parent)
     , m_runnerManager(nullptr)
     , m_mergeResults(false)
     , m_deleteWhenEmpty(false)
+    , m_maxUpdateRate(30)
+    , m_hasPendingMatches(false)
 {
     m_queryTimer.setSingleShot(true);
     m_queryTimer.setInterval(10);
     connect(&m_queryTimer, &QTimer::timeout, this, &RunnerModel::startQuery);
+
+    m_updateTimer.setSingleShot(true);
+    m_updateTimer.setInterval(1000 / m_maxUpdateRate);
+    connect(&m_updateTimer, &QTimer::timeout, this, &RunnerModel::applyPendingMatches);
 }
 
 RunnerModel::~RunnerModel()
@@ -116,6 +122,29 @@ void RunnerModel::setMergeResults(bool merge)
     }
 }
 
+int RunnerModel::maxUpdateRate() const
+{
+    return m_maxUpdateRate;
+}
+
+void RunnerModel::setMaxUpdateRate(int rate)
+{
+    rate = qMax(0, rate);
+
+    if (m_maxUpdateRate != rate) {
+        m_maxUpdateRate = rate;
+
+        if (rate > 0) {
+            m_updateTimer.setInterval(1000 / rate);
+        } else {
+            m_updateTimer.stop();
+            applyPendingMatches();
+        }
+
+        Q_EMIT maxUpdateRateChanged();
+    }
+}
+
 QVariant RunnerModel::data(const QModelIndex &index, int role) const
 {
     if (!index.isValid() || index.row() >= m_models.count()) {
@@ -199,26 +228,78 @@ void RunnerModel::startQuery()
 
 void RunnerModel::matchesChanged(const QList<Plasma::QueryMatch> &matches)
 {
+    // Every batch holds all matches so far, so only the latest one matters
+    if (m_updateTimer.isActive()) {
+        m_pendingMatches = matches;
+        m_hasPendingMatches = true;
+        return;
+    }
+
+    applyMatches(matches);
+
+    if (m_maxUpdateRate > 0) {
+        m_updateTimer.start();
+    }
+}
+
+void RunnerModel::applyPendingMatches()
+{
+    if (!m_hasPendingMatches) {
+        return;
+    }
+
+    const QList<Plasma::QueryMatch> matches = m_pendingMatches;
+    m_pendingMatches.clear();
+    m_hasPendingMatches = false;
+
+    applyMatches(matches);
+
+    if (m_maxUpdateRate > 0) {
+        m_updateTimer.start();
+    }
+}
+
+void RunnerModel::applyMatches(const QList<Plasma::QueryMatch> &matches)
+{
+    // Within a query every batch repeats the previous one and appends the matches of the
+    // runners which finished since; only those need to be grouped and sorted. Anything
+    // else, like a new query, starts over.
+    int known = 0;
+
+    if (!m_matches.isEmpty() && matches.count() >= m_matches.count() && std::equal(m_matches.cbegin(), m_matches.cend(), matches.cbegin())) {
+        known = m_matches.count();
+    } else {
+        m_matchesForRunner.clear();
+    }
+
+    const bool rebuild = (known == 0);
+    m_matches = matches;
+
     // Group matches by runner.
     // We do not use a QMultiHash here because it keeps values in LIFO order, while we want FIFO.
-    QHash<QString, QList<Plasma::QueryMatch>> matchesForRunner;
+    QSet<QString> changedRunners;
 
-    for (const Plasma::QueryMatch &match : matches) {
-        auto it = matchesForRunner.find(match.runner()->id());
+    for (int i = known; i < matches.count(); ++i) {
+        const Plasma::QueryMatch &match = matches.at(i);
+        const QString runnerId = match.runner()->id();
 
-        if (it == matchesForRunner.end()) {
-            it = matchesForRunner.insert(match.runner()->id(), QList<Plasma::QueryMatch>());
-        }
+        m_matchesForRunner[runnerId].append(match);
+        changedRunners.insert(runnerId);
+    }
 
-        it.value().append(match);
+    if (!rebuild && changedRunners.isEmpty()) {
+        return;
     }
 
     // Sort matches for all runners in descending order, note the reverse iterators. This allows the best
     // match to win whilest preserving order between runners.
-    for (auto &list : matchesForRunner) {
+    for (const QString &runnerId : qAsConst(changedRunners)) {
+        QList<Plasma::QueryMatch> &list = m_matchesForRunner[runnerId];
         std::sort(list.rbegin(), list.rend());
     }
 
+    QHash<QString, QList<Plasma::QueryMatch>> matchesForRunner = m_matchesForRunner;
+
     if (m_mergeResults) {
         RunnerMatchesModel *matchesModel = nullptr;
 
@@ -270,10 +351,15 @@ void RunnerModel::matchesChanged(const QList<Plasma::QueryMatch> &matches)
     }
 
     // Assign matches to existing models. If there is no match for a model, delete it.
+    // Models of runners without new matches stay as they are.
     for (int row = m_models.count() - 1; row >= 0; --row) {
         RunnerMatchesModel *matchesModel = m_models.at(row);
         QList<Plasma::QueryMatch> matches = matchesForRunner.take(matchesModel->runnerId());
 
+        if (!rebuild && !changedRunners.contains(matchesModel->runnerId())) {
+            continue;
+        }
+
         if (m_deleteWhenEmpty && matches.isEmpty()) {
             beginRemoveRows(QModelIndex(), row, row);
             m_models.removeAt(row);
@@ -332,6 +418,12 @@ void RunnerModel::createManager()
 
 void RunnerModel::clear()
 {
+    m_updateTimer.stop();
+    m_pendingMatches.clear();
+    m_hasPendingMatches = false;
+    m_matches.clear();
+    m_matchesForRunner.clear();
+
     if (m_runnerManager) {
         m_runnerManager->reset();
         m_runnerManager->matchSessionComplete();
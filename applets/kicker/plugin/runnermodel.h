@@ -33,6 +33,7 @@ class RunnerModel : public QAbstractListModel
     Q_PROPERTY(QString query READ query WRITE setQuery NOTIFY queryChanged)
     Q_PROPERTY(bool mergeResults READ mergeResults WRITE setMergeResults NOTIFY mergeResultsChanged)
     Q_PROPERTY(bool deleteWhenEmpty READ deleteWhenEmpty WRITE setDeleteWhenEmpty NOTIFY deleteWhenEmptyChanged)
+    Q_PROPERTY(int maxUpdateRate READ maxUpdateRate WRITE setMaxUpdateRate NOTIFY maxUpdateRateChanged)
 
 public:
     explicit RunnerModel(QObject *parent = nullptr);
@@ -64,6 +65,14 @@ public:
     bool deleteWhenEmpty() const;
     void setDeleteWhenEmpty(bool deleteWhenEmpty);
 
+    /**
+     * How many times per second the match models may change at most, batches of
+     * matches arriving in between are merged into the next update. 0 applies every
+     * batch right away.
+     */
+    int maxUpdateRate() const;
+    void setMaxUpdateRate(int rate);
+
 Q_SIGNALS:
     void countChanged() const;
     void favoritesModelChanged() const;
@@ -72,14 +81,17 @@ Q_SIGNALS:
     void queryChanged() const;
     void mergeResultsChanged() const;
     void deleteWhenEmptyChanged();
+    void maxUpdateRateChanged();
 
 private Q_SLOTS:
     void startQuery();
     void matchesChanged(const QList<Plasma::QueryMatch> &matches);
+    void applyPendingMatches();
 
 private:
     void createManager();
     void clear();
+    void applyMatches(const QList<Plasma::QueryMatch> &matches);
 
     AbstractModel *m_favoritesModel;
     QObject *m_appletInterface;
@@ -90,4 +102,11 @@ private:
     QTimer m_queryTimer;
     bool m_mergeResults;
     bool m_deleteWhenEmpty;
+    int m_maxUpdateRate;
+    QTimer m_updateTimer;
+    QList<Plasma::QueryMatch> m_pendingMatches;
+    bool m_hasPendingMatches;
+    // The batch applied last and its matches by runner, sorted
+    QList<Plasma::QueryMatch> m_matches;
+    QHash<QString, QList<Plasma::QueryMatch>> m_matchesForRunner;
 };
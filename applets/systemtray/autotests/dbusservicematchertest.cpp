@@ -0,0 +1,117 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include <QtTest>
+
+#include "../dbusservicematcher.h"
+
+class DBusServiceMatcherTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void testMatch_data();
+    void testMatch();
+    void testRemove();
+    void benchmarkUniqueNames();
+
+private:
+    QHash<QString, QString> m_patterns;
+};
+
+void DBusServiceMatcherTest::initTestCase()
+{
+    m_patterns.insert(QStringLiteral("org.kde.plasma.mediacontroller"), QStringLiteral("org.mpris.MediaPlayer2.*"));
+    m_patterns.insert(QStringLiteral("org.kde.plasma.networkmanagement"), QStringLiteral("org.kde.plasmanetworkmanagement"));
+    m_patterns.insert(QStringLiteral("org.kde.plasma.printmanager"), QStringLiteral("org.kde.plasma.printmanager"));
+    m_patterns.insert(QStringLiteral("org.kde.plasma.vault"), QStringLiteral("org.kde.plasma.*.vault"));
+    m_patterns.insert(QStringLiteral("org.kde.plasma.bluetooth"), QStringLiteral("org.bluez?"));
+    m_patterns.insert(QStringLiteral("org.kde.plasma.everything"), QStringLiteral("*"));
+}
+
+void DBusServiceMatcherTest::testMatch_data()
+{
+    QTest::addColumn<QString>("service");
+
+    QTest::newRow("unique name") << ":1.42";
+    QTest::newRow("prefix pattern") << "org.mpris.MediaPlayer2.vlc";
+    QTest::newRow("prefix pattern, empty suffix") << "org.mpris.MediaPlayer2.";
+    QTest::newRow("prefix only") << "org.mpris.MediaPlayer2";
+    QTest::newRow("exact pattern") << "org.kde.plasmanetworkmanagement";
+    QTest::newRow("longer than exact pattern") << "org.kde.plasmanetworkmanagementd";
+    QTest::newRow("exact pattern that is a prefix of another") << "org.kde.plasma.printmanager";
+    QTest::newRow("wildcard in the middle") << "org.kde.plasma.foo.vault";
+    QTest::newRow("single character wildcard") << "org.bluezy";
+    QTest::newRow("unrelated") << "org.freedesktop.Notifications";
+}
+
+void DBusServiceMatcherTest::testMatch()
+{
+    QFETCH(QString, service);
+
+    DBusServiceMatcher matcher;
+    for (auto it = m_patterns.constBegin(); it != m_patterns.constEnd(); ++it) {
+        matcher.insert(it.key(), it.value());
+    }
+
+    // Same as matching every pattern on its own
+    QStringList expected;
+    if (!service.startsWith(QLatin1Char(':'))) {
+        for (auto it = m_patterns.constBegin(); it != m_patterns.constEnd(); ++it) {
+            QRegExp rx(it.value());
+            rx.setPatternSyntax(QRegExp::Wildcard);
+            if (rx.exactMatch(service)) {
+                expected << it.key();
+            }
+        }
+    }
+    expected.sort();
+
+    QStringList plugins = matcher.match(service);
+    plugins.sort();
+    QCOMPARE(plugins, expected);
+}
+
+void DBusServiceMatcherTest::testRemove()
+{
+    DBusServiceMatcher matcher;
+    matcher.insert(QStringLiteral("first"), QStringLiteral("org.mpris.MediaPlayer2.*"));
+    matcher.insert(QStringLiteral("second"), QStringLiteral("org.mpris.MediaPlayer2.vlc"));
+    QCOMPARE(matcher.match(QStringLiteral("org.mpris.MediaPlayer2.vlc")).size(), 2);
+
+    matcher.remove(QStringLiteral("first"));
+    QVERIFY(!matcher.contains(QStringLiteral("first")));
+    QCOMPARE(matcher.match(QStringLiteral("org.mpris.MediaPlayer2.vlc")), QStringList{QStringLiteral("second")});
+
+    // Registering again replaces the pattern
+    matcher.insert(QStringLiteral("second"), QStringLiteral("org.kde.*"));
+    QCOMPARE(matcher.pattern(QStringLiteral("second")), QStringLiteral("org.kde.*"));
+    QVERIFY(matcher.match(QStringLiteral("org.mpris.MediaPlayer2.vlc")).isEmpty());
+}
+
+void DBusServiceMatcherTest::benchmarkUniqueNames()
+{
+    // A session bus with many activatable plasmoids and clients coming and going
+    DBusServiceMatcher matcher;
+    for (int i = 0; i < 100; ++i) {
+        matcher.insert(QStringLiteral("plugin%1").arg(i), QStringLiteral("org.example.service%1.*").arg(i));
+    }
+
+    QStringList services;
+    for (int i = 0; i < 1000; ++i) {
+        services << QStringLiteral(":1.%1").arg(i) << QStringLiteral("org.example.client%1").arg(i);
+    }
+
+    QBENCHMARK {
+        for (const QString &service : qAsConst(services)) {
+            matcher.match(service);
+        }
+    }
+}
+
+QTEST_MAIN(DBusServiceMatcherTest)
+
+#include "dbusservicematchertest.moc"
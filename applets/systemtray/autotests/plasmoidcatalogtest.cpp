@@ -0,0 +1,222 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QJsonObject>
+#include <QSignalSpy>
+#include <QTest>
+
+#include <memory>
+
+#include "../plasmoidcatalog.h"
+
+class PlasmoidCatalogTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init();
+    void testApplets();
+    void testInstalled();
+    void testUpdated();
+    void testUninstalled();
+    void testCompiledInMetaData();
+    void testDirectoriesChanged();
+    void testUpdatePackages();
+
+private:
+    static KPluginMetaData applet(const QString &pluginId, bool notificationArea);
+    PlasmoidCatalog *catalog();
+
+    QVector<KPluginMetaData> m_installed;
+    QMap<QString, KPluginMetaData> m_packages;
+    int m_listCalls = 0;
+    QStringList m_loadCalls;
+    QMap<QString, QString> m_directories;
+    std::unique_ptr<PlasmoidCatalog> m_catalog;
+};
+
+KPluginMetaData PlasmoidCatalogTest::applet(const QString &pluginId, bool notificationArea)
+{
+    QJsonObject json{{QStringLiteral("KPlugin"), QJsonObject{{QStringLiteral("Id"), pluginId}}}};
+    if (notificationArea) {
+        json.insert(QStringLiteral("X-Plasma-NotificationArea"), QStringLiteral("true"));
+    }
+    return KPluginMetaData(json, QString());
+}
+
+PlasmoidCatalog *PlasmoidCatalogTest::catalog()
+{
+    if (!m_catalog) {
+        m_catalog.reset(new PlasmoidCatalog(
+            [this] {
+                ++m_listCalls;
+                return m_installed;
+            },
+            [this](const QString &pluginId) {
+                m_loadCalls << pluginId;
+                return m_packages.value(pluginId);
+            },
+            [this] {
+                return m_directories;
+            }));
+    }
+    return m_catalog.get();
+}
+
+void PlasmoidCatalogTest::init()
+{
+    m_catalog.reset();
+    m_packages.clear();
+    m_installed = {applet(QStringLiteral("org.kde.plasma.clock"), false),
+                   applet(QStringLiteral("org.kde.plasma.battery"), true),
+                   applet(QStringLiteral("org.kde.plasma.volume"), true)};
+    m_directories.clear();
+    for (const KPluginMetaData &pluginMetaData : qAsConst(m_installed)) {
+        m_packages.insert(pluginMetaData.pluginId(), pluginMetaData);
+        m_directories.insert(pluginMetaData.pluginId(), QStringLiteral("1000"));
+    }
+    m_listCalls = 0;
+    m_loadCalls.clear();
+}
+
+void PlasmoidCatalogTest::testApplets()
+{
+    const QStringList expected{QStringLiteral("org.kde.plasma.battery"), QStringLiteral("org.kde.plasma.volume")};
+    QCOMPARE(catalog()->applets().keys(), expected);
+
+    // Every further system tray gets them without another scan
+    QCOMPARE(catalog()->applets().keys(), expected);
+    QCOMPARE(m_listCalls, 1);
+    QCOMPARE(catalog()->applet(QStringLiteral("org.kde.plasma.volume")).pluginId(), QStringLiteral("org.kde.plasma.volume"));
+    QVERIFY(!catalog()->applet(QStringLiteral("org.kde.plasma.clock")).isValid());
+}
+
+void PlasmoidCatalogTest::testInstalled()
+{
+    catalog()->applets();
+    QSignalSpy changedSpy(catalog(), &PlasmoidCatalog::appletChanged);
+
+    // Only the new package gets read, once even though its directory showed up as well
+    m_packages.insert(QStringLiteral("org.kde.plasma.weather"), applet(QStringLiteral("org.kde.plasma.weather"), true));
+    m_directories.insert(QStringLiteral("org.kde.plasma.weather"), QStringLiteral("2000"));
+    catalog()->updatePackage(QStringLiteral("org.kde.plasma.weather"));
+    catalog()->updatePackages();
+    QCOMPARE(m_loadCalls, QStringList{QStringLiteral("org.kde.plasma.weather")});
+    QCOMPARE(m_listCalls, 1);
+    QCOMPARE(changedSpy.count(), 1);
+    QVERIFY(catalog()->applets().contains(QStringLiteral("org.kde.plasma.weather")));
+
+    // Other applets are none of the system tray's business
+    m_packages.insert(QStringLiteral("org.kde.plasma.notes"), applet(QStringLiteral("org.kde.plasma.notes"), false));
+    catalog()->updatePackage(QStringLiteral("org.kde.plasma.notes"));
+    QCOMPARE(changedSpy.count(), 1);
+    QVERIFY(!catalog()->applets().contains(QStringLiteral("org.kde.plasma.notes")));
+}
+
+void PlasmoidCatalogTest::testUpdated()
+{
+    catalog()->applets();
+    QSignalSpy changedSpy(catalog(), &PlasmoidCatalog::appletChanged);
+    QSignalSpy removedSpy(catalog(), &PlasmoidCatalog::appletRemoved);
+
+    catalog()->updatePackage(QStringLiteral("org.kde.plasma.battery"));
+    QCOMPARE(changedSpy.count(), 1);
+
+    // An update may move the applet out of the notification area
+    m_packages.insert(QStringLiteral("org.kde.plasma.battery"), applet(QStringLiteral("org.kde.plasma.battery"), false));
+    catalog()->updatePackage(QStringLiteral("org.kde.plasma.battery"));
+    QCOMPARE(changedSpy.count(), 1);
+    QCOMPARE(removedSpy.count(), 1);
+    QCOMPARE(catalog()->applets().keys(), QStringList{QStringLiteral("org.kde.plasma.volume")});
+}
+
+void PlasmoidCatalogTest::testUninstalled()
+{
+    catalog()->applets();
+    QSignalSpy removedSpy(catalog(), &PlasmoidCatalog::appletRemoved);
+
+    catalog()->removePackage(QStringLiteral("org.kde.plasma.clock"));
+    QCOMPARE(removedSpy.count(), 0);
+
+    catalog()->removePackage(QStringLiteral("org.kde.plasma.volume"));
+    QCOMPARE(removedSpy.count(), 1);
+    QCOMPARE(removedSpy.first().first().toString(), QStringLiteral("org.kde.plasma.volume"));
+    QCOMPARE(catalog()->applets().keys(), QStringList{QStringLiteral("org.kde.plasma.battery")});
+}
+
+void PlasmoidCatalogTest::testCompiledInMetaData()
+{
+    catalog()->applets();
+    QSignalSpy changedSpy(catalog(), &PlasmoidCatalog::appletChanged);
+
+    // Not a package of its own, found by looking at all applets again
+    m_installed << applet(QStringLiteral("org.kde.plasma.networkmanagement"), true);
+    catalog()->updatePackage(QStringLiteral("org.kde.plasma.networkmanagement"));
+    QCOMPARE(m_listCalls, 2);
+    QCOMPARE(changedSpy.count(), 1);
+    QVERIFY(catalog()->applets().contains(QStringLiteral("org.kde.plasma.networkmanagement")));
+}
+
+void PlasmoidCatalogTest::testDirectoriesChanged()
+{
+    catalog()->applets();
+    QSignalSpy changedSpy(catalog(), &PlasmoidCatalog::appletChanged);
+    QSignalSpy removedSpy(catalog(), &PlasmoidCatalog::appletRemoved);
+
+    // Installed, replaced and removed by the package manager, kpackage does not tell about it
+    m_packages.insert(QStringLiteral("org.kde.plasma.weather"), applet(QStringLiteral("org.kde.plasma.weather"), true));
+    m_directories.insert(QStringLiteral("org.kde.plasma.weather"), QStringLiteral("2000"));
+    m_packages.insert(QStringLiteral("org.kde.plasma.battery"), applet(QStringLiteral("org.kde.plasma.battery"), false));
+    m_directories.insert(QStringLiteral("org.kde.plasma.battery"), QStringLiteral("2000"));
+    m_packages.remove(QStringLiteral("org.kde.plasma.volume"));
+    m_directories.remove(QStringLiteral("org.kde.plasma.volume"));
+
+    // Only the packages whose directories differ get read, the applets are not listed again
+    QCOMPARE(catalog()->applets().keys(), QStringList{QStringLiteral("org.kde.plasma.weather")});
+    QCOMPARE(m_listCalls, 1);
+    QCOMPARE(m_loadCalls, QStringList({QStringLiteral("org.kde.plasma.battery"), QStringLiteral("org.kde.plasma.weather")}));
+    QCOMPARE(changedSpy.count(), 1);
+    QCOMPARE(changedSpy.first().first().toString(), QStringLiteral("org.kde.plasma.weather"));
+    QCOMPARE(removedSpy.count(), 2);
+    QCOMPARE(removedSpy.at(0).first().toString(), QStringLiteral("org.kde.plasma.battery"));
+    QCOMPARE(removedSpy.at(1).first().toString(), QStringLiteral("org.kde.plasma.volume"));
+
+    // Which is noticed once
+    catalog()->applets();
+    QCOMPARE(m_listCalls, 1);
+    QCOMPARE(m_loadCalls.count(), 2);
+}
+
+void PlasmoidCatalogTest::testUpdatePackages()
+{
+    QSignalSpy changedSpy(catalog(), &PlasmoidCatalog::appletChanged);
+
+    // Nothing to do before anybody asked for the applets
+    m_directories.insert(QStringLiteral("org.kde.plasma.weather"), QStringLiteral("2000"));
+    catalog()->updatePackages();
+    QCOMPARE(m_listCalls, 0);
+    QVERIFY(m_loadCalls.isEmpty());
+
+    // Directories which did not change are not read again
+    catalog()->applets();
+    catalog()->updatePackages();
+    QCOMPARE(m_listCalls, 1);
+    QVERIFY(m_loadCalls.isEmpty());
+    QCOMPARE(changedSpy.count(), 0);
+
+    // A package which gets updated in place
+    m_packages.insert(QStringLiteral("org.kde.plasma.volume"), applet(QStringLiteral("org.kde.plasma.volume"), true));
+    m_directories.insert(QStringLiteral("org.kde.plasma.volume"), QStringLiteral("3000"));
+    catalog()->updatePackages();
+    QCOMPARE(m_loadCalls, QStringList{QStringLiteral("org.kde.plasma.volume")});
+    QCOMPARE(changedSpy.count(), 1);
+    QCOMPARE(changedSpy.first().first().toString(), QStringLiteral("org.kde.plasma.volume"));
+    QCOMPARE(m_listCalls, 1);
+}
+
+QTEST_GUILESS_MAIN(PlasmoidCatalogTest)
+
+#include "plasmoidcatalogtest.moc"
@@ -0,0 +1,231 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QDBusAbstractAdaptor>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusMetaType>
+#include <QProcess>
+#include <QSignalSpy>
+#include <QTest>
+
+#include "../statusnotifieritemsource.h"
+#include "../systemtraytypes.h"
+
+static const QString s_path = QStringLiteral("/StatusNotifierItem");
+static const QString s_interface = QStringLiteral("org.kde.StatusNotifierItem");
+
+// An item with a title, a tooltip and a two frame icon, counting how often its properties are read
+class FakeItem : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FakeItem(const QDBusConnection &connection)
+        : m_connection(connection)
+    {
+        for (int size : {16, 22}) {
+            KDbusImageStruct frame;
+            frame.width = size;
+            frame.height = size;
+            // opaque red, in network byte order
+            for (int i = 0; i < size * size; ++i) {
+                frame.data += QByteArray::fromHex("ffff0000");
+            }
+            icon << frame;
+        }
+    }
+
+    void emitSignal(const QString &name)
+    {
+        m_connection.send(QDBusMessage::createSignal(s_path, s_interface, name));
+    }
+
+    QString title = QStringLiteral("Fake Item");
+    QString toolTipTitle = QStringLiteral("Fake Tool Tip");
+    KDbusImageVector icon;
+
+    QHash<QString, int> reads;
+
+private:
+    QDBusConnection m_connection;
+};
+
+class FakeItemAdaptor : public QDBusAbstractAdaptor
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.kde.StatusNotifierItem")
+    Q_PROPERTY(QString Category READ category)
+    Q_PROPERTY(QString Id READ id)
+    Q_PROPERTY(QString Title READ title)
+    Q_PROPERTY(QString Status READ status)
+    Q_PROPERTY(KDbusImageVector IconPixmap READ iconPixmap)
+    Q_PROPERTY(KDbusToolTipStruct ToolTip READ toolTip)
+
+public:
+    explicit FakeItemAdaptor(FakeItem *item)
+        : QDBusAbstractAdaptor(item)
+        , m_item(item)
+    {
+    }
+
+    QString category() const
+    {
+        return QStringLiteral("ApplicationStatus");
+    }
+
+    QString id() const
+    {
+        return QStringLiteral("fakeitem");
+    }
+
+    QString title() const
+    {
+        ++m_item->reads[QStringLiteral("Title")];
+        return m_item->title;
+    }
+
+    QString status() const
+    {
+        return QStringLiteral("Active");
+    }
+
+    KDbusImageVector iconPixmap() const
+    {
+        ++m_item->reads[QStringLiteral("IconPixmap")];
+        return m_item->icon;
+    }
+
+    KDbusToolTipStruct toolTip() const
+    {
+        ++m_item->reads[QStringLiteral("ToolTip")];
+        KDbusToolTipStruct toolTip;
+        toolTip.title = m_item->toolTipTitle;
+        toolTip.image = m_item->icon;
+        return toolTip;
+    }
+
+private:
+    FakeItem *m_item;
+};
+
+class StatusNotifierItemSourceTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void testInitialRefresh();
+    void testNewTitle();
+    void testNewToolTip();
+    void testNewIcon();
+
+private:
+    QProcess m_bus;
+    FakeItem *m_item = nullptr;
+    StatusNotifierItemSource *m_source = nullptr;
+};
+
+void StatusNotifierItemSourceTest::initTestCase()
+{
+    // Everything talks over a private bus, the source only knows about the session bus
+    m_bus.start(QStringLiteral("dbus-daemon"), {QStringLiteral("--session"), QStringLiteral("--nofork"), QStringLiteral("--print-address")});
+    if (!m_bus.waitForStarted() || !m_bus.waitForReadyRead()) {
+        QSKIP("Cannot run dbus-daemon");
+    }
+    qputenv("DBUS_SESSION_BUS_ADDRESS", m_bus.readLine().trimmed());
+    QVERIFY(QDBusConnection::sessionBus().isConnected());
+
+    qDBusRegisterMetaType<KDbusImageStruct>();
+    qDBusRegisterMetaType<KDbusImageVector>();
+    qDBusRegisterMetaType<KDbusToolTipStruct>();
+
+    QDBusConnection item = QDBusConnection::connectToBus(QDBusConnection::SessionBus, QStringLiteral("item"));
+    m_item = new FakeItem(item);
+    new FakeItemAdaptor(m_item);
+    QVERIFY(item.registerObject(s_path, m_item, QDBusConnection::ExportAdaptors));
+
+    m_source = new StatusNotifierItemSource(item.baseService() + s_path, this);
+}
+
+void StatusNotifierItemSourceTest::cleanupTestCase()
+{
+    delete m_source;
+    delete m_item;
+    QDBusConnection::disconnectFromBus(QStringLiteral("item"));
+    m_bus.terminate();
+    m_bus.waitForFinished();
+}
+
+void StatusNotifierItemSourceTest::testInitialRefresh()
+{
+    QSignalSpy updateSpy(m_source, &StatusNotifierItemSource::dataUpdated);
+    QVERIFY(updateSpy.wait());
+
+    QCOMPARE(m_source->title(), QStringLiteral("Fake Item"));
+    QCOMPARE(m_source->toolTipTitle(), QStringLiteral("Fake Tool Tip"));
+    QCOMPARE(m_source->status(), QStringLiteral("Active"));
+    QCOMPARE(m_source->icon().availableSizes().count(), 2);
+    QCOMPARE(m_source->icon().pixmap(16, 16).toImage().pixelColor(8, 8), QColor(Qt::red));
+
+    // The tooltip shows the same frames as the icon, which were converted once
+    QCOMPARE(StatusNotifierItemSource::pixmapCacheMisses(), quint64(2));
+    QCOMPARE(StatusNotifierItemSource::pixmapCacheHits(), quint64(2));
+}
+
+void StatusNotifierItemSourceTest::testNewTitle()
+{
+    const QHash<QString, int> reads = m_item->reads;
+    QSignalSpy updateSpy(m_source, &StatusNotifierItemSource::dataUpdated);
+
+    m_item->title = QStringLiteral("New Title");
+    m_item->emitSignal(QStringLiteral("NewTitle"));
+    QVERIFY(updateSpy.wait());
+
+    QCOMPARE(m_source->title(), QStringLiteral("New Title"));
+    QCOMPARE(m_item->reads.value(QStringLiteral("Title")), reads.value(QStringLiteral("Title")) + 1);
+    // Neither the icon nor the tooltip is transferred again
+    QCOMPARE(m_item->reads.value(QStringLiteral("IconPixmap")), reads.value(QStringLiteral("IconPixmap")));
+    QCOMPARE(m_item->reads.value(QStringLiteral("ToolTip")), reads.value(QStringLiteral("ToolTip")));
+}
+
+void StatusNotifierItemSourceTest::testNewToolTip()
+{
+    const QHash<QString, int> reads = m_item->reads;
+    QSignalSpy updateSpy(m_source, &StatusNotifierItemSource::dataUpdated);
+
+    m_item->toolTipTitle = QStringLiteral("New Tool Tip");
+    m_item->emitSignal(QStringLiteral("NewToolTip"));
+    QVERIFY(updateSpy.wait());
+
+    QCOMPARE(m_source->toolTipTitle(), QStringLiteral("New Tool Tip"));
+    QCOMPARE(m_item->reads.value(QStringLiteral("ToolTip")), reads.value(QStringLiteral("ToolTip")) + 1);
+    QCOMPARE(m_item->reads.value(QStringLiteral("Title")), reads.value(QStringLiteral("Title")));
+    QCOMPARE(m_item->reads.value(QStringLiteral("IconPixmap")), reads.value(QStringLiteral("IconPixmap")));
+}
+
+void StatusNotifierItemSourceTest::testNewIcon()
+{
+    const QHash<QString, int> reads = m_item->reads;
+    const quint64 misses = StatusNotifierItemSource::pixmapCacheMisses();
+    const quint64 hits = StatusNotifierItemSource::pixmapCacheHits();
+    QSignalSpy updateSpy(m_source, &StatusNotifierItemSource::dataUpdated);
+
+    // The icons come with a single GetAll
+    m_item->emitSignal(QStringLiteral("NewIcon"));
+    QVERIFY(updateSpy.wait());
+    QCOMPARE(m_item->reads.value(QStringLiteral("IconPixmap")), reads.value(QStringLiteral("IconPixmap")) + 1);
+
+    // An icon switching back to frames it showed before is not converted again
+    QCOMPARE(StatusNotifierItemSource::pixmapCacheMisses(), misses);
+    QVERIFY(StatusNotifierItemSource::pixmapCacheHits() >= hits + 2);
+    QCOMPARE(m_source->icon().pixmap(22, 22).toImage().pixelColor(8, 8), QColor(Qt::red));
+}
+
+QTEST_MAIN(StatusNotifierItemSourceTest)
+
+#include "statusnotifieritemsourcetest.moc"
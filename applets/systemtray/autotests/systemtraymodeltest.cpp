@@ -4,6 +4,7 @@
     SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
 */
 
+#include <QJsonObject>
 #include <QPointer>
 #include <QtTest>
 
@@ -24,6 +25,7 @@ class SystemTrayModelTest : public QObject
 private Q_SLOTS:
     void init();
     void testPlasmoidModel();
+    void testPlasmoidModelUpdates();
 };
 
 void SystemTrayModelTest::init()
@@ -181,6 +183,56 @@ void SystemTrayModelTest::testPlasmoidModel()
     delete model;
 }
 
+void SystemTrayModelTest::testPlasmoidModelUpdates()
+{
+    // given: model with a thousand plasmoids, all of them with an applet
+    MockedSystemTraySettings *settings = new MockedSystemTraySettings();
+    MockedPlasmoidRegistry *plasmoidRegistry = new MockedPlasmoidRegistry(settings);
+    PlasmoidModel *model = new PlasmoidModel(settings, plasmoidRegistry);
+
+    QVector<Plasma::Applet *> applets;
+    for (int i = 0; i < 1000; ++i) {
+        const QJsonObject plugin{{QStringLiteral("Id"), QStringLiteral("org.kde.plasma.test%1").arg(i)}};
+        const KPluginMetaData pluginMetaData(QJsonObject{{QStringLiteral("KPlugin"), plugin}}, QString());
+        Q_EMIT plasmoidRegistry->pluginRegistered(pluginMetaData);
+        applets << new Plasma::Applet(nullptr, pluginMetaData, QVariantList{});
+        model->addApplet(applets.last());
+    }
+    QCOMPARE(model->rowCount(), 1000);
+
+    // when: every third plasmoid is uninstalled
+    for (int i = 0; i < applets.size(); i += 3) {
+        model->removeApplet(applets[i]);
+        Q_EMIT plasmoidRegistry->pluginUnregistered(applets[i]->pluginMetaData().pluginId());
+    }
+    // then: the remaining ones keep their order
+    QCOMPARE(model->rowCount(), 666);
+    QCOMPARE(model->data(model->index(0, 0), static_cast<int>(BaseModel::BaseRole::ItemId)).toString(), "org.kde.plasma.test1");
+    QCOMPARE(model->data(model->index(665, 0), static_cast<int>(BaseModel::BaseRole::ItemId)).toString(), "org.kde.plasma.test998");
+
+    // when: applets keep changing their status, like chatty tray icons do
+    QSignalSpy dataChangedSpy(model, &QAbstractItemModel::dataChanged);
+    for (int round = 0; round < 10; ++round) {
+        const auto status = round % 2 ? Plasma::Types::ItemStatus::PassiveStatus : Plasma::Types::ItemStatus::ActiveStatus;
+        for (int i = 1; i < applets.size(); i += (i % 3 == 1 ? 1 : 2)) {
+            applets[i]->setStatus(status);
+            // then: each update is reported for the row of its applet
+            const QModelIndex idx = dataChangedSpy.takeLast().at(0).toModelIndex();
+            QCOMPARE(model->data(idx, static_cast<int>(BaseModel::BaseRole::ItemId)).toString(), applets[i]->pluginMetaData().pluginId());
+            QCOMPARE(model->data(idx, static_cast<int>(BaseModel::BaseRole::Status)), QVariant(status));
+        }
+    }
+
+    // and expect: updates stay cheap with many items
+    Plasma::Applet *lastApplet = applets[998];
+    int round = 0;
+    QBENCHMARK {
+        lastApplet->setStatus(++round % 2 ? Plasma::Types::ItemStatus::PassiveStatus : Plasma::Types::ItemStatus::ActiveStatus);
+    }
+
+    delete model;
+}
+
 QTEST_MAIN(SystemTrayModelTest)
 
 #include "systemtraymodeltest.moc"
@@ -0,0 +1,117 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "dbusservicematcher.h"
+
+static int indexOfWildcard(const QString &pattern)
+{
+    for (int i = 0; i < pattern.size(); ++i) {
+        const QChar c = pattern.at(i);
+        if (c == QLatin1Char('*') || c == QLatin1Char('?') || c == QLatin1Char('[') || c == QLatin1Char('\\')) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+DBusServiceMatcher::DBusServiceMatcher()
+    : m_nodes(1)
+{
+}
+
+void DBusServiceMatcher::insert(const QString &pluginId, const QString &pattern)
+{
+    remove(pluginId);
+
+    m_patterns.insert(pluginId, pattern);
+    add(pluginId, pattern);
+}
+
+void DBusServiceMatcher::remove(const QString &pluginId)
+{
+    if (!m_patterns.remove(pluginId)) {
+        return;
+    }
+
+    // Plugins hardly ever go away, rebuilding is simpler than pruning the trie
+    m_nodes = QVector<Node>(1);
+    for (auto it = m_patterns.constBegin(), end = m_patterns.constEnd(); it != end; ++it) {
+        add(it.key(), it.value());
+    }
+}
+
+bool DBusServiceMatcher::contains(const QString &pluginId) const
+{
+    return m_patterns.contains(pluginId);
+}
+
+QString DBusServiceMatcher::pattern(const QString &pluginId) const
+{
+    return m_patterns.value(pluginId);
+}
+
+void DBusServiceMatcher::add(const QString &pluginId, const QString &pattern)
+{
+    const int wildcard = indexOfWildcard(pattern);
+    const int prefixLength = wildcard < 0 ? pattern.size() : wildcard;
+
+    int node = 0;
+    for (int i = 0; i < prefixLength; ++i) {
+        const QChar c = pattern.at(i);
+        int child = m_nodes.at(node).children.value(c, -1);
+        if (child < 0) {
+            child = m_nodes.size();
+            m_nodes.append(Node());
+            m_nodes[node].children.insert(c, child);
+        }
+        node = child;
+    }
+
+    Node &prefixNode = m_nodes[node];
+    if (wildcard < 0) {
+        prefixNode.exact << pluginId;
+    } else if (wildcard == pattern.size() - 1 && pattern.at(wildcard) == QLatin1Char('*')) {
+        prefixNode.anySuffix << pluginId;
+    } else {
+        QRegExp rx(pattern);
+        rx.setPatternSyntax(QRegExp::Wildcard);
+        prefixNode.other << qMakePair(pluginId, rx);
+    }
+}
+
+QStringList DBusServiceMatcher::match(const QString &service) const
+{
+    QStringList ret;
+
+    // Unique connection names come and go all the time and are never activation services
+    if (service.startsWith(QLatin1Char(':')) || m_patterns.isEmpty()) {
+        return ret;
+    }
+
+    int node = 0;
+    for (int i = 0;; ++i) {
+        const Node &current = m_nodes.at(node);
+
+        ret << current.anySuffix;
+        for (const auto &other : current.other) {
+            if (other.second.exactMatch(service)) {
+                ret << other.first;
+            }
+        }
+
+        if (i == service.size()) {
+            ret << current.exact;
+            break;
+        }
+
+        node = current.children.value(service.at(i), -1);
+        if (node < 0) {
+            break;
+        }
+    }
+
+    return ret;
+}
@@ -0,0 +1,53 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QHash>
+#include <QRegExp>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * @brief Matches DBus service names against the activation patterns of all plasmoids at once.
+ *
+ * Patterns use wildcard syntax, like X-Plasma-DBusActivationService. Their literal
+ * prefixes are stored in a trie, so matching a service name only walks the name, no
+ * matter how many patterns there are. Unique connection names like ":1.42" are
+ * rejected right away.
+ */
+class DBusServiceMatcher
+{
+public:
+    DBusServiceMatcher();
+
+    void insert(const QString &pluginId, const QString &pattern);
+    void remove(const QString &pluginId);
+
+    bool contains(const QString &pluginId) const;
+    QString pattern(const QString &pluginId) const;
+
+    /**
+     * @return ids of the plugins whose pattern matches @p service
+     */
+    QStringList match(const QString &service) const;
+
+private:
+    struct Node {
+        QHash<QChar, int> children;
+        // Patterns without wildcards, ending in this node
+        QStringList exact;
+        // Patterns made of this node's prefix and a trailing '*'
+        QStringList anySuffix;
+        // Any other pattern starting with this node's prefix
+        QVector<QPair<QString, QRegExp>> other;
+    };
+
+    void add(const QString &pluginId, const QString &pattern);
+
+    QHash<QString /*plugin id*/, QString /*pattern*/> m_patterns;
+    QVector<Node> m_nodes;
+};
@@ -60,9 +60,7 @@ void DBusServiceObserver::registerPlugin(const KPluginMetaData &pluginMetaData)
     const QString dbusactivation = pluginMetaData.value(QStringLiteral("X-Plasma-DBusActivationService"));
     if (!dbusactivation.isEmpty()) {
         qCDebug(SYSTEM_TRAY) << "Found DBus-able Applet: " << pluginMetaData.pluginId() << dbusactivation;
-        QRegExp rx(dbusactivation);
-        rx.setPatternSyntax(QRegExp::Wildcard);
-        m_dbusActivatableTasks[pluginMetaData.pluginId()] = rx;
+        m_dbusActivatableTasks.insert(pluginMetaData.pluginId(), dbusactivation);
 
         const QString watchedService = QString(dbusactivation).replace(".*", "*");
         m_sessionServiceWatcher->addWatchedService(watchedService);
@@ -73,8 +71,8 @@ void DBusServiceObserver::registerPlugin(const KPluginMetaData &pluginMetaData)
 void DBusServiceObserver::unregisterPlugin(const QString &pluginId)
 {
     if (m_dbusActivatableTasks.contains(pluginId)) {
-        QRegExp rx = m_dbusActivatableTasks.take(pluginId);
-        const QString watchedService = rx.pattern().replace(".*", "*");
+        const QString watchedService = m_dbusActivatableTasks.pattern(pluginId).replace(".*", "*");
+        m_dbusActivatableTasks.remove(pluginId);
         m_sessionServiceWatcher->removeWatchedService(watchedService);
         m_systemServiceWatcher->removeWatchedService(watchedService);
     }
@@ -135,41 +133,31 @@ void DBusServiceObserver::serviceNameFetchFinished(QDBusPendingCallWatcher *watc
 
 void DBusServiceObserver::serviceRegistered(const QString &service)
 {
-    if (service.startsWith(QLatin1Char(':'))) {
-        return;
-    }
-
-    for (auto it = m_dbusActivatableTasks.constBegin(), end = m_dbusActivatableTasks.constEnd(); it != end; ++it) {
-        const QString &plugin = it.key();
+    const QStringList plugins = m_dbusActivatableTasks.match(service);
+    for (const QString &plugin : plugins) {
         if (!m_settings->isEnabledPlugin(plugin)) {
             continue;
         }
 
-        const auto &rx = it.value();
-        if (rx.exactMatch(service)) {
-            qCDebug(SYSTEM_TRAY) << "DBus service" << service << "matching" << m_dbusActivatableTasks[plugin] << "appeared. Loading" << plugin;
-            Q_EMIT serviceStarted(plugin);
-            m_dbusServiceCounts[plugin]++;
-        }
+        qCDebug(SYSTEM_TRAY) << "DBus service" << service << "matching" << m_dbusActivatableTasks.pattern(plugin) << "appeared. Loading" << plugin;
+        Q_EMIT serviceStarted(plugin);
+        m_dbusServiceCounts[plugin]++;
     }
 }
 
 void DBusServiceObserver::serviceUnregistered(const QString &service)
 {
-    for (auto it = m_dbusActivatableTasks.constBegin(), end = m_dbusActivatableTasks.constEnd(); it != end; ++it) {
-        const QString &plugin = it.key();
+    const QStringList plugins = m_dbusActivatableTasks.match(service);
+    for (const QString &plugin : plugins) {
         if (!m_settings->isEnabledPlugin(plugin)) {
             continue;
         }
 
-        const auto &rx = it.value();
-        if (rx.exactMatch(service)) {
-            m_dbusServiceCounts[plugin]--;
-            Q_ASSERT(m_dbusServiceCounts[plugin] >= 0);
-            if (m_dbusServiceCounts[plugin] == 0) {
-                qCDebug(SYSTEM_TRAY) << "DBus service" << service << "matching" << m_dbusActivatableTasks[plugin] << "disappeared. Unloading" << plugin;
-                Q_EMIT serviceStopped(plugin);
-            }
+        m_dbusServiceCounts[plugin]--;
+        Q_ASSERT(m_dbusServiceCounts[plugin] >= 0);
+        if (m_dbusServiceCounts[plugin] == 0) {
+            qCDebug(SYSTEM_TRAY) << "DBus service" << service << "matching" << m_dbusActivatableTasks.pattern(plugin) << "disappeared. Unloading" << plugin;
+            Q_EMIT serviceStopped(plugin);
         }
     }
 }
@@ -7,10 +7,11 @@
 
 #pragma once
 
+#include "dbusservicematcher.h"
+
 #include <QHash>
 #include <QObject>
 #include <QPointer>
-#include <QRegExp>
 
 class KPluginMetaData;
 class SystemTraySettings;
@@ -47,7 +48,7 @@ private:
     QDBusServiceWatcher *m_sessionServiceWatcher;
     QDBusServiceWatcher *m_systemServiceWatcher;
 
-    QHash<QString /*plugin id*/, QRegExp /*DBus Service*/> m_dbusActivatableTasks;
+    DBusServiceMatcher m_dbusActivatableTasks;
     QHash<QString, int> m_dbusServiceCounts;
     bool m_dbusSessionServiceNamesFetched = false;
     bool m_dbusSystemServiceNamesFetched = false;
@@ -0,0 +1,213 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "plasmoidcatalog.h"
+#include "debug.h"
+
+#include <KPackage/Package>
+#include <KPackage/PackageLoader>
+#include <Plasma/PluginLoader>
+
+#include <QCoreApplication>
+#include <QDBusConnection>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QStandardPaths>
+#include <QTimer>
+
+static QStringList plasmoidDirectories()
+{
+    return QStandardPaths::locateAll(QStandardPaths::GenericDataLocation, QStringLiteral("plasma/plasmoids"), QStandardPaths::LocateDirectory);
+}
+
+PlasmoidCatalog *PlasmoidCatalog::self()
+{
+    static PlasmoidCatalog *catalog = [] {
+        auto catalog = new PlasmoidCatalog(
+            [] {
+                return Plasma::PluginLoader::self()->listAppletMetaData(QString()).toVector();
+            },
+            [](const QString &pluginId) {
+                // Only reads the directory of this one package
+                return KPackage::PackageLoader::self()->loadPackage(QStringLiteral("Plasma/Applet"), pluginId).metadata();
+            },
+            &PlasmoidCatalog::packageDirectories,
+            QCoreApplication::instance());
+
+        const QString path = QStringLiteral("/KPackage/Plasma/Applet");
+        const QString interface = QStringLiteral("org.kde.plasma.kpackage");
+        QDBusConnection::sessionBus().connect(QString(), path, interface, QStringLiteral("packageInstalled"), catalog, SLOT(updatePackage(QString)));
+        QDBusConnection::sessionBus().connect(QString(), path, interface, QStringLiteral("packageUpdated"), catalog, SLOT(updatePackage(QString)));
+        QDBusConnection::sessionBus().connect(QString(), path, interface, QStringLiteral("packageUninstalled"), catalog, SLOT(removePackage(QString)));
+
+        // Packages installed behind kpackage's back, compress the bursts of a package manager
+        auto updateTimer = new QTimer(catalog);
+        updateTimer->setSingleShot(true);
+        updateTimer->setInterval(1000);
+        connect(updateTimer, &QTimer::timeout, catalog, &PlasmoidCatalog::updatePackages);
+
+        auto watcher = new QFileSystemWatcher(plasmoidDirectories(), catalog);
+        connect(watcher, &QFileSystemWatcher::directoryChanged, updateTimer, qOverload<>(&QTimer::start));
+        return catalog;
+    }();
+    return catalog;
+}
+
+PlasmoidCatalog::PlasmoidCatalog(const ListFunction &list, const LoadFunction &load, const PackagesFunction &packages, QObject *parent)
+    : QObject(parent)
+    , m_list(list)
+    , m_load(load)
+    , m_packages(packages)
+{
+}
+
+QMap<QString, QString> PlasmoidCatalog::packageDirectories()
+{
+    QMap<QString, QString> packages;
+    const QStringList directories = plasmoidDirectories();
+    for (const QString &directory : directories) {
+        const QFileInfoList entries = QDir(directory).entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot);
+        for (const QFileInfo &entry : entries) {
+            // The first directory wins, as for the package loader. Package managers replace
+            // the metadata file of a package, which touches its directory as well
+            if (!packages.contains(entry.fileName())) {
+                packages.insert(entry.fileName(), entry.filePath() + QLatin1Char('@') + QString::number(entry.lastModified().toMSecsSinceEpoch()));
+            }
+        }
+    }
+    return packages;
+}
+
+bool PlasmoidCatalog::isNotificationAreaApplet(const KPluginMetaData &pluginMetaData)
+{
+    return pluginMetaData.isValid() && pluginMetaData.value(QStringLiteral("X-Plasma-NotificationArea")) == QLatin1String("true");
+}
+
+QMap<QString, KPluginMetaData> PlasmoidCatalog::applets()
+{
+    if (!m_scanned) {
+        scan();
+        return m_applets;
+    }
+
+    // Changes the watcher did not report yet
+    updatePackages();
+
+    qCDebug(SYSTEM_TRAY) << "Took notification area applets from the catalog, saving a" << m_scanTime << "ms scan";
+    return m_applets;
+}
+
+void PlasmoidCatalog::scan()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    if (m_packages) {
+        // Taken before listing, so that changes during the scan are not missed
+        m_packageStamps = m_packages();
+    }
+
+    m_applets.clear();
+    const QVector<KPluginMetaData> allApplets = m_list();
+    for (const KPluginMetaData &pluginMetaData : allApplets) {
+        if (isNotificationAreaApplet(pluginMetaData)) {
+            m_applets.insert(pluginMetaData.pluginId(), pluginMetaData);
+        }
+    }
+
+    m_scanned = true;
+    m_scanTime = timer.elapsed();
+    qCDebug(SYSTEM_TRAY) << "Found" << m_applets.count() << "notification area applets out of" << allApplets.count() << "in" << m_scanTime << "ms";
+}
+
+void PlasmoidCatalog::updatePackages()
+{
+    if (!m_scanned || !m_packages) {
+        // Nobody asked yet, will be read when somebody does
+        return;
+    }
+
+    const QMap<QString, QString> previous = m_packageStamps;
+    m_packageStamps = m_packages();
+
+    for (auto it = m_packageStamps.constBegin(); it != m_packageStamps.constEnd(); ++it) {
+        if (previous.value(it.key()) != it.value()) {
+            setApplet(it.key(), m_load(it.key()));
+        }
+    }
+    for (auto it = previous.constBegin(); it != previous.constEnd(); ++it) {
+        if (!m_packageStamps.contains(it.key()) && m_applets.remove(it.key())) {
+            Q_EMIT appletRemoved(it.key());
+        }
+    }
+}
+
+void PlasmoidCatalog::setApplet(const QString &pluginId, const KPluginMetaData &pluginMetaData)
+{
+    if (isNotificationAreaApplet(pluginMetaData)) {
+        m_applets.insert(pluginId, pluginMetaData);
+        Q_EMIT appletChanged(pluginId);
+    } else if (m_applets.remove(pluginId)) {
+        Q_EMIT appletRemoved(pluginId);
+    }
+}
+
+void PlasmoidCatalog::updatePackageStamp(const QString &pluginId)
+{
+    if (!m_packages) {
+        return;
+    }
+
+    const QMap<QString, QString> packages = m_packages();
+    auto it = packages.constFind(pluginId);
+    if (it != packages.constEnd()) {
+        m_packageStamps.insert(pluginId, *it);
+    } else {
+        m_packageStamps.remove(pluginId);
+    }
+}
+
+KPluginMetaData PlasmoidCatalog::applet(const QString &pluginId) const
+{
+    return m_applets.value(pluginId);
+}
+
+void PlasmoidCatalog::updatePackage(const QString &pluginId)
+{
+    if (!m_scanned) {
+        // Will be read along with all the others
+        return;
+    }
+
+    KPluginMetaData pluginMetaData = m_load(pluginId);
+    if (!pluginMetaData.isValid()) {
+        // Not a package on its own, e.g. an applet with compiled in metadata
+        const QVector<KPluginMetaData> allApplets = m_list();
+        for (const KPluginMetaData &candidate : allApplets) {
+            if (candidate.pluginId() == pluginId) {
+                pluginMetaData = candidate;
+                break;
+            }
+        }
+    }
+
+    // Not to be read once more when the watcher reports its directory
+    updatePackageStamp(pluginId);
+    setApplet(pluginId, pluginMetaData);
+}
+
+void PlasmoidCatalog::removePackage(const QString &pluginId)
+{
+    if (m_scanned) {
+        updatePackageStamp(pluginId);
+    }
+
+    if (m_applets.remove(pluginId)) {
+        Q_EMIT appletRemoved(pluginId);
+    }
+}
@@ -0,0 +1,91 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QMap>
+#include <QObject>
+#include <QVector>
+
+#include <KPluginMetaData>
+
+#include <functional>
+
+/**
+ * @brief Metadata of the applets which can be shown in the notification area.
+ *
+ * Finding them means reading the metadata of every installed applet. The catalog does
+ * that once per process, so all system trays share the result. Afterwards only the
+ * package which got installed, updated or uninstalled is read again.
+ *
+ * Packages which get installed, replaced or removed without any notification, e.g. by
+ * the distribution's package manager, are found by comparing the entries of the applet
+ * directories, and only those are read again as well.
+ */
+class PlasmoidCatalog : public QObject
+{
+    Q_OBJECT
+public:
+    using ListFunction = std::function<QVector<KPluginMetaData>()>;
+    using LoadFunction = std::function<KPluginMetaData(const QString &pluginId)>;
+    using PackagesFunction = std::function<QMap<QString, QString>()>;
+
+    /**
+     * The catalog of the installed applets, following package changes
+     */
+    static PlasmoidCatalog *self();
+
+    /**
+     * @param list returns the metadata of all applets
+     * @param load returns the metadata of a single applet, or invalid metadata if it
+     * cannot be read on its own
+     * @param packages returns the package directories in the applet directories by plugin id,
+     * each with a stamp which changes along with the directory
+     */
+    PlasmoidCatalog(const ListFunction &list, const LoadFunction &load, const PackagesFunction &packages = {}, QObject *parent = nullptr);
+
+    /**
+     * @return the applets declaring X-Plasma-NotificationArea, by plugin id
+     */
+    QMap<QString, KPluginMetaData> applets();
+    KPluginMetaData applet(const QString &pluginId) const;
+
+public Q_SLOTS:
+    void updatePackage(const QString &pluginId);
+    void removePackage(const QString &pluginId);
+    /**
+     * Reads the packages which were added, replaced or removed in the applet directories
+     * since the catalog last looked, if it was scanned already
+     */
+    void updatePackages();
+
+Q_SIGNALS:
+    /**
+     * Emitted when a notification area applet got installed or updated
+     */
+    void appletChanged(const QString &pluginId);
+    /**
+     * Emitted when an applet got uninstalled or no longer is a notification area applet
+     */
+    void appletRemoved(const QString &pluginId);
+
+private:
+    static bool isNotificationAreaApplet(const KPluginMetaData &pluginMetaData);
+    static QMap<QString, QString> packageDirectories();
+    void scan();
+    void setApplet(const QString &pluginId, const KPluginMetaData &pluginMetaData);
+    // Takes the current stamp of @p pluginId, its package was read just now
+    void updatePackageStamp(const QString &pluginId);
+
+    ListFunction m_list;
+    LoadFunction m_load;
+    PackagesFunction m_packages;
+
+    bool m_scanned = false;
+    qint64 m_scanTime = 0;
+    QMap<QString, QString> m_packageStamps;
+    QMap<QString, KPluginMetaData> m_applets;
+};
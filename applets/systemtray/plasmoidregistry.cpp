@@ -9,12 +9,10 @@
 #include "debug.h"
 
 #include "dbusserviceobserver.h"
+#include "plasmoidcatalog.h"
 #include "systemtraysettings.h"
 
 #include <KPluginMetaData>
-#include <Plasma/PluginLoader>
-
-#include <QDBusConnection>
 
 PlasmoidRegistry::PlasmoidRegistry(QPointer<SystemTraySettings> settings, QObject *parent)
     : QObject(parent)
@@ -27,28 +25,14 @@ PlasmoidRegistry::PlasmoidRegistry(QPointer<SystemTraySettings> settings, QObjec
 
 void PlasmoidRegistry::init()
 {
-    QDBusConnection::sessionBus().connect(QString(),
-                                          QStringLiteral("/KPackage/Plasma/Applet"),
-                                          QStringLiteral("org.kde.plasma.kpackage"),
-                                          QStringLiteral("packageInstalled"),
-                                          this,
-                                          SLOT(packageInstalled(QString)));
-    QDBusConnection::sessionBus().connect(QString(),
-                                          QStringLiteral("/KPackage/Plasma/Applet"),
-                                          QStringLiteral("org.kde.plasma.kpackage"),
-                                          QStringLiteral("packageUpdated"),
-                                          this,
-                                          SLOT(packageInstalled(QString)));
-    QDBusConnection::sessionBus().connect(QString(),
-                                          QStringLiteral("/KPackage/Plasma/Applet"),
-                                          QStringLiteral("org.kde.plasma.kpackage"),
-                                          QStringLiteral("packageUninstalled"),
-                                          this,
-                                          SLOT(packageUninstalled(QString)));
+    PlasmoidCatalog *catalog = PlasmoidCatalog::self();
+    connect(catalog, &PlasmoidCatalog::appletChanged, this, &PlasmoidRegistry::packageInstalled);
+    connect(catalog, &PlasmoidCatalog::appletRemoved, this, &PlasmoidRegistry::packageUninstalled);
 
     connect(m_settings, &SystemTraySettings::enabledPluginsChanged, this, &PlasmoidRegistry::onEnabledPluginsChanged);
 
-    for (const auto &info : Plasma::PluginLoader::self()->listAppletMetaData(QString())) {
+    const auto applets = catalog->applets();
+    for (const auto &info : applets) {
         registerPlugin(info);
     }
 
@@ -94,11 +78,7 @@ void PlasmoidRegistry::packageInstalled(const QString &pluginId)
         return;
     }
 
-    for (const auto &info : Plasma::PluginLoader::self()->listAppletMetaData(QString())) {
-        if (info.pluginId() == pluginId) {
-            registerPlugin(info);
-        }
-    }
+    registerPlugin(PlasmoidCatalog::self()->applet(pluginId));
 }
 
 void PlasmoidRegistry::packageUninstalled(const QString &pluginId)
@@ -13,9 +13,11 @@
 #include <KIconEngine>
 #include <KIconLoader>
 #include <QApplication>
+#include <QCache>
 #include <QDBusMessage>
 #include <QDBusPendingCall>
 #include <QDBusPendingReply>
+#include <QDBusVariant>
 #include <QDebug>
 #include <QIcon>
 #include <QImage>
@@ -28,6 +30,31 @@
 
 #include <dbusmenuimporter.h>
 
+namespace
+{
+struct PixmapKey {
+    int width;
+    int height;
+    QByteArray data;
+
+    bool operator==(const PixmapKey &other) const
+    {
+        return width == other.width && height == other.height && data == other.data;
+    }
+};
+
+uint qHash(const PixmapKey &key, uint seed = 0)
+{
+    return ::qHash(key.data, seed) ^ uint(key.width) ^ (uint(key.height) << 16);
+}
+
+// Decoded icon frames of all items, keyed by their raw data
+using PixmapCache = QCache<PixmapKey, QPixmap>;
+Q_GLOBAL_STATIC_WITH_ARGS(PixmapCache, s_pixmapCache, (8 * 1024 * 1024))
+quint64 s_pixmapCacheHits = 0;
+quint64 s_pixmapCacheMisses = 0;
+}
+
 class PlasmaDBusMenuImporter : public DBusMenuImporter
 {
 public:
@@ -53,6 +80,8 @@ StatusNotifierItemSource::StatusNotifierItemSource(const QString &notifierItemId
     , m_menuImporter(nullptr)
     , m_refreshing(false)
     , m_needsReRefreshing(false)
+    , m_pendingUpdates(AllUpdates)
+    , m_pendingPropertyCalls(0)
 {
     setObjectName(notifierItemId);
     qDBusRegisterMetaType<KDbusImageStruct>();
@@ -79,11 +108,11 @@ StatusNotifierItemSource::StatusNotifierItemSource(const QString &notifierItemId
 
     m_valid = !service.isEmpty() && m_statusNotifierItemInterface->isValid();
     if (m_valid) {
-        connect(m_statusNotifierItemInterface, &OrgKdeStatusNotifierItem::NewTitle, this, &StatusNotifierItemSource::refresh);
-        connect(m_statusNotifierItemInterface, &OrgKdeStatusNotifierItem::NewIcon, this, &StatusNotifierItemSource::refresh);
-        connect(m_statusNotifierItemInterface, &OrgKdeStatusNotifierItem::NewAttentionIcon, this, &StatusNotifierItemSource::refresh);
-        connect(m_statusNotifierItemInterface, &OrgKdeStatusNotifierItem::NewOverlayIcon, this, &StatusNotifierItemSource::refresh);
-        connect(m_statusNotifierItemInterface, &OrgKdeStatusNotifierItem::NewToolTip, this, &StatusNotifierItemSource::refresh);
+        connect(m_statusNotifierItemInterface, &OrgKdeStatusNotifierItem::NewTitle, this, &StatusNotifierItemSource::refreshTitle);
+        connect(m_statusNotifierItemInterface, &OrgKdeStatusNotifierItem::NewIcon, this, &StatusNotifierItemSource::refreshIcons);
+        connect(m_statusNotifierItemInterface, &OrgKdeStatusNotifierItem::NewAttentionIcon, this, &StatusNotifierItemSource::refreshIcons);
+        connect(m_statusNotifierItemInterface, &OrgKdeStatusNotifierItem::NewOverlayIcon, this, &StatusNotifierItemSource::refreshIcons);
+        connect(m_statusNotifierItemInterface, &OrgKdeStatusNotifierItem::NewToolTip, this, &StatusNotifierItemSource::refreshToolTip);
         connect(m_statusNotifierItemInterface, &OrgKdeStatusNotifierItem::NewStatus, this, &StatusNotifierItemSource::syncStatus);
         connect(m_statusNotifierItemInterface, &OrgKdeStatusNotifierItem::NewMenu, this, &StatusNotifierItemSource::refreshMenu);
         refresh();
@@ -185,18 +214,47 @@ Plasma::Service *StatusNotifierItemSource::createService()
     return new StatusNotifierItemService(this);
 }
 
+quint64 StatusNotifierItemSource::pixmapCacheHits()
+{
+    return s_pixmapCacheHits;
+}
+
+quint64 StatusNotifierItemSource::pixmapCacheMisses()
+{
+    return s_pixmapCacheMisses;
+}
+
 void StatusNotifierItemSource::syncStatus(const QString &status)
 {
     m_status = status;
     Q_EMIT dataUpdated();
 }
 
+void StatusNotifierItemSource::refreshTitle()
+{
+    m_pendingUpdates |= TitleUpdate;
+    refresh();
+}
+
+void StatusNotifierItemSource::refreshIcons()
+{
+    m_pendingUpdates |= IconUpdate;
+    refresh();
+}
+
+void StatusNotifierItemSource::refreshToolTip()
+{
+    m_pendingUpdates |= ToolTipUpdate;
+    refresh();
+}
+
 void StatusNotifierItemSource::refreshMenu()
 {
     if (m_menuImporter) {
         m_menuImporter->deleteLater();
         m_menuImporter = nullptr;
     }
+    m_pendingUpdates |= MenuUpdate;
     refresh();
 }
 
@@ -207,6 +265,24 @@ void StatusNotifierItemSource::refresh()
     }
 }
 
+QStringList StatusNotifierItemSource::propertiesFor(Updates updates)
+{
+    // The icons make up most of the item and depend on each other through the overlay and
+    // the theme path, one GetAll is cheaper than getting them one by one
+    if (updates & (IconUpdate | MenuUpdate)) {
+        return {};
+    }
+
+    QStringList properties;
+    if (updates & TitleUpdate) {
+        properties << QStringLiteral("Title");
+    }
+    if (updates & ToolTipUpdate) {
+        properties << QStringLiteral("ToolTip");
+    }
+    return properties;
+}
+
 void StatusNotifierItemSource::performRefresh()
 {
     if (m_refreshing) {
@@ -215,6 +291,40 @@ void StatusNotifierItemSource::performRefresh()
     }
 
     m_refreshing = true;
+    m_requestedUpdates = m_pendingUpdates;
+    m_pendingUpdates = {};
+
+    // NewTitle and NewToolTip only invalidate a single property, don't transfer all the icons again
+    const QStringList properties = propertiesFor(m_requestedUpdates);
+    if (!properties.isEmpty()) {
+        m_receivedProperties.clear();
+        m_pendingPropertyCalls = properties.count();
+
+        for (const QString &property : properties) {
+            QDBusMessage message = QDBusMessage::createMethodCall(m_statusNotifierItemInterface->service(),
+                                                                  m_statusNotifierItemInterface->path(),
+                                                                  QStringLiteral("org.freedesktop.DBus.Properties"),
+                                                                  QStringLiteral("Get"));
+
+            message << m_statusNotifierItemInterface->interface() << property;
+            QDBusPendingCall call = m_statusNotifierItemInterface->connection().asyncCall(message);
+            QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(call, this);
+            connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, property](QDBusPendingCallWatcher *call) {
+                QDBusPendingReply<QDBusVariant> reply = *call;
+                // Like GetAll, leave out what the item does not implement
+                if (!reply.isError()) {
+                    m_receivedProperties.insert(property, reply.value().variant());
+                }
+                call->deleteLater();
+
+                if (--m_pendingPropertyCalls == 0) {
+                    updateProperties(m_receivedProperties, !m_receivedProperties.isEmpty());
+                }
+            });
+        }
+        return;
+    }
+
     QDBusMessage message = QDBusMessage::createMethodCall(m_statusNotifierItemInterface->service(),
                                                           m_statusNotifierItemInterface->path(),
                                                           QStringLiteral("org.freedesktop.DBus.Properties"),
@@ -230,22 +340,42 @@ void StatusNotifierItemSource::performRefresh()
   \todo add a smart pointer to guard call and to automatically delete it at the end of the function
   */
 void StatusNotifierItemSource::refreshCallback(QDBusPendingCallWatcher *call)
+{
+    QDBusPendingReply<QVariantMap> reply = *call;
+    call->deleteLater();
+
+    if (reply.isError()) {
+        updateProperties(QVariantMap(), false);
+    } else {
+        updateProperties(reply.argumentAt<0>(), true);
+    }
+}
+
+void StatusNotifierItemSource::updateProperties(const QVariantMap &properties, bool valid)
 {
     m_refreshing = false;
     if (m_needsReRefreshing) {
         m_needsReRefreshing = false;
+        m_pendingUpdates |= m_requestedUpdates;
         performRefresh();
-        call->deleteLater();
         return;
     }
 
-    QDBusPendingReply<QVariantMap> reply = *call;
-    if (reply.isError()) {
+    // Only a GetAll brings the icons, and everything else
+    const bool fullRefresh = propertiesFor(m_requestedUpdates).isEmpty();
+
+    if (!valid) {
         m_valid = false;
+    } else if (!fullRefresh) {
+        if (m_requestedUpdates & TitleUpdate) {
+            m_title = properties[QStringLiteral("Title")].toString();
+        }
+        if (m_requestedUpdates & ToolTipUpdate) {
+            updateToolTip(properties);
+        }
     } else {
         // IconThemePath (handle this one first, because it has an impact on
         // others)
-        QVariantMap properties = reply.argumentAt<0>();
         QString path = properties[QStringLiteral("IconThemePath")].toString();
 
         if (!path.isEmpty() && path != m_iconThemePath) {
@@ -350,29 +480,7 @@ void StatusNotifierItemSource::refreshCallback(QDBusPendingCallWatcher *call)
         }
 
         // ToolTip
-        {
-            KDbusToolTipStruct toolTip;
-            properties[QStringLiteral("ToolTip")].value<QDBusArgument>() >> toolTip;
-            if (toolTip.title.isEmpty()) {
-                m_toolTipTitle = QString();
-                m_toolTipSubTitle = QString();
-                m_toolTipIcon = QString();
-            } else {
-                QIcon toolTipIcon;
-                if (toolTip.image.size() == 0) {
-                    toolTipIcon = QIcon(new KIconEngine(toolTip.icon, iconLoader()));
-                } else {
-                    toolTipIcon = imageVectorToPixmap(toolTip.image);
-                }
-                m_toolTipTitle = toolTip.title;
-                m_toolTipSubTitle = toolTip.subTitle;
-                if (toolTipIcon.isNull() || toolTipIcon.availableSizes().isEmpty()) {
-                    m_toolTipIcon = QString();
-                } else {
-                    m_toolTipIcon = toolTipIcon;
-                }
-            }
-        }
+        updateToolTip(properties);
 
         // Menu
         if (!m_menuImporter) {
@@ -385,6 +493,8 @@ void StatusNotifierItemSource::refreshCallback(QDBusPendingCallWatcher *call)
                     qWarning() << "DBusMenu disabled for this application";
                 } else {
                     m_menuImporter = new PlasmaDBusMenuImporter(m_statusNotifierItemInterface->service(), menuObjectPath, iconLoader(), this);
+                    // The importer lives as long as the item, reopening the context menu needs no round trip
+                    m_menuImporter->setLayoutCacheEnabled(true);
                     connect(m_menuImporter, &PlasmaDBusMenuImporter::menuUpdated, this, [this](QMenu *menu) {
                         if (menu == m_menuImporter->menu()) {
                             contextMenuReady();
@@ -396,7 +506,31 @@ void StatusNotifierItemSource::refreshCallback(QDBusPendingCallWatcher *call)
     }
 
     Q_EMIT dataUpdated();
-    call->deleteLater();
+}
+
+void StatusNotifierItemSource::updateToolTip(const QVariantMap &properties)
+{
+    KDbusToolTipStruct toolTip;
+    properties[QStringLiteral("ToolTip")].value<QDBusArgument>() >> toolTip;
+    if (toolTip.title.isEmpty()) {
+        m_toolTipTitle = QString();
+        m_toolTipSubTitle = QString();
+        m_toolTipIcon = QString();
+    } else {
+        QIcon toolTipIcon;
+        if (toolTip.image.size() == 0) {
+            toolTipIcon = QIcon(new KIconEngine(toolTip.icon, iconLoader()));
+        } else {
+            toolTipIcon = imageVectorToPixmap(toolTip.image);
+        }
+        m_toolTipTitle = toolTip.title;
+        m_toolTipSubTitle = toolTip.subTitle;
+        if (toolTipIcon.isNull() || toolTipIcon.availableSizes().isEmpty()) {
+            m_toolTipIcon = QString();
+        } else {
+            m_toolTipIcon = toolTipIcon;
+        }
+    }
 }
 
 void StatusNotifierItemSource::contextMenuReady()
@@ -406,22 +540,31 @@ void StatusNotifierItemSource::contextMenuReady()
 
 QPixmap StatusNotifierItemSource::KDbusImageStructToPixmap(const KDbusImageStruct &image) const
 {
+    if (image.width == 0 || image.height == 0) {
+        return QPixmap();
+    }
+
+    // Animated icons cycle through the same few frames, convert each of them only once
+    const PixmapKey key{image.width, image.height, image.data};
+    if (const QPixmap *pixmap = s_pixmapCache->object(key)) {
+        ++s_pixmapCacheHits;
+        return *pixmap;
+    }
+    ++s_pixmapCacheMisses;
+
+    // The raw data is kept as cache key, convert a copy of it.
+    // We need to keep a reference to the data alive for the lifespan of the image, even if the image is copied,
+    // so we create it on the heap and delete it in the QImage cleanup
+    auto dataRef = new QByteArray(image.data.constData(), image.data.size());
+
     // swap from network byte order if we are little endian
     if (QSysInfo::ByteOrder == QSysInfo::LittleEndian) {
-        uint *uintBuf = (uint *)image.data.data();
-        for (uint i = 0; i < image.data.size() / sizeof(uint); ++i) {
+        uint *uintBuf = reinterpret_cast<uint *>(dataRef->data());
+        for (uint i = 0; i < dataRef->size() / sizeof(uint); ++i) {
             *uintBuf = ntohl(*uintBuf);
             ++uintBuf;
         }
     }
-    if (image.width == 0 || image.height == 0) {
-        return QPixmap();
-    }
-
-    // avoid a deep copy of the image data
-    // we need to keep a reference to the image.data alive for the lifespan of the image, even if the image is copied
-    // we create a new QByteArray with a shallow copy of the original data on the heap, then delete this in the QImage cleanup
-    auto dataRef = new QByteArray(image.data);
 
     QImage iconImage(
         reinterpret_cast<const uchar *>(dataRef->data()),
@@ -432,7 +575,12 @@ QPixmap StatusNotifierItemSource::KDbusImageStructToPixmap(const KDbusImageStruc
             delete static_cast<QByteArray *>(ptr);
         },
         dataRef);
-    return QPixmap::fromImage(iconImage);
+    const QPixmap pixmap = QPixmap::fromImage(iconImage);
+
+    // Accounts for the pixmap and the key, which are about the same size
+    s_pixmapCache->insert(key, new QPixmap(pixmap), 2 * image.data.size());
+
+    return pixmap;
 }
 
 QIcon StatusNotifierItemSource::imageVectorToPixmap(const KDbusImageVector &vector) const
@@ -49,6 +49,12 @@ public:
     QString toolTipTitle() const;
     QString windowId() const;
 
+    /**
+     * Icon frames served from, respectively converted for, the pixmap cache shared by all items
+     */
+    static quint64 pixmapCacheHits();
+    static quint64 pixmapCacheMisses();
+
 Q_SIGNALS:
     void contextMenuReady(QMenu *menu);
     void activateResult(bool success);
@@ -56,6 +62,9 @@ Q_SIGNALS:
 
 private Q_SLOTS:
     void contextMenuReady();
+    void refreshTitle();
+    void refreshIcons();
+    void refreshToolTip();
     void refreshMenu();
     void refresh();
     void performRefresh();
@@ -64,6 +73,20 @@ private Q_SLOTS:
     void activateCallback(QDBusPendingCallWatcher *);
 
 private:
+    enum Update {
+        TitleUpdate = 0x1,
+        IconUpdate = 0x2,
+        ToolTipUpdate = 0x4,
+        MenuUpdate = 0x8,
+        AllUpdates = TitleUpdate | IconUpdate | ToolTipUpdate | MenuUpdate,
+    };
+    Q_DECLARE_FLAGS(Updates, Update)
+
+    // Properties to fetch for @p updates, empty if all of them are needed
+    static QStringList propertiesFor(Updates updates);
+    void updateProperties(const QVariantMap &properties, bool valid);
+    void updateToolTip(const QVariantMap &properties);
+
     QPixmap KDbusImageStructToPixmap(const KDbusImageStruct &image) const;
     QIcon imageVectorToPixmap(const KDbusImageVector &vector) const;
     void overlayIcon(QIcon *icon, QIcon *overlay);
@@ -77,6 +100,10 @@ private:
     org::kde::StatusNotifierItem *m_statusNotifierItemInterface;
     bool m_refreshing : 1;
     bool m_needsReRefreshing : 1;
+    Updates m_pendingUpdates;
+    Updates m_requestedUpdates;
+    QVariantMap m_receivedProperties;
+    int m_pendingPropertyCalls;
 
     QIcon m_attentionIcon;
     QString m_attentionIconName;
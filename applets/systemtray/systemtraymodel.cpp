@@ -221,6 +221,7 @@ void PlasmoidModel::appendRow(const KPluginMetaData &pluginMetaData)
     PlasmoidModel::Item item;
     item.pluginMetaData = pluginMetaData;
     m_items.append(item);
+    m_rows.insert(pluginMetaData.pluginId(), idx);
 
     endInsertRows();
 }
@@ -228,19 +229,22 @@ void PlasmoidModel::appendRow(const KPluginMetaData &pluginMetaData)
 void PlasmoidModel::removeRow(const QString &pluginId)
 {
     int idx = indexOfPluginId(pluginId);
+    if (idx < 0) {
+        return;
+    }
+
     beginRemoveRows(QModelIndex(), idx, idx);
     m_items.removeAt(idx);
+    m_rows.remove(pluginId);
+    for (int i = idx; i < m_items.size(); ++i) {
+        m_rows[m_items[i].pluginMetaData.pluginId()] = i;
+    }
     endRemoveRows();
 }
 
 int PlasmoidModel::indexOfPluginId(const QString &pluginId) const
 {
-    for (int i = 0; i < rowCount(); i++) {
-        if (m_items[i].pluginMetaData.pluginId() == pluginId) {
-            return i;
-        }
-    }
-    return -1;
+    return m_rows.value(pluginId, -1);
 }
 
 StatusNotifierModel::StatusNotifierModel(QPointer<SystemTraySettings> settings, QObject *parent)
@@ -296,7 +300,7 @@ QVariant StatusNotifierModel::data(const QModelIndex &index, int role) const
         return QVariant();
     }
 
-    StatusNotifierModel::Item item = m_items[index.row()];
+    const StatusNotifierModel::Item &item = m_items[index.row()];
     StatusNotifierItemSource *sniData = m_sniHost->itemForService(item.source);
 
     const QString itemId = extractItemId(sniData);
@@ -417,6 +421,7 @@ void StatusNotifierModel::addSource(const QString &source)
     });
     item.service = sni->createService();
     m_items.append(item);
+    m_rows.insert(source, count);
     endInsertRows();
 }
 
@@ -427,6 +432,10 @@ void StatusNotifierModel::removeSource(const QString &source)
         beginRemoveRows(QModelIndex(), idx, idx);
         delete m_items[idx].service;
         m_items.removeAt(idx);
+        m_rows.remove(source);
+        for (int i = idx; i < m_items.size(); ++i) {
+            m_rows[m_items[i].source] = i;
+        }
         endRemoveRows();
     }
 }
@@ -442,12 +451,7 @@ void StatusNotifierModel::dataUpdated(const QString &sourceName)
 
 int StatusNotifierModel::indexOfSource(const QString &source) const
 {
-    for (int i = 0; i < rowCount(); i++) {
-        if (m_items[i].source == source) {
-            return i;
-        }
-    }
-    return -1;
+    return m_rows.value(source, -1);
 }
 
 SystemTrayModel::SystemTrayModel(QObject *parent)
@@ -98,6 +98,8 @@ private:
     QPointer<PlasmoidRegistry> m_plasmoidRegistry;
 
     QVector<Item> m_items;
+    // Row of each plugin id, kept in sync with m_items
+    QHash<QString, int> m_rows;
 };
 
 /**
@@ -147,11 +149,16 @@ public:
 
     StatusNotifierItemHost *m_sniHost = nullptr;
     QVector<Item> m_items;
+    // Row of each source, kept in sync with m_items
+    QHash<QString, int> m_rows;
 };
 Q_DECLARE_TYPEINFO(StatusNotifierModel::Item, Q_MOVABLE_TYPE);
 
 /**
  * @brief Cantenating model for system tray, that can expose multiple data models as one.
+ *
+ * Mapping between the source models and this one only walks the list of source models,
+ * of which there are two, so item lookups cost the same as in the source models.
  */
 class SystemTrayModel : public QConcatenateTablesProxyModel
 {
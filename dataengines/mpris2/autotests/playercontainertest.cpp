@@ -0,0 +1,292 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include <QDBusAbstractAdaptor>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusObjectPath>
+#include <QElapsedTimer>
+#include <QProcess>
+#include <QSignalSpy>
+#include <QTest>
+
+#include "playercontainer.h"
+
+static const QString s_serviceName = QStringLiteral("org.mpris.MediaPlayer2.fakeplayer");
+static const QString s_path = QStringLiteral("/org/mpris/MediaPlayer2");
+static const QString s_playerInterface = QStringLiteral("org.mpris.MediaPlayer2.Player");
+
+// Positions are in microseconds, the container may be off by the time a signal takes to arrive
+static const qint64 s_tolerance = 50 * 1000;
+static const qint64 s_length = 600 * 1000 * 1000;
+
+// A player which keeps playing on its own, like a real one does
+class FakePlayer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FakePlayer(const QDBusConnection &connection)
+        : m_connection(connection)
+    {
+        m_timer.start();
+    }
+
+    QString playbackStatus() const
+    {
+        return m_status;
+    }
+
+    double rate() const
+    {
+        return m_rate;
+    }
+
+    qint64 position() const
+    {
+        if (m_status != QLatin1String("Playing")) {
+            return m_position;
+        }
+        return m_position + static_cast<qint64>(m_timer.nsecsElapsed() / 1000 * m_rate);
+    }
+
+    void setPlaybackStatus(const QString &status)
+    {
+        rebase();
+        m_status = status;
+        if (status == QLatin1String("Stopped")) {
+            m_position = 0;
+        }
+        propertiesChanged({{QStringLiteral("PlaybackStatus"), status}});
+    }
+
+    void setRate(double rate)
+    {
+        rebase();
+        m_rate = rate;
+        propertiesChanged({{QStringLiteral("Rate"), rate}});
+    }
+
+    void seek(qint64 position)
+    {
+        m_position = position;
+        m_timer.start();
+        m_connection.send(QDBusMessage::createSignal(s_path, s_playerInterface, QStringLiteral("Seeked")) << position);
+    }
+
+    // Every time a client asked for the position
+    int positionReads = 0;
+
+private:
+    void rebase()
+    {
+        m_position = position();
+        m_timer.start();
+    }
+
+    void propertiesChanged(const QVariantMap &properties)
+    {
+        QDBusMessage message = QDBusMessage::createSignal(s_path, QStringLiteral("org.freedesktop.DBus.Properties"), QStringLiteral("PropertiesChanged"));
+        message << s_playerInterface << properties << QStringList();
+        m_connection.send(message);
+    }
+
+    QDBusConnection m_connection;
+    QString m_status = QStringLiteral("Playing");
+    double m_rate = 1.0;
+    qint64 m_position = 10 * 1000 * 1000;
+    QElapsedTimer m_timer;
+};
+
+class FakeRootAdaptor : public QDBusAbstractAdaptor
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.mpris.MediaPlayer2")
+    Q_PROPERTY(QString Identity READ identity)
+    Q_PROPERTY(QStringList SupportedUriSchemes READ supported)
+    Q_PROPERTY(QStringList SupportedMimeTypes READ supported)
+
+public:
+    using QDBusAbstractAdaptor::QDBusAbstractAdaptor;
+
+    QString identity() const
+    {
+        return QStringLiteral("Fake Player");
+    }
+
+    QStringList supported() const
+    {
+        return {};
+    }
+};
+
+class FakePlayerAdaptor : public QDBusAbstractAdaptor
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.mpris.MediaPlayer2.Player")
+    Q_PROPERTY(QString PlaybackStatus READ playbackStatus)
+    Q_PROPERTY(double Rate READ rate)
+    Q_PROPERTY(qlonglong Position READ position)
+    Q_PROPERTY(QVariantMap Metadata READ metadata)
+    Q_PROPERTY(bool CanControl READ yes)
+    Q_PROPERTY(bool CanSeek READ yes)
+
+public:
+    explicit FakePlayerAdaptor(FakePlayer *player)
+        : QDBusAbstractAdaptor(player)
+        , m_player(player)
+    {
+    }
+
+    QString playbackStatus() const
+    {
+        return m_player->playbackStatus();
+    }
+
+    double rate() const
+    {
+        return m_player->rate();
+    }
+
+    qlonglong position() const
+    {
+        ++m_player->positionReads;
+        return m_player->position();
+    }
+
+    QVariantMap metadata() const
+    {
+        return {{QStringLiteral("mpris:trackid"), QVariant::fromValue(QDBusObjectPath(QStringLiteral("/org/kde/fakeplayer/track/1")))},
+                {QStringLiteral("mpris:length"), s_length}};
+    }
+
+    bool yes() const
+    {
+        return true;
+    }
+
+private:
+    FakePlayer *m_player;
+};
+
+class PlayerContainerTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void testPlaying();
+    void testRate();
+    void testSeeked();
+    void testPaused();
+    void testStopped();
+
+private:
+    qint64 difference() const;
+
+    QProcess m_bus;
+    FakePlayer *m_player = nullptr;
+    PlayerContainer *m_container = nullptr;
+};
+
+qint64 PlayerContainerTest::difference() const
+{
+    return qAbs(m_container->position() - m_player->position());
+}
+
+void PlayerContainerTest::initTestCase()
+{
+    // Everything talks over a private bus, the container only knows about the session bus
+    m_bus.start(QStringLiteral("dbus-daemon"), {QStringLiteral("--session"), QStringLiteral("--nofork"), QStringLiteral("--print-address")});
+    if (!m_bus.waitForStarted() || !m_bus.waitForReadyRead()) {
+        QSKIP("Cannot run dbus-daemon");
+    }
+    qputenv("DBUS_SESSION_BUS_ADDRESS", m_bus.readLine().trimmed());
+    QVERIFY(QDBusConnection::sessionBus().isConnected());
+
+    QDBusConnection player = QDBusConnection::connectToBus(QDBusConnection::SessionBus, QStringLiteral("player"));
+    m_player = new FakePlayer(player);
+    new FakeRootAdaptor(m_player);
+    new FakePlayerAdaptor(m_player);
+    QVERIFY(player.registerObject(s_path, m_player, QDBusConnection::ExportAdaptors));
+    QVERIFY(player.registerService(s_serviceName));
+
+    m_container = new PlayerContainer(s_serviceName);
+    QSignalSpy fetchSpy(m_container, &PlayerContainer::initialFetchFinished);
+    QVERIFY(fetchSpy.wait());
+}
+
+void PlayerContainerTest::cleanupTestCase()
+{
+    delete m_container;
+    delete m_player;
+    QDBusConnection::disconnectFromBus(QStringLiteral("player"));
+    m_bus.terminate();
+    m_bus.waitForFinished();
+}
+
+void PlayerContainerTest::testPlaying()
+{
+    const int reads = m_player->positionReads;
+
+    QTest::qWait(500);
+    QVERIFY2(difference() < s_tolerance, qPrintable(QString::number(difference())));
+    QVERIFY(m_container->position() > 10 * 1000 * 1000);
+
+    // Publishing the position does not ask the player either
+    m_container->updatePosition();
+    QVERIFY(qAbs(m_container->data().value(QStringLiteral("Position")).toLongLong() - m_player->position()) < s_tolerance);
+    QCOMPARE(m_player->positionReads, reads);
+}
+
+void PlayerContainerTest::testRate()
+{
+    m_player->setRate(2.0);
+    QTRY_COMPARE(m_container->data().value(QStringLiteral("Rate")).toDouble(), 2.0);
+
+    QTest::qWait(500);
+    QVERIFY2(difference() < s_tolerance, qPrintable(QString::number(difference())));
+}
+
+void PlayerContainerTest::testSeeked()
+{
+    m_player->seek(60 * 1000 * 1000);
+    QTRY_VERIFY(m_container->position() >= 60 * 1000 * 1000);
+
+    QTest::qWait(500);
+    QVERIFY2(difference() < s_tolerance, qPrintable(QString::number(difference())));
+}
+
+void PlayerContainerTest::testPaused()
+{
+    m_player->setPlaybackStatus(QStringLiteral("Paused"));
+    QTRY_COMPARE(m_container->data().value(QStringLiteral("PlaybackStatus")).toString(), QStringLiteral("Paused"));
+
+    // The container asks where exactly the player paused
+    QTRY_COMPARE(m_container->position(), m_player->position());
+    QTest::qWait(200);
+    QCOMPARE(m_container->position(), m_player->position());
+
+    m_player->setPlaybackStatus(QStringLiteral("Playing"));
+    QTRY_COMPARE(m_container->data().value(QStringLiteral("PlaybackStatus")).toString(), QStringLiteral("Playing"));
+    QTest::qWait(500);
+    QVERIFY2(difference() < s_tolerance, qPrintable(QString::number(difference())));
+}
+
+void PlayerContainerTest::testStopped()
+{
+    m_player->setPlaybackStatus(QStringLiteral("Stopped"));
+    QTRY_COMPARE(m_container->data().value(QStringLiteral("PlaybackStatus")).toString(), QStringLiteral("Stopped"));
+
+    QCOMPARE(m_container->position(), qint64(0));
+    QTest::qWait(200);
+    QCOMPARE(m_container->position(), qint64(0));
+}
+
+QTEST_GUILESS_MAIN(PlayerContainerTest)
+
+#include "playercontainertest.moc"
@@ -84,7 +84,9 @@ bool Mpris2Engine::updateSourceEvent(const QString &source)
     } else {
         PlayerContainer *container = qobject_cast<PlayerContainer *>(containerForSource(source));
         if (container) {
-            container->refresh();
+            // everything but the position is kept up to date by PropertiesChanged,
+            // and the position can be told without asking the player
+            container->updatePosition();
             return true;
         } else {
             return false;
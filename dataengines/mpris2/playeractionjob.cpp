@@ -123,6 +123,8 @@ void PlayerActionJob::start()
         emitResult();
     } else if (operation == QLatin1String("GetPosition")) {
         m_controller->updatePosition();
+        setError(NoError);
+        emitResult();
     } else {
         setError(UnknownOperation);
         emitResult();
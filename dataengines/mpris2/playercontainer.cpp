@@ -100,6 +100,7 @@ PlayerContainer::PlayerContainer(const QString &busAddress, QObject *parent)
     , m_fetchesPending(0)
     , m_dbusAddress(busAddress)
     , m_currentRate(0.0)
+    , m_position(0)
 {
     Q_ASSERT(!busAddress.isEmpty());
     Q_ASSERT(busAddress.startsWith(QLatin1String("org.mpris.MediaPlayer2.")));
@@ -201,15 +202,14 @@ void PlayerContainer::copyProperty(const QString &propName, const QVariant &_val
     }
     if (value.convert(expType)) {
         if (propName == QLatin1String("Position")) {
-            setData(POS_UPD_STRING, QDateTime::currentDateTimeUtc());
+            setPosition(value.toLongLong());
 
         } else if (propName == QLatin1String("Metadata")) {
             if (updType == UpdatedSignal) {
                 const QString oldTrackId = data().value(QStringLiteral("Metadata")).toMap().value(QStringLiteral("mpris:trackid")).toString();
                 const QString newTrackId = value.toMap().value(QStringLiteral("mpris:trackid")).toString();
                 if (oldTrackId != newTrackId) {
-                    setData(QStringLiteral("Position"), static_cast<qlonglong>(0));
-                    setData(POS_UPD_STRING, QDateTime::currentDateTimeUtc());
+                    setPosition(0);
                 }
             }
 
@@ -220,27 +220,31 @@ void PlayerContainer::copyProperty(const QString &propName, const QVariant &_val
             }
 
         } else if (propName == QLatin1String("Rate") && data().value(QStringLiteral("PlaybackStatus")).toString() == QLatin1String("Playing")) {
+            // the position up to now was reached with the old rate
             if (data().contains(QLatin1String("Position")))
-                recalculatePosition();
+                setPosition(position());
             m_currentRate = value.toDouble();
 
         } else if (propName == QLatin1String("PlaybackStatus")) {
-            if (data().contains(QLatin1String("Position")) && data().contains(QLatin1String("PlaybackStatus"))) {
-                updatePosition();
+            if (data().contains(QLatin1String("Position"))) {
+                setPosition(position());
+                // the signal arrives some time after the player changed its state,
+                // so ask for where it really stopped or started
+                if (data().contains(QLatin1String("PlaybackStatus")) && value.toString() != QLatin1String("Stopped")) {
+                    syncPosition();
+                }
             }
 
-            // update the effective rate
-            if (data().contains(QLatin1String("Rate"))) {
-                if (value.toString() == QLatin1String("Playing"))
-                    m_currentRate = data().value(QStringLiteral("Rate")).toDouble();
-                else
-                    m_currentRate = 0.0;
-            }
+            // update the effective rate, players which do not export Rate play at normal speed
+            if (value.toString() == QLatin1String("Playing"))
+                m_currentRate = data().value(QStringLiteral("Rate"), 1.0).toDouble();
+            else
+                m_currentRate = 0.0;
+
             if (value.toString() == QLatin1String("Stopped")) {
                 // assume the position has reset to 0, since this is really the
                 // only sensible value for a stopped track
-                setData(QStringLiteral("Position"), static_cast<qint64>(0));
-                setData(POS_UPD_STRING, QDateTime::currentDateTimeUtc());
+                setPosition(0);
             }
         } else if (propName == QLatin1String("DesktopEntry")) {
             QString filename = value.toString() + QLatin1String(".desktop");
@@ -319,7 +323,35 @@ void PlayerContainer::getPropsFinished(QDBusPendingCallWatcher *watcher)
     }
 }
 
+qint64 PlayerContainer::position() const
+{
+    if (!m_positionTimer.isValid() || m_currentRate == 0.0) {
+        return m_position;
+    }
+
+    qint64 position = m_position + static_cast<qint64>(m_positionTimer.nsecsElapsed() / 1000 * m_currentRate);
+    const qint64 length = data().value(QStringLiteral("Metadata")).toMap().value(QStringLiteral("mpris:length")).toLongLong();
+    if (length > 0) {
+        position = qMin(position, length);
+    }
+    return qMax<qint64>(position, 0);
+}
+
+void PlayerContainer::setPosition(qint64 position)
+{
+    m_position = position;
+    m_positionTimer.start();
+    setData(QStringLiteral("Position"), position);
+    setData(POS_UPD_STRING, QDateTime::currentDateTimeUtc());
+}
+
 void PlayerContainer::updatePosition()
+{
+    setPosition(position());
+    checkForUpdate();
+}
+
+void PlayerContainer::syncPosition()
 {
     QDBusPendingCall async = m_propsIface->Get(OrgMprisMediaPlayer2PlayerInterface::staticInterfaceName(), QStringLiteral("Position"));
     QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(async, this);
@@ -337,8 +369,7 @@ void PlayerContainer::getPositionFinished(QDBusPendingCallWatcher *watcher)
         return;
     }
 
-    setData(QStringLiteral("Position"), propsReply.value().toLongLong());
-    setData(POS_UPD_STRING, QDateTime::currentDateTimeUtc());
+    setPosition(propsReply.value().toLongLong());
     checkForUpdate();
 }
 
@@ -355,20 +386,6 @@ void PlayerContainer::propertiesChanged(const QString &interface, const QVariant
 
 void PlayerContainer::seeked(qlonglong position)
 {
-    setData(QStringLiteral("Position"), position);
-    setData(POS_UPD_STRING, QDateTime::currentDateTimeUtc());
+    setPosition(position);
     checkForUpdate();
 }
-
-void PlayerContainer::recalculatePosition()
-{
-    Q_ASSERT(data().contains("Position"));
-
-    qint64 pos = data().value(QStringLiteral("Position")).toLongLong();
-    QDateTime lastUpdated = data().value(POS_UPD_STRING).toDateTime();
-    QDateTime now = QDateTime::currentDateTimeUtc();
-    qint64 diff = lastUpdated.msecsTo(now) * 1000;
-    qint64 newPos = pos + static_cast<qint64>(diff * m_currentRate);
-    setData(QStringLiteral("Position"), newPos);
-    setData(POS_UPD_STRING, now);
-}
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <Plasma/DataContainer>
+#include <QElapsedTimer>
 #include <QFlags>
 
 class OrgFreedesktopDBusPropertiesInterface;
@@ -65,6 +66,19 @@ public:
     };
 
     void refresh();
+
+    /**
+     * The current position in microseconds, extrapolated from the last position
+     * the player reported and the effective playback rate since then.
+     *
+     * This neither talks to the player nor needs a timer; the position is only
+     * synchronized with the player on Seeked, PlaybackStatus and Rate changes.
+     */
+    qint64 position() const;
+
+    /**
+     * Publishes the extrapolated position as the "Position" entry.
+     */
     void updatePosition();
 
 Q_SIGNALS:
@@ -81,7 +95,8 @@ private Q_SLOTS:
 private:
     void copyProperty(const QString &propName, const QVariant &value, QVariant::Type expType, UpdateType updType);
     void updateFromMap(const QVariantMap &map, UpdateType updType);
-    void recalculatePosition();
+    void setPosition(qint64 position);
+    void syncPosition();
 
     Caps m_caps;
     int m_fetchesPending;
@@ -90,6 +105,8 @@ private:
     OrgMprisMediaPlayer2Interface *m_rootIface;
     OrgMprisMediaPlayer2PlayerInterface *m_playerIface;
     double m_currentRate;
+    qint64 m_position;
+    QElapsedTimer m_positionTimer;
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(PlayerContainer::Caps)
@@ -0,0 +1,286 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-only
+*/
+
+#include <QCoreApplication>
+#include <QMutex>
+#include <QSignalSpy>
+#include <QTest>
+#include <QThread>
+#include <QThreadPool>
+
+#include "freespacescheduler.h"
+
+static const quint64 s_size = 100ull * 1024 * 1024 * 1024;
+
+// File systems as statvfs would see them, queried from the worker threads
+class FakeFileSystems
+{
+public:
+    struct FileSystem {
+        quint64 available = s_size / 2;
+        // taken from the available space on every query
+        quint64 consumption = 0;
+        int delay = 0;
+        int queries = 0;
+        bool guiThread = false;
+    };
+
+    FreeSpaceScheduler::StatFunction stat()
+    {
+        return [this](const QString &path) {
+            QMutexLocker locker(&m_mutex);
+            FileSystem &fileSystem = m_fileSystems[path];
+            ++fileSystem.queries;
+            fileSystem.guiThread |= QThread::currentThread() == qApp->thread();
+            fileSystem.available -= qMin(fileSystem.available, fileSystem.consumption);
+            const FreeSpaceScheduler::Usage usage{true, s_size, fileSystem.available};
+            const int delay = fileSystem.delay;
+            locker.unlock();
+
+            QThread::msleep(delay);
+            return usage;
+        };
+    }
+
+    FileSystem fileSystem(const QString &path)
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_fileSystems.value(path);
+    }
+
+    void setConsumption(const QString &path, quint64 consumption)
+    {
+        QMutexLocker locker(&m_mutex);
+        m_fileSystems[path].consumption = consumption;
+    }
+
+    void setDelay(const QString &path, int delay)
+    {
+        QMutexLocker locker(&m_mutex);
+        m_fileSystems[path].delay = delay;
+    }
+
+private:
+    QMutex m_mutex;
+    QHash<QString, FileSystem> m_fileSystems;
+};
+
+class FreeSpaceSchedulerTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init();
+    void cleanup();
+    void testFirstQuery();
+    void testIdleBackoff();
+    void testFillingUp();
+    void testSlowMount();
+    void testNotResponding();
+    void testUnwatch();
+    void testHangingMount();
+    void testHangingShares();
+    void testStuckWorkers();
+
+private:
+    FakeFileSystems *m_fileSystems = nullptr;
+    FreeSpaceScheduler *m_scheduler = nullptr;
+};
+
+void FreeSpaceSchedulerTest::init()
+{
+    m_fileSystems = new FakeFileSystems;
+    m_scheduler = new FreeSpaceScheduler(m_fileSystems->stat());
+    // the defaults scaled down from seconds to tens of milliseconds
+    m_scheduler->setIntervals(20, 100, 400);
+    m_scheduler->setTimeBudget(50);
+    m_scheduler->setNotRespondingTimeout(300);
+}
+
+void FreeSpaceSchedulerTest::cleanup()
+{
+    // workers may still be stuck on a slow file system
+    m_scheduler->threadPool()->waitForDone();
+    delete m_scheduler;
+    delete m_fileSystems;
+}
+
+void FreeSpaceSchedulerTest::testFirstQuery()
+{
+    QSignalSpy usageSpy(m_scheduler, &FreeSpaceScheduler::usageChanged);
+    m_scheduler->watch(QStringLiteral("/dev/sda1"), QStringLiteral("/"));
+    m_scheduler->watch(QStringLiteral("/dev/sda2"), QStringLiteral("/home"));
+
+    QTRY_COMPARE(usageSpy.count(), 2);
+    for (const QList<QVariant> &arguments : qAsConst(usageSpy)) {
+        QCOMPARE(arguments.at(1).toULongLong(), s_size);
+        QCOMPARE(arguments.at(2).toULongLong(), s_size / 2);
+    }
+    QVERIFY(!m_fileSystems->fileSystem(QStringLiteral("/")).guiThread);
+    QVERIFY(!m_fileSystems->fileSystem(QStringLiteral("/home")).guiThread);
+
+    // watching again asks again right away, but reports only changes
+    m_scheduler->watch(QStringLiteral("/dev/sda1"), QStringLiteral("/"));
+    QTRY_COMPARE(m_fileSystems->fileSystem(QStringLiteral("/")).queries, 2);
+    QCOMPARE(m_fileSystems->fileSystem(QStringLiteral("/home")).queries, 1);
+    QCOMPARE(usageSpy.count(), 2);
+}
+
+void FreeSpaceSchedulerTest::testIdleBackoff()
+{
+    QSignalSpy usageSpy(m_scheduler, &FreeSpaceScheduler::usageChanged);
+    m_scheduler->watch(QStringLiteral("/dev/sda1"), QStringLiteral("/"));
+    QTRY_COMPARE(usageSpy.count(), 1);
+    QCOMPARE(m_scheduler->interval(QStringLiteral("/dev/sda1")), 100);
+
+    // nothing changes: 200, then 400 at most
+    QTRY_COMPARE(m_scheduler->interval(QStringLiteral("/dev/sda1")), 200);
+    QTRY_COMPARE(m_scheduler->interval(QStringLiteral("/dev/sda1")), 400);
+    const int queries = m_fileSystems->fileSystem(QStringLiteral("/")).queries;
+    QTest::qWait(500);
+    QVERIFY(m_fileSystems->fileSystem(QStringLiteral("/")).queries - queries <= 2);
+    QCOMPARE(m_scheduler->interval(QStringLiteral("/dev/sda1")), 400);
+    QCOMPARE(usageSpy.count(), 1);
+}
+
+void FreeSpaceSchedulerTest::testFillingUp()
+{
+    QSignalSpy usageSpy(m_scheduler, &FreeSpaceScheduler::usageChanged);
+    m_scheduler->watch(QStringLiteral("/dev/sda1"), QStringLiteral("/"));
+    QTRY_COMPARE(usageSpy.count(), 1);
+
+    // a gigabyte goes away every time, at that pace it is full within a second
+    m_fileSystems->setConsumption(QStringLiteral("/"), s_size / 100);
+    QTRY_COMPARE(m_scheduler->interval(QStringLiteral("/dev/sda1")), 20);
+    QVERIFY(usageSpy.count() > 1);
+
+    // and it calms down again once the space stops going away
+    m_fileSystems->setConsumption(QStringLiteral("/"), 0);
+    QTRY_COMPARE(m_scheduler->interval(QStringLiteral("/dev/sda1")), 400);
+}
+
+void FreeSpaceSchedulerTest::testSlowMount()
+{
+    QSignalSpy usageSpy(m_scheduler, &FreeSpaceScheduler::usageChanged);
+    m_fileSystems->setDelay(QStringLiteral("/mnt/nfs"), 100);
+    m_fileSystems->setConsumption(QStringLiteral("/"), s_size / 1000);
+    m_scheduler->watch(QStringLiteral("/dev/sda1"), QStringLiteral("/"));
+    m_scheduler->watch(QStringLiteral("nfs"), QStringLiteral("/mnt/nfs"));
+
+    QTRY_VERIFY(m_scheduler->isSlow(QStringLiteral("nfs")));
+    QCOMPARE(m_scheduler->interval(QStringLiteral("nfs")), 400);
+    QVERIFY(!m_scheduler->isSlow(QStringLiteral("/dev/sda1")));
+
+    // the share stops answering, the local file system keeps being followed
+    m_fileSystems->setDelay(QStringLiteral("/mnt/nfs"), 2000);
+    QTest::qWait(600);
+    const int queries = m_fileSystems->fileSystem(QStringLiteral("/mnt/nfs")).queries;
+    usageSpy.clear();
+    QTRY_VERIFY(usageSpy.count() > 3);
+    for (const QList<QVariant> &arguments : qAsConst(usageSpy)) {
+        QCOMPARE(arguments.at(0).toString(), QStringLiteral("/dev/sda1"));
+    }
+    QVERIFY(m_fileSystems->fileSystem(QStringLiteral("/mnt/nfs")).queries - queries <= 1);
+}
+
+void FreeSpaceSchedulerTest::testNotResponding()
+{
+    QSignalSpy notRespondingSpy(m_scheduler, &FreeSpaceScheduler::notResponding);
+    m_fileSystems->setDelay(QStringLiteral("/mnt/nfs"), 600);
+    m_scheduler->watch(QStringLiteral("/dev/sda1"), QStringLiteral("/"));
+    m_scheduler->watch(QStringLiteral("nfs"), QStringLiteral("/mnt/nfs"));
+
+    QVERIFY(notRespondingSpy.wait());
+    QCOMPARE(notRespondingSpy.count(), 1);
+    QCOMPARE(notRespondingSpy.first().at(0).toString(), QStringLiteral("/mnt/nfs"));
+    QVERIFY(m_scheduler->isSlow(QStringLiteral("nfs")));
+}
+
+void FreeSpaceSchedulerTest::testUnwatch()
+{
+    QSignalSpy usageSpy(m_scheduler, &FreeSpaceScheduler::usageChanged);
+    m_fileSystems->setConsumption(QStringLiteral("/media/usb"), s_size / 1000);
+    m_scheduler->watch(QStringLiteral("usb"), QStringLiteral("/media/usb"));
+    QTRY_COMPARE(usageSpy.count(), 2);
+
+    m_scheduler->unwatch(QStringLiteral("usb"));
+    QVERIFY(!m_scheduler->isWatched(QStringLiteral("usb")));
+    const int queries = m_fileSystems->fileSystem(QStringLiteral("/media/usb")).queries;
+    QTest::qWait(300);
+    QVERIFY(m_fileSystems->fileSystem(QStringLiteral("/media/usb")).queries - queries <= 1);
+}
+
+void FreeSpaceSchedulerTest::testHangingMount()
+{
+    // queried before the share, which must not hold it back
+    QSignalSpy usageSpy(m_scheduler, &FreeSpaceScheduler::usageChanged);
+    m_fileSystems->setDelay(QStringLiteral("/mnt/nfs"), 1000);
+    m_scheduler->watch(QStringLiteral("nfs"), QStringLiteral("/mnt/nfs"));
+    m_scheduler->watch(QStringLiteral("/dev/sda1"), QStringLiteral("/"));
+
+    QTRY_COMPARE_WITH_TIMEOUT(usageSpy.count(), 1, 500);
+    QCOMPARE(usageSpy.first().at(0).toString(), QStringLiteral("/dev/sda1"));
+    QVERIFY(m_scheduler->threadPool() != QThreadPool::globalInstance());
+}
+
+void FreeSpaceSchedulerTest::testHangingShares()
+{
+    // all due at once, as when the data engine starts
+    QSignalSpy usageSpy(m_scheduler, &FreeSpaceScheduler::usageChanged);
+    QStringList shares;
+    for (int i = 0; i < 6; ++i) {
+        shares << QStringLiteral("/mnt/share%1").arg(i);
+        m_fileSystems->setDelay(shares.last(), 1500);
+        m_scheduler->watch(QStringLiteral("share%1").arg(i), shares.last(), true);
+    }
+    m_scheduler->watch(QStringLiteral("/dev/sda1"), QStringLiteral("/"));
+    m_scheduler->watch(QStringLiteral("/dev/sda2"), QStringLiteral("/home"));
+
+    // the local file systems are not queued behind the shares
+    QTRY_COMPARE_WITH_TIMEOUT(usageSpy.count(), 2, 500);
+
+    // which only get half of the workers, even once those are done
+    QTest::qWait(200);
+    int queried = 0;
+    for (const QString &share : qAsConst(shares)) {
+        queried += m_fileSystems->fileSystem(share).queries;
+    }
+    QCOMPARE(queried, 2);
+}
+
+void FreeSpaceSchedulerTest::testStuckWorkers()
+{
+    QSignalSpy usageSpy(m_scheduler, &FreeSpaceScheduler::usageChanged);
+    m_fileSystems->setConsumption(QStringLiteral("/"), s_size / 1000);
+    m_scheduler->watch(QStringLiteral("/dev/sda1"), QStringLiteral("/"));
+    QTRY_COMPARE(usageSpy.count(), 1);
+
+    // file systems which never answered in time, still stuck after the watchdog fired
+    QSignalSpy notRespondingSpy(m_scheduler, &FreeSpaceScheduler::notResponding);
+    QStringList stuck;
+    for (int i = 0; i < 5; ++i) {
+        stuck << QStringLiteral("/media/usb%1").arg(i);
+        m_fileSystems->setDelay(stuck.last(), 1500);
+        m_scheduler->watch(QStringLiteral("usb%1").arg(i), stuck.last());
+    }
+    QTRY_COMPARE(notRespondingSpy.count(), 3);
+
+    // keep their workers, but not the one of the file system known to answer
+    usageSpy.clear();
+    QTRY_VERIFY(usageSpy.count() > 3);
+    for (const QList<QVariant> &arguments : qAsConst(usageSpy)) {
+        QCOMPARE(arguments.at(0).toString(), QStringLiteral("/dev/sda1"));
+    }
+    int queried = 0;
+    for (const QString &path : qAsConst(stuck)) {
+        queried += m_fileSystems->fileSystem(path).queries;
+    }
+    QCOMPARE(queried, 3);
+}
+
+QTEST_GUILESS_MAIN(FreeSpaceSchedulerTest)
+
+#include "freespaceschedulertest.moc"
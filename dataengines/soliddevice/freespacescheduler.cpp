@@ -0,0 +1,305 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-only
+*/
+
+#include "freespacescheduler.h"
+
+#include <QFile>
+#include <QFutureWatcher>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <algorithm>
+
+#include <errno.h>
+#include <sys/statvfs.h>
+
+// A file system which would run full within this many intervals gets queried more often
+static const int s_intervalsBeforeFull = 100;
+// Workers querying file systems at once, one of them is kept for those which answer in time
+// and one more for those which did not get the chance to show it yet
+static const int s_maxThreads = 4;
+
+FreeSpaceScheduler::FreeSpaceScheduler(QObject *parent)
+    : FreeSpaceScheduler(&FreeSpaceScheduler::statFileSystem, parent)
+{
+}
+
+FreeSpaceScheduler::FreeSpaceScheduler(const StatFunction &stat, QObject *parent)
+    : QObject(parent)
+    , m_stat(stat)
+    , m_pool(new QThreadPool)
+{
+    m_pool->setMaxThreadCount(s_maxThreads);
+    m_clock.start();
+    m_timer.setSingleShot(true);
+    connect(&m_timer, &QTimer::timeout, this, &FreeSpaceScheduler::run);
+}
+
+FreeSpaceScheduler::~FreeSpaceScheduler()
+{
+    m_pool->clear();
+    // Deleting the pool waits for its workers. One stuck on an unreachable server
+    // must not block the shutdown, so the pool is left to it then.
+    if (m_pool->activeThreadCount() == 0) {
+        delete m_pool;
+    }
+}
+
+QThreadPool *FreeSpaceScheduler::threadPool() const
+{
+    return m_pool;
+}
+
+FreeSpaceScheduler::Usage FreeSpaceScheduler::statFileSystem(const QString &path)
+{
+    const QByteArray encodedPath = QFile::encodeName(path);
+    struct statvfs info;
+    int ret;
+    do {
+        ret = ::statvfs(encodedPath.constData(), &info);
+    } while (ret == -1 && errno == EINTR);
+
+    if (ret != 0) {
+        return {};
+    }
+    return {true, quint64(info.f_blocks) * info.f_frsize, quint64(info.f_bavail) * info.f_frsize};
+}
+
+void FreeSpaceScheduler::watch(const QString &udi, const QString &path, bool network)
+{
+    auto it = m_mounts.find(udi);
+    if (it != m_mounts.end() && it->path == path) {
+        it->network = network;
+        // Asked for on purpose, e.g. by a data engine update, so query it right away,
+        // but no more often than file systems filling up quickly are
+        if (!it->pending) {
+            it->due = qMin(it->due, qMax(m_clock.elapsed(), it->sampled + m_minimumInterval));
+            schedule();
+        }
+        return;
+    }
+
+    Mount mount;
+    mount.path = path;
+    mount.interval = m_normalInterval;
+    mount.network = network;
+    mount.due = m_clock.elapsed();
+    m_mounts.insert(udi, mount);
+    schedule();
+}
+
+void FreeSpaceScheduler::unwatch(const QString &udi)
+{
+    if (m_mounts.remove(udi)) {
+        schedule();
+    }
+}
+
+bool FreeSpaceScheduler::isWatched(const QString &udi) const
+{
+    return m_mounts.contains(udi);
+}
+
+int FreeSpaceScheduler::interval(const QString &udi) const
+{
+    return m_mounts.value(udi).interval;
+}
+
+bool FreeSpaceScheduler::isSlow(const QString &udi) const
+{
+    return m_mounts.value(udi).slow;
+}
+
+void FreeSpaceScheduler::setIntervals(int minimum, int normal, int maximum)
+{
+    Q_ASSERT(minimum <= normal && normal <= maximum);
+    m_minimumInterval = minimum;
+    m_normalInterval = normal;
+    m_maximumInterval = maximum;
+}
+
+void FreeSpaceScheduler::setTimeBudget(int msecs)
+{
+    m_timeBudget = msecs;
+}
+
+void FreeSpaceScheduler::setNotRespondingTimeout(int msecs)
+{
+    m_notRespondingTimeout = msecs;
+}
+
+void FreeSpaceScheduler::schedule()
+{
+    qint64 next = -1;
+    for (const Mount &mount : qAsConst(m_mounts)) {
+        if (!mount.pending && (next == -1 || mount.due < next)) {
+            next = mount.due;
+        }
+    }
+
+    if (next == -1) {
+        m_timer.stop();
+        return;
+    }
+    m_timer.start(int(qMax<qint64>(0, next - m_clock.elapsed())));
+}
+
+void FreeSpaceScheduler::run()
+{
+    // take along what would be due shortly, so file systems end up sharing wakeups
+    const qint64 now = m_clock.elapsed();
+    const qint64 horizon = now + m_minimumInterval / 2;
+
+    QVector<QString> due;
+    for (auto it = m_mounts.cbegin(); it != m_mounts.cend(); ++it) {
+        if (!it->pending && it->due <= horizon) {
+            due << it.key();
+        }
+    }
+    // those known to answer first, the workers left may well get stuck
+    std::stable_sort(due.begin(), due.end(), [this](const QString &a, const QString &b) {
+        return standing(m_mounts[a]) < standing(m_mounts[b]);
+    });
+
+    for (const QString &udi : qAsConst(due)) {
+        Mount &mount = m_mounts[udi];
+        const Standing mountStanding = standing(mount);
+        if (!canStart(mountStanding)) {
+            // tried again shortly, by then a worker may have become free
+            mount.due = now + m_minimumInterval;
+            continue;
+        }
+        start(udi, mountStanding);
+    }
+    schedule();
+}
+
+FreeSpaceScheduler::Standing FreeSpaceScheduler::standing(const Mount &mount)
+{
+    if (mount.network || mount.slow) {
+        return Suspect;
+    }
+    return mount.answered ? Answers : Unproven;
+}
+
+bool FreeSpaceScheduler::canStart(Standing standing) const
+{
+    if (m_runningJobs.count() >= s_maxThreads) {
+        return false;
+    }
+
+    int untrusted = 0;
+    int suspect = 0;
+    for (Standing running : m_runningJobs) {
+        untrusted += running != Answers;
+        suspect += running == Suspect;
+    }
+
+    switch (standing) {
+    case Answers:
+        return true;
+    case Unproven:
+        return untrusted < s_maxThreads - 1;
+    case Suspect:
+        return untrusted < s_maxThreads - 1 && suspect < s_maxThreads - 2;
+    }
+    return false;
+}
+
+void FreeSpaceScheduler::start(const QString &udi, Standing standing)
+{
+    Mount &mount = m_mounts[udi];
+    mount.pending = true;
+    const QString path = mount.path;
+
+    // every file system is a job of its own, so one which hangs delays no other
+    const int job = ++m_jobs;
+    m_runningJobs.insert(job, standing);
+
+    auto *watcher = new QFutureWatcher<Result>(this);
+    connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher, job, udi, path] {
+        m_runningJobs.remove(job);
+        finish(udi, path, watcher->result());
+        watcher->deleteLater();
+    });
+
+    // goes away with the watcher, so file systems which answer in time cause no wakeup
+    auto *watchdog = new QTimer(watcher);
+    watchdog->setSingleShot(true);
+    connect(watchdog, &QTimer::timeout, this, [this, job, udi, path] {
+        auto running = m_runningJobs.find(job);
+        if (running == m_runningJobs.end()) {
+            return;
+        }
+        // keeps its worker from those which answer until it returns, if ever
+        *running = Suspect;
+        auto it = m_mounts.find(udi);
+        if (it != m_mounts.end() && it->path == path) {
+            it->slow = true;
+        }
+        Q_EMIT notResponding(path);
+    });
+    watchdog->start(m_notRespondingTimeout);
+
+    const StatFunction stat = m_stat;
+    watcher->setFuture(QtConcurrent::run(m_pool, [stat, path] {
+        QElapsedTimer timer;
+        timer.start();
+        Result result;
+        result.usage = stat(path);
+        result.elapsed = timer.elapsed();
+        return result;
+    }));
+}
+
+void FreeSpaceScheduler::finish(const QString &udi, const QString &path, const Result &result)
+{
+    auto it = m_mounts.find(udi);
+    // unwatched or mounted somewhere else in the meantime
+    if (it == m_mounts.end() || it->path != path) {
+        return;
+    }
+
+    const Usage previous = it->usage;
+    const Usage usage = result.usage;
+    it->pending = false;
+    adapt(*it, result, m_clock.elapsed());
+
+    schedule();
+
+    if (usage.valid && (!previous.valid || usage.size != previous.size || usage.available != previous.available)) {
+        Q_EMIT usageChanged(udi, usage.size, usage.available);
+    }
+}
+
+void FreeSpaceScheduler::adapt(Mount &mount, const Result &result, qint64 now)
+{
+    const Usage &usage = result.usage;
+
+    if (result.elapsed > m_timeBudget) {
+        mount.slow = true;
+        mount.interval = m_maximumInterval;
+    } else if (!usage.valid || (mount.usage.valid && usage.size == mount.usage.size && usage.available == mount.usage.available)) {
+        mount.slow = false;
+        mount.interval = qMin(mount.interval * 2, m_maximumInterval);
+    } else if (mount.usage.valid && usage.available < mount.usage.available && now > mount.sampled) {
+        mount.slow = false;
+        // in bytes per ms
+        const double fillRate = double(mount.usage.available - usage.available) / (now - mount.sampled);
+        const double timeToFull = usage.available / fillRate;
+        mount.interval = int(qBound<double>(m_minimumInterval, timeToFull / s_intervalsBeforeFull, m_normalInterval));
+    } else {
+        mount.slow = false;
+        mount.interval = m_normalInterval;
+    }
+
+    if (usage.valid) {
+        mount.usage = usage;
+    }
+    mount.answered |= !mount.slow;
+    mount.sampled = now;
+    mount.due = now + mount.interval;
+}
@@ -0,0 +1,147 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-only
+*/
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+#include <functional>
+
+class QThreadPool;
+
+/**
+ * @brief Keeps track of the free space of all mounted file systems.
+ *
+ * A single timer serves every file system. Whenever it fires, the file systems which
+ * are due get queried, each in a job of its own on a small thread pool, so the GUI
+ * thread never waits for statvfs and a file system which hangs delays no other.
+ * How often a file system is queried depends on how it behaves: the interval
+ * doubles every time nothing changed, and shrinks when the file system fills up so
+ * quickly that it would run full within a few intervals.
+ *
+ * File systems which take longer than the time budget to answer, typically network
+ * shares of an unreachable server, only get queried at the longest interval. Network
+ * shares, slow file systems and those which did not answer in time yet only get part
+ * of the workers, counting the ones still stuck on them, so there always is a worker
+ * left for the file systems known to answer in time.
+ */
+class FreeSpaceScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    struct Usage {
+        bool valid = false;
+        quint64 size = 0;
+        quint64 available = 0;
+    };
+    using StatFunction = std::function<Usage(const QString &path)>;
+
+    explicit FreeSpaceScheduler(QObject *parent = nullptr);
+    /**
+     * @param stat queries the file system mounted at the given path, it is called
+     * from worker threads
+     */
+    explicit FreeSpaceScheduler(const StatFunction &stat, QObject *parent = nullptr);
+    ~FreeSpaceScheduler() override;
+
+    /**
+     * Starts following the file system of the device @p udi mounted at @p path,
+     * which gets queried right away. Watching it again queries it again, at most as
+     * often as the minimum interval allows.
+     *
+     * @param network whether the file system is a network share
+     */
+    void watch(const QString &udi, const QString &path, bool network = false);
+    void unwatch(const QString &udi);
+    bool isWatched(const QString &udi) const;
+
+    /**
+     * @return the time in ms between the last query of @p udi and the next one
+     */
+    int interval(const QString &udi) const;
+    /**
+     * @return whether @p udi exceeded the time budget and is queried on its own
+     */
+    bool isSlow(const QString &udi) const;
+
+    /**
+     * Intervals in ms for file systems which fill up quickly, for those which
+     * changed and the one idle file systems back off to; defaults are 2s, 10s and 5min
+     */
+    void setIntervals(int minimum, int normal, int maximum);
+    /**
+     * Time in ms a file system may take to answer before it is considered slow,
+     * defaults to 500ms
+     */
+    void setTimeBudget(int msecs);
+    /**
+     * Time in ms after which a file system which did not answer yet gets reported
+     * with notResponding, defaults to 15s
+     */
+    void setNotRespondingTimeout(int msecs);
+
+    /**
+     * @return the pool the file systems get queried in
+     */
+    QThreadPool *threadPool() const;
+
+Q_SIGNALS:
+    void usageChanged(const QString &udi, quint64 size, quint64 available);
+    void notResponding(const QString &path);
+
+private:
+    // How far a file system is trusted to answer in time, the less the fewer workers it gets
+    enum Standing {
+        Answers,
+        Unproven,
+        Suspect,
+    };
+
+    struct Mount {
+        QString path;
+        Usage usage;
+        qint64 sampled = -1;
+        qint64 due = 0;
+        int interval = 0;
+        bool network = false;
+        bool answered = false;
+        bool slow = false;
+        bool pending = false;
+    };
+    struct Result {
+        Usage usage;
+        qint64 elapsed = 0;
+    };
+
+    void schedule();
+    void run();
+    static Standing standing(const Mount &mount);
+    bool canStart(Standing standing) const;
+    void start(const QString &udi, Standing standing);
+    void finish(const QString &udi, const QString &path, const Result &result);
+    void adapt(Mount &mount, const Result &result, qint64 now);
+
+    static Usage statFileSystem(const QString &path);
+
+    StatFunction m_stat;
+    QHash<QString, Mount> m_mounts;
+    QElapsedTimer m_clock;
+    QTimer m_timer;
+    QThreadPool *m_pool;
+    int m_jobs = 0;
+    // including those stuck on a file system, they keep their worker
+    QHash<int, Standing> m_runningJobs;
+
+    int m_minimumInterval = 2000;
+    int m_normalInterval = 10000;
+    int m_maximumInterval = 300000;
+    int m_timeBudget = 500;
+    int m_notRespondingTimeout = 15000;
+};
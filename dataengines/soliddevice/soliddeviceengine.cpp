@@ -42,6 +42,17 @@ SolidDeviceEngine::SolidDeviceEngine(QObject *parent, const QVariantList &args)
     Q_UNUSED(args)
     m_signalmanager = new DeviceSignalMapManager(this);
 
+    m_freeSpace = new FreeSpaceScheduler(this);
+    connect(m_freeSpace, &FreeSpaceScheduler::usageChanged, this, [this](const QString &udi, quint64 size, quint64 available) {
+        setData(udi, I18N_NOOP("Free Space"), QVariant(available).toDouble());
+        setData(udi, I18N_NOOP("Free Space Text"), KFormat().formatByteSize(available));
+        setData(udi, I18N_NOOP("Size"), QVariant(size).toDouble());
+        setData(udi, I18N_NOOP("Size Text"), KFormat().formatByteSize(size));
+    });
+    connect(m_freeSpace, &FreeSpaceScheduler::notResponding, this, [](const QString &path) {
+        KNotification::event(KNotification::Error, i18n("Filesystem is not responding"), i18n("Filesystem mounted at '%1' is not responding", path));
+    });
+
     listenForNewDevices();
     setMinimumPollingInterval(1000);
     connect(this, &Plasma::DataEngine::sourceRemoved, this, &SolidDeviceEngine::sourceWasRemoved);
@@ -98,6 +109,7 @@ bool SolidDeviceEngine::sourceRequestEvent(const QString &name)
 
 void SolidDeviceEngine::sourceWasRemoved(const QString &source)
 {
+    m_freeSpace->unwatch(source);
     m_devicemap.remove(source);
     m_predicatemap.remove(source);
 }
@@ -515,42 +527,13 @@ bool SolidDeviceEngine::updateStorageSpace(const QString &udi)
 
     Solid::StorageAccess *storageaccess = device.as<Solid::StorageAccess>();
     if (!storageaccess || !storageaccess->isAccessible()) {
+        m_freeSpace->unwatch(udi);
         return false;
     }
 
-    QString path = storageaccess->filePath();
-    if (!m_paths.contains(path)) {
-        QTimer *timer = new QTimer(this);
-        timer->setSingleShot(true);
-        connect(timer, &QTimer::timeout, [path]() {
-            KNotification::event(KNotification::Error, i18n("Filesystem is not responding"), i18n("Filesystem mounted at '%1' is not responding", path));
-        });
-
-        m_paths.insert(path);
-
-        // create job
-        KIO::FileSystemFreeSpaceJob *job = KIO::fileSystemFreeSpace(QUrl::fromLocalFile(path));
-
-        // delete later timer
-        connect(job, &KIO::FileSystemFreeSpaceJob::result, timer, &QTimer::deleteLater);
-
-        // collect and process info
-        connect(job, &KIO::FileSystemFreeSpaceJob::result, this, [this, timer, path, udi](KIO::Job *job, KIO::filesize_t size, KIO::filesize_t available) {
-            timer->stop();
-
-            if (!job->error()) {
-                setData(udi, I18N_NOOP("Free Space"), QVariant(available).toDouble());
-                setData(udi, I18N_NOOP("Free Space Text"), KFormat().formatByteSize(available));
-                setData(udi, I18N_NOOP("Size"), QVariant(size).toDouble());
-                setData(udi, I18N_NOOP("Size Text"), KFormat().formatByteSize(size));
-            }
-
-            m_paths.remove(path);
-        });
-
-        // start timer: after 15 seconds we will get an error
-        timer->start(15000);
-    }
+    // the scheduler decides when to look again, the values arrive through usageChanged;
+    // network shares may hang on an unreachable server, so they only get part of its workers
+    m_freeSpace->watch(udi, storageaccess->filePath(), device.isDeviceInterface(Solid::DeviceInterface::NetworkShare));
 
     return false;
 }
@@ -19,8 +19,8 @@
 
 #include "devicesignalmapmanager.h"
 #include "devicesignalmapper.h"
+#include "freespacescheduler.h"
 #include "hddtemp.h"
-#include <KIO/FileSystemFreeSpaceJob>
 #include <Plasma/DataEngine>
 #include <Plasma/Service>
 
@@ -68,8 +68,7 @@ private:
     QMap<QString, Solid::Device> m_devicemap;
     // udi, corresponding encrypted container udi;
     QMap<QString, QString> m_encryptedContainerMap;
-    // path, for pending file system free space jobs
-    QSet<QString> m_paths;
+    FreeSpaceScheduler *m_freeSpace;
     DeviceSignalMapManager *m_signalmanager;
 
     HddTemp *m_temperature;
@@ -13,9 +13,11 @@
 #include <KIconEngine>
 #include <KIconLoader>
 #include <QApplication>
+#include <QCache>
 #include <QDBusMessage>
 #include <QDBusPendingCall>
 #include <QDBusPendingReply>
+#include <QDBusVariant>
 #include <QDebug>
 #include <QIcon>
 #include <QImage>
@@ -28,6 +30,31 @@
 
 #include <dbusmenuimporter.h>
 
+namespace
+{
+struct PixmapKey {
+    int width;
+    int height;
+    QByteArray data;
+
+    bool operator==(const PixmapKey &other) const
+    {
+        return width == other.width && height == other.height && data == other.data;
+    }
+};
+
+uint qHash(const PixmapKey &key, uint seed = 0)
+{
+    return ::qHash(key.data, seed) ^ uint(key.width) ^ (uint(key.height) << 16);
+}
+
+// Decoded icon frames of all items, keyed by their raw data
+using PixmapCache = QCache<PixmapKey, QPixmap>;
+Q_GLOBAL_STATIC_WITH_ARGS(PixmapCache, s_pixmapCache, (8 * 1024 * 1024))
+quint64 s_pixmapCacheHits = 0;
+quint64 s_pixmapCacheMisses = 0;
+}
+
 class PlasmaDBusMenuImporter : public DBusMenuImporter
 {
 public:
@@ -53,10 +80,8 @@ StatusNotifierItemSource::StatusNotifierItemSource(const QString &notifierItemId
     , m_menuImporter(nullptr)
     , m_refreshing(false)
     , m_needsReRefreshing(false)
-    , m_titleUpdate(true)
-    , m_iconUpdate(true)
-    , m_tooltipUpdate(true)
-    , m_statusUpdate(true)
+    , m_pendingUpdates(AllUpdates)
+    , m_pendingPropertyCalls(0)
 {
     setObjectName(notifierItemId);
     qDBusRegisterMetaType<KDbusImageStruct>();
@@ -139,6 +164,16 @@ Plasma::Service *StatusNotifierItemSource::createService()
     return new StatusNotifierItemService(this);
 }
 
+quint64 StatusNotifierItemSource::pixmapCacheHits()
+{
+    return s_pixmapCacheHits;
+}
+
+quint64 StatusNotifierItemSource::pixmapCacheMisses()
+{
+    return s_pixmapCacheMisses;
+}
+
 void StatusNotifierItemSource::syncStatus(QString status)
 {
     setData(QStringLiteral("TitleChanged"), false);
@@ -151,19 +186,19 @@ void StatusNotifierItemSource::syncStatus(QString status)
 
 void StatusNotifierItemSource::refreshTitle()
 {
-    m_titleUpdate = true;
+    m_pendingUpdates |= TitleUpdate;
     refresh();
 }
 
 void StatusNotifierItemSource::refreshIcons()
 {
-    m_iconUpdate = true;
+    m_pendingUpdates |= IconUpdate;
     refresh();
 }
 
 void StatusNotifierItemSource::refreshToolTip()
 {
-    m_tooltipUpdate = true;
+    m_pendingUpdates |= ToolTipUpdate;
     refresh();
 }
 
@@ -173,6 +208,7 @@ void StatusNotifierItemSource::refreshMenu()
         m_menuImporter->deleteLater();
         m_menuImporter = nullptr;
     }
+    m_pendingUpdates |= MenuUpdate;
     refresh();
 }
 
@@ -183,6 +219,24 @@ void StatusNotifierItemSource::refresh()
     }
 }
 
+QStringList StatusNotifierItemSource::propertiesFor(Updates updates)
+{
+    // The icons make up most of the item and depend on each other through the overlay and
+    // the theme path, one GetAll is cheaper than getting them one by one
+    if (updates & (IconUpdate | StatusUpdate | MenuUpdate)) {
+        return {};
+    }
+
+    QStringList properties;
+    if (updates & TitleUpdate) {
+        properties << QStringLiteral("Title");
+    }
+    if (updates & ToolTipUpdate) {
+        properties << QStringLiteral("ToolTip");
+    }
+    return properties;
+}
+
 void StatusNotifierItemSource::performRefresh()
 {
     if (m_refreshing) {
@@ -191,6 +245,40 @@ void StatusNotifierItemSource::performRefresh()
     }
 
     m_refreshing = true;
+    m_requestedUpdates = m_pendingUpdates;
+    m_pendingUpdates = {};
+
+    // NewTitle, NewIcon and friends only invalidate a few properties, don't transfer all the others again
+    const QStringList properties = propertiesFor(m_requestedUpdates);
+    if (!properties.isEmpty()) {
+        m_receivedProperties.clear();
+        m_pendingPropertyCalls = properties.count();
+
+        for (const QString &property : properties) {
+            QDBusMessage message = QDBusMessage::createMethodCall(m_statusNotifierItemInterface->service(),
+                                                                  m_statusNotifierItemInterface->path(),
+                                                                  QStringLiteral("org.freedesktop.DBus.Properties"),
+                                                                  QStringLiteral("Get"));
+
+            message << m_statusNotifierItemInterface->interface() << property;
+            QDBusPendingCall call = m_statusNotifierItemInterface->connection().asyncCall(message);
+            QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(call, this);
+            connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, property](QDBusPendingCallWatcher *call) {
+                QDBusPendingReply<QDBusVariant> reply = *call;
+                // Like GetAll, leave out what the item does not implement
+                if (!reply.isError()) {
+                    m_receivedProperties.insert(property, reply.value().variant());
+                }
+                call->deleteLater();
+
+                if (--m_pendingPropertyCalls == 0) {
+                    updateProperties(m_receivedProperties, !m_receivedProperties.isEmpty());
+                }
+            });
+        }
+        return;
+    }
+
     QDBusMessage message = QDBusMessage::createMethodCall(m_statusNotifierItemInterface->service(),
                                                           m_statusNotifierItemInterface->path(),
                                                           QStringLiteral("org.freedesktop.DBus.Properties"),
@@ -206,137 +294,157 @@ void StatusNotifierItemSource::performRefresh()
   \todo add a smart pointer to guard call and to automatically delete it at the end of the function
   */
 void StatusNotifierItemSource::refreshCallback(QDBusPendingCallWatcher *call)
+{
+    QDBusPendingReply<QVariantMap> reply = *call;
+    call->deleteLater();
+
+    if (reply.isError()) {
+        updateProperties(QVariantMap(), false);
+    } else {
+        updateProperties(reply.argumentAt<0>(), true);
+    }
+}
+
+void StatusNotifierItemSource::updateProperties(const QVariantMap &properties, bool valid)
 {
     m_refreshing = false;
     if (m_needsReRefreshing) {
         m_needsReRefreshing = false;
+        m_pendingUpdates |= m_requestedUpdates;
         performRefresh();
-        call->deleteLater();
         return;
     }
 
-    QDBusPendingReply<QVariantMap> reply = *call;
-    if (reply.isError()) {
+    if (!valid) {
         m_valid = false;
     } else {
         // record what has changed
-        setData(QStringLiteral("TitleChanged"), m_titleUpdate);
-        m_titleUpdate = false;
-        setData(QStringLiteral("IconsChanged"), m_iconUpdate);
-        m_iconUpdate = false;
-        setData(QStringLiteral("ToolTipChanged"), m_tooltipUpdate);
-        m_tooltipUpdate = false;
-        setData(QStringLiteral("StatusChanged"), m_statusUpdate);
-        m_statusUpdate = false;
-
-        // IconThemePath (handle this one first, because it has an impact on
-        // others)
-        QVariantMap properties = reply.argumentAt<0>();
-        QString path = properties[QStringLiteral("IconThemePath")].toString();
-
-        if (!path.isEmpty() && path != data()[QStringLiteral("IconThemePath")].toString()) {
-            if (!m_customIconLoader) {
-                m_customIconLoader = new KIconLoader(QString(), QStringList(), this);
-            }
-            // FIXME: If last part of path is not "icons", this won't work!
-            QString appName;
-            auto tokens = path.splitRef('/', Qt::SkipEmptyParts);
-            if (tokens.length() >= 3 && tokens.takeLast() == QLatin1String("icons"))
-                appName = tokens.takeLast().toString();
-
-            // icons may be either in the root directory of the passed path or in a appdir format
-            // i.e hicolor/32x32/iconname.png
-
-            m_customIconLoader->reconfigure(appName, QStringList(path));
+        setData(QStringLiteral("TitleChanged"), m_requestedUpdates.testFlag(TitleUpdate));
+        setData(QStringLiteral("IconsChanged"), m_requestedUpdates.testFlag(IconUpdate));
+        setData(QStringLiteral("ToolTipChanged"), m_requestedUpdates.testFlag(ToolTipUpdate));
+        setData(QStringLiteral("StatusChanged"), m_requestedUpdates.testFlag(StatusUpdate));
+
+        // Everything but the title, icons and tooltip only comes with a full refresh
+        const bool fullRefresh = propertiesFor(m_requestedUpdates).isEmpty();
+        const Updates sections = fullRefresh ? AllUpdates : m_requestedUpdates;
+
+        if (sections & IconUpdate) {
+            // IconThemePath (handle this one first, because it has an impact on
+            // others)
+            QString path = properties[QStringLiteral("IconThemePath")].toString();
+
+            if (!path.isEmpty() && path != data()[QStringLiteral("IconThemePath")].toString()) {
+                if (!m_customIconLoader) {
+                    m_customIconLoader = new KIconLoader(QString(), QStringList(), this);
+                }
+                // FIXME: If last part of path is not "icons", this won't work!
+                QString appName;
+                auto tokens = path.splitRef('/', Qt::SkipEmptyParts);
+                if (tokens.length() >= 3 && tokens.takeLast() == QLatin1String("icons"))
+                    appName = tokens.takeLast().toString();
 
-            // add app dir requires an app name, though this is completely unused in this context
-            m_customIconLoader->addAppDir(appName.size() ? appName : QStringLiteral("unused"), path);
+                // icons may be either in the root directory of the passed path or in a appdir format
+                // i.e hicolor/32x32/iconname.png
 
-            connect(m_customIconLoader, &KIconLoader::iconChanged, this, [=] {
                 m_customIconLoader->reconfigure(appName, QStringList(path));
+
+                // add app dir requires an app name, though this is completely unused in this context
                 m_customIconLoader->addAppDir(appName.size() ? appName : QStringLiteral("unused"), path);
-            });
+
+                connect(m_customIconLoader, &KIconLoader::iconChanged, this, [=] {
+                    m_customIconLoader->reconfigure(appName, QStringList(path));
+                    m_customIconLoader->addAppDir(appName.size() ? appName : QStringLiteral("unused"), path);
+                });
+            }
+            setData(QStringLiteral("IconThemePath"), path);
+        }
+
+        if (fullRefresh) {
+            setData(QStringLiteral("Category"), properties[QStringLiteral("Category")]);
+            setData(QStringLiteral("Status"), properties[QStringLiteral("Status")]);
+        }
+        if (sections & TitleUpdate) {
+            setData(QStringLiteral("Title"), properties[QStringLiteral("Title")]);
         }
-        setData(QStringLiteral("IconThemePath"), path);
-
-        setData(QStringLiteral("Category"), properties[QStringLiteral("Category")]);
-        setData(QStringLiteral("Status"), properties[QStringLiteral("Status")]);
-        setData(QStringLiteral("Title"), properties[QStringLiteral("Title")]);
-        setData(QStringLiteral("Id"), properties[QStringLiteral("Id")]);
-        setData(QStringLiteral("WindowId"), properties[QStringLiteral("WindowId")]);
-        setData(QStringLiteral("ItemIsMenu"), properties[QStringLiteral("ItemIsMenu")]);
-
-        // Attention Movie
-        setData(QStringLiteral("AttentionMovieName"), properties[QStringLiteral("AttentionMovieName")]);
-
-        QIcon overlay;
-        QStringList overlayNames;
-
-        // Icon
-        {
-            KDbusImageVector image;
-            QIcon icon;
-            QString iconName;
-
-            properties[QStringLiteral("OverlayIconPixmap")].value<QDBusArgument>() >> image;
-            if (image.isEmpty()) {
-                QString iconName = properties[QStringLiteral("OverlayIconName")].toString();
-                setData(QStringLiteral("OverlayIconName"), iconName);
-                if (!iconName.isEmpty()) {
-                    overlayNames << iconName;
-                    overlay = QIcon(new KIconEngine(iconName, iconLoader()));
+        if (fullRefresh) {
+            setData(QStringLiteral("Id"), properties[QStringLiteral("Id")]);
+            setData(QStringLiteral("WindowId"), properties[QStringLiteral("WindowId")]);
+            setData(QStringLiteral("ItemIsMenu"), properties[QStringLiteral("ItemIsMenu")]);
+        }
+
+        if (sections & IconUpdate) {
+            // Attention Movie
+            setData(QStringLiteral("AttentionMovieName"), properties[QStringLiteral("AttentionMovieName")]);
+
+            QIcon overlay;
+            QStringList overlayNames;
+
+            // Icon
+            {
+                KDbusImageVector image;
+                QIcon icon;
+                QString iconName;
+
+                properties[QStringLiteral("OverlayIconPixmap")].value<QDBusArgument>() >> image;
+                if (image.isEmpty()) {
+                    QString iconName = properties[QStringLiteral("OverlayIconName")].toString();
+                    setData(QStringLiteral("OverlayIconName"), iconName);
+                    if (!iconName.isEmpty()) {
+                        overlayNames << iconName;
+                        overlay = QIcon(new KIconEngine(iconName, iconLoader()));
+                    }
+                } else {
+                    overlay = imageVectorToPixmap(image);
                 }
-            } else {
-                overlay = imageVectorToPixmap(image);
-            }
 
-            properties[QStringLiteral("IconPixmap")].value<QDBusArgument>() >> image;
-            if (image.isEmpty()) {
-                iconName = properties[QStringLiteral("IconName")].toString();
-                if (!iconName.isEmpty()) {
-                    icon = QIcon(new KIconEngine(iconName, iconLoader(), overlayNames));
+                properties[QStringLiteral("IconPixmap")].value<QDBusArgument>() >> image;
+                if (image.isEmpty()) {
+                    iconName = properties[QStringLiteral("IconName")].toString();
+                    if (!iconName.isEmpty()) {
+                        icon = QIcon(new KIconEngine(iconName, iconLoader(), overlayNames));
 
-                    if (overlayNames.isEmpty() && !overlay.isNull()) {
+                        if (overlayNames.isEmpty() && !overlay.isNull()) {
+                            overlayIcon(&icon, &overlay);
+                        }
+                    }
+                } else {
+                    icon = imageVectorToPixmap(image);
+                    if (!icon.isNull() && !overlay.isNull()) {
                         overlayIcon(&icon, &overlay);
                     }
                 }
-            } else {
-                icon = imageVectorToPixmap(image);
-                if (!icon.isNull() && !overlay.isNull()) {
-                    overlayIcon(&icon, &overlay);
-                }
+                setData(QStringLiteral("Icon"), icon);
+                setData(QStringLiteral("IconName"), iconName);
             }
-            setData(QStringLiteral("Icon"), icon);
-            setData(QStringLiteral("IconName"), iconName);
-        }
 
-        // Attention icon
-        {
-            KDbusImageVector image;
-            QIcon attentionIcon;
+            // Attention icon
+            {
+                KDbusImageVector image;
+                QIcon attentionIcon;
 
-            properties[QStringLiteral("AttentionIconPixmap")].value<QDBusArgument>() >> image;
-            if (image.isEmpty()) {
-                QString iconName = properties[QStringLiteral("AttentionIconName")].toString();
-                setData(QStringLiteral("AttentionIconName"), iconName);
-                if (!iconName.isEmpty()) {
-                    attentionIcon = QIcon(new KIconEngine(iconName, iconLoader(), overlayNames));
+                properties[QStringLiteral("AttentionIconPixmap")].value<QDBusArgument>() >> image;
+                if (image.isEmpty()) {
+                    QString iconName = properties[QStringLiteral("AttentionIconName")].toString();
+                    setData(QStringLiteral("AttentionIconName"), iconName);
+                    if (!iconName.isEmpty()) {
+                        attentionIcon = QIcon(new KIconEngine(iconName, iconLoader(), overlayNames));
 
-                    if (overlayNames.isEmpty() && !overlay.isNull()) {
+                        if (overlayNames.isEmpty() && !overlay.isNull()) {
+                            overlayIcon(&attentionIcon, &overlay);
+                        }
+                    }
+                } else {
+                    attentionIcon = imageVectorToPixmap(image);
+                    if (!attentionIcon.isNull() && !overlay.isNull()) {
                         overlayIcon(&attentionIcon, &overlay);
                     }
                 }
-            } else {
-                attentionIcon = imageVectorToPixmap(image);
-                if (!attentionIcon.isNull() && !overlay.isNull()) {
-                    overlayIcon(&attentionIcon, &overlay);
-                }
+                setData(QStringLiteral("AttentionIcon"), attentionIcon);
             }
-            setData(QStringLiteral("AttentionIcon"), attentionIcon);
         }
 
         // ToolTip
-        {
+        if (sections & ToolTipUpdate) {
             KDbusToolTipStruct toolTip;
             properties[QStringLiteral("ToolTip")].value<QDBusArgument>() >> toolTip;
             if (toolTip.title.isEmpty()) {
@@ -361,7 +469,7 @@ void StatusNotifierItemSource::refreshCallback(QDBusPendingCallWatcher *call)
         }
 
         // Menu
-        if (!m_menuImporter) {
+        if (fullRefresh && !m_menuImporter) {
             QString menuObjectPath = properties[QStringLiteral("Menu")].value<QDBusObjectPath>().path();
             if (!menuObjectPath.isEmpty()) {
                 if (menuObjectPath == QLatin1String("/NO_DBUSMENU")) {
@@ -382,7 +490,6 @@ void StatusNotifierItemSource::refreshCallback(QDBusPendingCallWatcher *call)
     }
 
     checkForUpdate();
-    call->deleteLater();
 }
 
 void StatusNotifierItemSource::contextMenuReady()
@@ -392,22 +499,32 @@ void StatusNotifierItemSource::contextMenuReady()
 
 QPixmap StatusNotifierItemSource::KDbusImageStructToPixmap(const KDbusImageStruct &image) const
 {
+    if (image.width == 0 || image.height == 0) {
+        return QPixmap();
+    }
+
+    // Animated icons cycle through the same few frames, convert each of them only once
+    const PixmapKey key{image.width, image.height, image.data};
+    if (const QPixmap *pixmap = s_pixmapCache->object(key)) {
+        ++s_pixmapCacheHits;
+        return *pixmap;
+    }
+
+    ++s_pixmapCacheMisses;
+
+    // The raw data is kept as cache key, convert a copy of it.
+    // We need to keep a reference to the data alive for the lifespan of the image, even if the image is copied,
+    // so we create it on the heap and delete it in the QImage cleanup
+    auto dataRef = new QByteArray(image.data.constData(), image.data.size());
+
     // swap from network byte order if we are little endian
     if (QSysInfo::ByteOrder == QSysInfo::LittleEndian) {
-        uint *uintBuf = (uint *)image.data.data();
-        for (uint i = 0; i < image.data.size() / sizeof(uint); ++i) {
+        uint *uintBuf = reinterpret_cast<uint *>(dataRef->data());
+        for (uint i = 0; i < dataRef->size() / sizeof(uint); ++i) {
             *uintBuf = ntohl(*uintBuf);
             ++uintBuf;
         }
     }
-    if (image.width == 0 || image.height == 0) {
-        return QPixmap();
-    }
-
-    // avoid a deep copy of the image data
-    // we need to keep a reference to the image.data alive for the lifespan of the image, even if the image is copied
-    // we create a new QByteArray with a shallow copy of the original data on the heap, then delete this in the QImage cleanup
-    auto dataRef = new QByteArray(image.data);
 
     QImage iconImage(
         reinterpret_cast<const uchar *>(dataRef->data()),
@@ -418,7 +535,12 @@ QPixmap StatusNotifierItemSource::KDbusImageStructToPixmap(const KDbusImageStruc
             delete static_cast<QByteArray *>(ptr);
         },
         dataRef);
-    return QPixmap::fromImage(iconImage);
+    const QPixmap pixmap = QPixmap::fromImage(iconImage);
+
+    // Accounts for the pixmap and the key, which are about the same size
+    s_pixmapCache->insert(key, new QPixmap(pixmap), 2 * image.data.size());
+
+    return pixmap;
 }
 
 QIcon StatusNotifierItemSource::imageVectorToPixmap(const KDbusImageVector &vector) const
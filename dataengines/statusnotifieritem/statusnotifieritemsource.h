@@ -33,6 +33,12 @@ public:
     void contextMenu(int x, int y);
     void provideXdgActivationToken(const QString &token);
 
+    /**
+     * Icon frames served from, respectively converted for, the pixmap cache shared by all items
+     */
+    static quint64 pixmapCacheHits();
+    static quint64 pixmapCacheMisses();
+
 Q_SIGNALS:
     void contextMenuReady(QMenu *menu);
     void activateResult(bool success);
@@ -50,6 +56,20 @@ private Q_SLOTS:
     void activateCallback(QDBusPendingCallWatcher *);
 
 private:
+    enum Update {
+        TitleUpdate = 0x1,
+        IconUpdate = 0x2,
+        ToolTipUpdate = 0x4,
+        StatusUpdate = 0x8,
+        MenuUpdate = 0x10,
+        AllUpdates = TitleUpdate | IconUpdate | ToolTipUpdate | StatusUpdate | MenuUpdate,
+    };
+    Q_DECLARE_FLAGS(Updates, Update)
+
+    // Properties to fetch for @p updates, empty if all of them are needed
+    static QStringList propertiesFor(Updates updates);
+    void updateProperties(const QVariantMap &properties, bool valid);
+
     QPixmap KDbusImageStructToPixmap(const KDbusImageStruct &image) const;
     QIcon imageVectorToPixmap(const KDbusImageVector &vector) const;
     void overlayIcon(QIcon *icon, QIcon *overlay);
@@ -64,8 +84,8 @@ private:
     org::kde::StatusNotifierItem *m_statusNotifierItemInterface;
     bool m_refreshing : 1;
     bool m_needsReRefreshing : 1;
-    bool m_titleUpdate : 1;
-    bool m_iconUpdate : 1;
-    bool m_tooltipUpdate : 1;
-    bool m_statusUpdate : 1;
+    Updates m_pendingUpdates;
+    Updates m_requestedUpdates;
+    QVariantMap m_receivedProperties;
+    int m_pendingPropertyCalls;
 };
@@ -0,0 +1,183 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-only
+*/
+
+#include <QTest>
+
+#include "procsampler.h"
+
+class ProcSamplerTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void testCpu();
+    void testMemory();
+    void testLoadAverage();
+    void testNetwork();
+    void testProc();
+    void benchmarkBatched();
+    void benchmarkPerSensor();
+
+private:
+    // The files of a machine with @p cpus CPUs and @p interfaces network interfaces, @p tick seconds after boot
+    static ProcSampler::Files files(int cpus, int interfaces, int tick);
+
+    QStringList m_sensors;
+};
+
+ProcSampler::Files ProcSamplerTest::files(int cpus, int interfaces, int tick)
+{
+    ProcSampler::Files files;
+
+    // Every second each CPU spends 30 ticks in user, 10 in nice, 10 in system, 40 idle and 10 waiting
+    const auto cpuLine = [tick](const QByteArray &name, int count) {
+        return name + ' ' + QByteArray::number(30 * tick * count) + ' ' + QByteArray::number(10 * tick * count) + ' ' + QByteArray::number(10 * tick * count)
+            + ' ' + QByteArray::number(40 * tick * count) + ' ' + QByteArray::number(10 * tick * count) + " 0 0 0 0 0\n";
+    };
+    files.stat = cpuLine("cpu ", cpus);
+    for (int cpu = 0; cpu < cpus; ++cpu) {
+        files.stat += cpuLine("cpu" + QByteArray::number(cpu), 1);
+    }
+    files.stat += "intr 12345 0 0\nctxt 67890\nbtime 1600000000\nprocesses 4242\n";
+
+    files.meminfo =
+        "MemTotal:       16000000 kB\n"
+        "MemFree:         4000000 kB\n"
+        "MemAvailable:    9000000 kB\n"
+        "Buffers:         1000000 kB\n"
+        "Cached:          2500000 kB\n"
+        "SwapCached:            0 kB\n"
+        "SReclaimable:     500000 kB\n"
+        "SwapTotal:       8000000 kB\n"
+        "SwapFree:        6000000 kB\n";
+
+    files.loadavg = "0.52 0.58 0.59 1/1234 5678\n";
+
+    // Every second each interface receives 2 MiB in 1000 packets and sends 512 KiB in 100 packets
+    files.netdev =
+        "Inter-|   Receive                                                |  Transmit\n"
+        " face |bytes    packets errs drop fifo frame compressed multicast|bytes    packets errs drop fifo colls carrier compressed\n";
+    for (int i = 0; i < interfaces; ++i) {
+        files.netdev += "  eth" + QByteArray::number(i) + ": " + QByteArray::number(2097152LL * tick) + ' ' + QByteArray::number(1000 * tick) + " 0 0 0 0 0 0 "
+            + QByteArray::number(524288LL * tick) + ' ' + QByteArray::number(100 * tick) + " 0 0 0 0 0 0\n";
+    }
+
+    return files;
+}
+
+void ProcSamplerTest::initTestCase()
+{
+    // 64 CPUs and 40 interfaces make for more than 500 sensors
+    ProcSampler sampler;
+    sampler.sample(files(64, 40, 1), 0);
+    m_sensors = sampler.sensors();
+    QVERIFY(m_sensors.count() >= 500);
+    m_sensors = m_sensors.mid(0, 500);
+}
+
+void ProcSamplerTest::testCpu()
+{
+    ProcSampler sampler;
+    sampler.sample(files(4, 1, 1), 0);
+    // Nothing to compare with yet
+    QCOMPARE(sampler.value(QStringLiteral("cpu/system/TotalLoad")), QStringLiteral("0.00"));
+
+    sampler.sample(files(4, 1, 2), 1000);
+    for (const QString &prefix : {QStringLiteral("cpu/system/"), QStringLiteral("cpu/cpu3/")}) {
+        QCOMPARE(sampler.value(prefix + QStringLiteral("user")), QStringLiteral("30.00"));
+        QCOMPARE(sampler.value(prefix + QStringLiteral("nice")), QStringLiteral("10.00"));
+        QCOMPARE(sampler.value(prefix + QStringLiteral("sys")), QStringLiteral("10.00"));
+        QCOMPARE(sampler.value(prefix + QStringLiteral("idle")), QStringLiteral("40.00"));
+        QCOMPARE(sampler.value(prefix + QStringLiteral("wait")), QStringLiteral("10.00"));
+        QCOMPARE(sampler.value(prefix + QStringLiteral("TotalLoad")), QStringLiteral("50.00"));
+    }
+    QVERIFY(!sampler.contains(QStringLiteral("cpu/cpu4/TotalLoad")));
+}
+
+void ProcSamplerTest::testMemory()
+{
+    ProcSampler sampler;
+    sampler.sample(files(1, 1, 1), 0);
+
+    QCOMPARE(sampler.value(QStringLiteral("mem/physical/free")), QStringLiteral("4000000"));
+    QCOMPARE(sampler.value(QStringLiteral("mem/physical/used")), QStringLiteral("12000000"));
+    QCOMPARE(sampler.value(QStringLiteral("mem/physical/buf")), QStringLiteral("1000000"));
+    QCOMPARE(sampler.value(QStringLiteral("mem/physical/cached")), QStringLiteral("3000000"));
+    QCOMPARE(sampler.value(QStringLiteral("mem/physical/application")), QStringLiteral("8000000"));
+    QCOMPARE(sampler.value(QStringLiteral("mem/swap/free")), QStringLiteral("6000000"));
+    QCOMPARE(sampler.value(QStringLiteral("mem/swap/used")), QStringLiteral("2000000"));
+}
+
+void ProcSamplerTest::testLoadAverage()
+{
+    ProcSampler sampler;
+    sampler.sample(files(1, 1, 1), 0);
+
+    QCOMPARE(sampler.value(QStringLiteral("cpu/system/loadavg1")), QStringLiteral("0.52"));
+    QCOMPARE(sampler.value(QStringLiteral("cpu/system/loadavg5")), QStringLiteral("0.58"));
+    QCOMPARE(sampler.value(QStringLiteral("cpu/system/loadavg15")), QStringLiteral("0.59"));
+}
+
+void ProcSamplerTest::testNetwork()
+{
+    ProcSampler sampler;
+    sampler.sample(files(1, 2, 1), 0);
+    QCOMPARE(sampler.value(QStringLiteral("network/interfaces/eth1/receiver/data")), QStringLiteral("0.00"));
+
+    // Two seconds later
+    sampler.sample(files(1, 2, 3), 2000);
+    QCOMPARE(sampler.value(QStringLiteral("network/interfaces/eth1/receiver/data")), QStringLiteral("2048.00"));
+    QCOMPARE(sampler.value(QStringLiteral("network/interfaces/eth1/receiver/packets")), QStringLiteral("1000.00"));
+    QCOMPARE(sampler.value(QStringLiteral("network/interfaces/eth1/transmitter/data")), QStringLiteral("512.00"));
+    QCOMPARE(sampler.value(QStringLiteral("network/interfaces/eth1/transmitter/packets")), QStringLiteral("100.00"));
+    QVERIFY(!sampler.contains(QStringLiteral("network/interfaces/eth2/receiver/data")));
+}
+
+void ProcSamplerTest::testProc()
+{
+    ProcSampler sampler;
+    sampler.update(0);
+    if (!sampler.contains(QStringLiteral("cpu/system/TotalLoad"))) {
+        QSKIP("No /proc to read");
+    }
+    QVERIFY(sampler.contains(QStringLiteral("mem/physical/free")));
+    QVERIFY(sampler.contains(QStringLiteral("cpu/system/loadavg1")));
+}
+
+void ProcSamplerTest::benchmarkBatched()
+{
+    // One sample per update interval, then every sensor takes its value from it
+    const ProcSampler::Files sample = files(64, 40, 1);
+    ProcSampler sampler;
+
+    QBENCHMARK {
+        sampler.sample(sample, 1000);
+        for (const QString &sensor : qAsConst(m_sensors)) {
+            sampler.value(sensor);
+        }
+    }
+}
+
+void ProcSamplerTest::benchmarkPerSensor()
+{
+    // Like today's ksysguardd path, where every sensor is a request of its own which
+    // needs its source read and parsed again. The round trip to ksysguardd and parsing
+    // its text answer come on top of this and are not measured.
+    const ProcSampler::Files sample = files(64, 40, 1);
+    ProcSampler sampler;
+
+    QBENCHMARK {
+        for (const QString &sensor : qAsConst(m_sensors)) {
+            sampler.sample(sample, 1000);
+            sampler.value(sensor);
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(ProcSamplerTest)
+
+#include "procsamplertest.moc"
@@ -0,0 +1,207 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-only
+*/
+
+#include "procsampler.h"
+
+#include <QFile>
+
+namespace
+{
+QByteArray readFile(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    // proc files report a size of 0, read until the end
+    return file.readAll();
+}
+
+QList<QByteArray> fields(const QByteArray &line)
+{
+    return line.simplified().split(' ');
+}
+
+QString percent(qulonglong part, qulonglong total)
+{
+    return QString::number(total ? 100.0 * part / total : 0.0, 'f', 2);
+}
+
+QString rate(qulonglong current, qulonglong previous, qint64 elapsed, double divisor)
+{
+    if (elapsed <= 0 || current < previous) {
+        return QStringLiteral("0.00");
+    }
+    return QString::number((current - previous) / divisor * 1000.0 / elapsed, 'f', 2);
+}
+}
+
+ProcSampler::ProcSampler(const QString &procPath)
+    : m_procPath(procPath)
+{
+}
+
+void ProcSampler::update(int maxAge)
+{
+    if (m_lastSample.isValid() && m_lastSample.elapsed() < maxAge) {
+        return;
+    }
+
+    const qint64 elapsed = m_lastSample.isValid() ? m_lastSample.restart() : 0;
+    if (!m_lastSample.isValid()) {
+        m_lastSample.start();
+    }
+
+    sample({readFile(m_procPath + QStringLiteral("/stat")),
+            readFile(m_procPath + QStringLiteral("/meminfo")),
+            readFile(m_procPath + QStringLiteral("/loadavg")),
+            readFile(m_procPath + QStringLiteral("/net/dev"))},
+           elapsed);
+}
+
+void ProcSampler::sample(const Files &files, qint64 elapsed)
+{
+    parseStat(files.stat);
+    parseMemInfo(files.meminfo);
+    parseLoadAvg(files.loadavg);
+    parseNetDev(files.netdev, elapsed);
+}
+
+bool ProcSampler::contains(const QString &sensor) const
+{
+    return m_values.contains(sensor);
+}
+
+QString ProcSampler::value(const QString &sensor) const
+{
+    return m_values.value(sensor);
+}
+
+QStringList ProcSampler::sensors() const
+{
+    return m_values.keys();
+}
+
+void ProcSampler::parseStat(const QByteArray &stat)
+{
+    for (const QByteArray &line : stat.split('\n')) {
+        if (!line.startsWith("cpu")) {
+            continue;
+        }
+
+        const QList<QByteArray> values = fields(line);
+        if (values.count() < 9) {
+            continue;
+        }
+
+        // user nice system idle iowait irq softirq steal
+        QVector<qulonglong> times(8);
+        for (int i = 0; i < times.count(); ++i) {
+            times[i] = values.at(i + 1).toULongLong();
+        }
+
+        QVector<qulonglong> &previous = m_cpuTimes[values.first()];
+        if (previous.isEmpty()) {
+            previous = times;
+        }
+
+        QVector<qulonglong> delta(times.count());
+        qulonglong total = 0;
+        for (int i = 0; i < times.count(); ++i) {
+            delta[i] = times.at(i) >= previous.at(i) ? times.at(i) - previous.at(i) : 0;
+            total += delta.at(i);
+        }
+        previous = times;
+
+        const qulonglong user = delta.at(0);
+        const qulonglong nice = delta.at(1);
+        const qulonglong sys = delta.at(2) + delta.at(5) + delta.at(6) + delta.at(7);
+        const qulonglong idle = delta.at(3);
+        const qulonglong wait = delta.at(4);
+
+        // "cpu" is the sum of all of them, "cpu0" the first one
+        const QString prefix = values.first() == "cpu" ? QStringLiteral("cpu/system/") : QStringLiteral("cpu/%1/").arg(QString::fromLatin1(values.first()));
+        m_values.insert(prefix + QStringLiteral("user"), percent(user, total));
+        m_values.insert(prefix + QStringLiteral("nice"), percent(nice, total));
+        m_values.insert(prefix + QStringLiteral("sys"), percent(sys, total));
+        m_values.insert(prefix + QStringLiteral("idle"), percent(idle, total));
+        m_values.insert(prefix + QStringLiteral("wait"), percent(wait, total));
+        m_values.insert(prefix + QStringLiteral("TotalLoad"), percent(user + nice + sys, total));
+    }
+}
+
+void ProcSampler::parseMemInfo(const QByteArray &meminfo)
+{
+    QHash<QByteArray, qulonglong> kiB;
+    for (const QByteArray &line : meminfo.split('\n')) {
+        const int colon = line.indexOf(':');
+        if (colon > 0) {
+            kiB.insert(line.left(colon), fields(line.mid(colon + 1)).value(0).toULongLong());
+        }
+    }
+    if (kiB.isEmpty()) {
+        return;
+    }
+
+    const qulonglong total = kiB.value("MemTotal");
+    const qulonglong free = kiB.value("MemFree");
+    const qulonglong buffers = kiB.value("Buffers");
+    const qulonglong cached = kiB.value("Cached") + kiB.value("SReclaimable");
+    const qulonglong used = total - free;
+
+    m_values.insert(QStringLiteral("mem/physical/free"), QString::number(free));
+    m_values.insert(QStringLiteral("mem/physical/used"), QString::number(used));
+    m_values.insert(QStringLiteral("mem/physical/application"), QString::number(used > buffers + cached ? used - buffers - cached : 0));
+    m_values.insert(QStringLiteral("mem/physical/buf"), QString::number(buffers));
+    m_values.insert(QStringLiteral("mem/physical/cached"), QString::number(cached));
+    m_values.insert(QStringLiteral("mem/swap/free"), QString::number(kiB.value("SwapFree")));
+    m_values.insert(QStringLiteral("mem/swap/used"), QString::number(kiB.value("SwapTotal") - kiB.value("SwapFree")));
+}
+
+void ProcSampler::parseLoadAvg(const QByteArray &loadavg)
+{
+    const QList<QByteArray> values = fields(loadavg);
+    if (values.count() < 3) {
+        return;
+    }
+
+    m_values.insert(QStringLiteral("cpu/system/loadavg1"), QString::fromLatin1(values.at(0)));
+    m_values.insert(QStringLiteral("cpu/system/loadavg5"), QString::fromLatin1(values.at(1)));
+    m_values.insert(QStringLiteral("cpu/system/loadavg15"), QString::fromLatin1(values.at(2)));
+}
+
+void ProcSampler::parseNetDev(const QByteArray &netdev, qint64 elapsed)
+{
+    for (const QByteArray &line : netdev.split('\n')) {
+        // The first two lines are headers without a colon
+        const int colon = line.indexOf(':');
+        if (colon < 0) {
+            continue;
+        }
+
+        const QList<QByteArray> values = fields(line.mid(colon + 1));
+        if (values.count() < 10) {
+            continue;
+        }
+
+        // received bytes and packets, transmitted bytes and packets
+        const QVector<qulonglong> counters{values.at(0).toULongLong(), values.at(1).toULongLong(), values.at(8).toULongLong(), values.at(9).toULongLong()};
+
+        const QByteArray interface = line.left(colon).trimmed();
+        QVector<qulonglong> &previous = m_netCounters[interface];
+        if (previous.isEmpty()) {
+            previous = counters;
+        }
+
+        const QString prefix = QStringLiteral("network/interfaces/%1/").arg(QString::fromLatin1(interface));
+        m_values.insert(prefix + QStringLiteral("receiver/data"), rate(counters.at(0), previous.at(0), elapsed, 1024.0));
+        m_values.insert(prefix + QStringLiteral("receiver/packets"), rate(counters.at(1), previous.at(1), elapsed, 1.0));
+        m_values.insert(prefix + QStringLiteral("transmitter/data"), rate(counters.at(2), previous.at(2), elapsed, 1024.0));
+        m_values.insert(prefix + QStringLiteral("transmitter/packets"), rate(counters.at(3), previous.at(3), elapsed, 1.0));
+
+        previous = counters;
+    }
+}
@@ -0,0 +1,65 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-only
+*/
+
+#pragma once
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * Reads the values of the most used ksysguardd sensors straight from /proc.
+ *
+ * Every sample reads /proc/stat, /proc/meminfo, /proc/loadavg and /proc/net/dev once
+ * and computes the values of all CPU, load, memory and network sensors from them, so
+ * updating hundreds of sensors costs four file reads instead of a ksysguardd request
+ * each. Loads and rates are computed against the previous sample, like ksysguardd
+ * does. Values are formatted the way ksysguardd answers them.
+ */
+class ProcSampler
+{
+public:
+    struct Files {
+        QByteArray stat;
+        QByteArray meminfo;
+        QByteArray loadavg;
+        QByteArray netdev;
+    };
+
+    explicit ProcSampler(const QString &procPath = QStringLiteral("/proc"));
+
+    /**
+     * Takes a new sample unless the last one is younger than @p maxAge ms, so that
+     * sensors updated in the same interval share it
+     */
+    void update(int maxAge);
+
+    /**
+     * Takes a sample from the already read @p files, @p elapsed ms after the previous one
+     */
+    void sample(const Files &files, qint64 elapsed);
+
+    bool contains(const QString &sensor) const;
+    QString value(const QString &sensor) const;
+    QStringList sensors() const;
+
+private:
+    void parseStat(const QByteArray &stat);
+    void parseMemInfo(const QByteArray &meminfo);
+    void parseLoadAvg(const QByteArray &loadavg);
+    void parseNetDev(const QByteArray &netdev, qint64 elapsed);
+
+    QString m_procPath;
+    QElapsedTimer m_lastSample;
+    QHash<QString, QString> m_values;
+
+    // Counters of the previous sample
+    QHash<QByteArray, QVector<qulonglong>> m_cpuTimes;
+    QHash<QByteArray, QVector<qulonglong>> m_netCounters;
+};
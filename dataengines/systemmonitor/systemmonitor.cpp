@@ -16,6 +16,9 @@
 
 #include <ksgrd/SensorManager.h>
 
+// Sensors updated within this many ms share one sample of /proc
+static const int s_sampleMaxAge = 200;
+
 SystemMonitorEngine::SystemMonitorEngine(QObject *parent, const QVariantList &args)
     : Plasma::DataEngine(parent, args)
 {
@@ -49,13 +52,21 @@ bool SystemMonitorEngine::sourceRequestEvent(const QString &name)
 
 bool SystemMonitorEngine::updateSourceEvent(const QString &sensorName)
 {
-    const int index = m_sensors.indexOf(sensorName);
+    const int index = m_sensorIndexes.value(sensorName, -1);
+
+    if (index == -1) {
+        return false;
+    }
 
-    if (index != -1) {
-        KSGRD::SensorMgr->sendRequest(QStringLiteral("localhost"), sensorName, (KSGRD::SensorClient *)this, index);
-        KSGRD::SensorMgr->sendRequest(QStringLiteral("localhost"), QStringLiteral("%1?").arg(sensorName), (KSGRD::SensorClient *)this, -(index + 2));
+    // The sensor info got requested along with the list of sensors, it does not change
+    m_sampler.update(s_sampleMaxAge);
+    if (m_sampler.contains(sensorName)) {
+        setData(sensorName, QStringLiteral("value"), m_sampler.value(sensorName));
+        return true;
     }
 
+    KSGRD::SensorMgr->sendRequest(QStringLiteral("localhost"), sensorName, (KSGRD::SensorClient *)this, index);
+
     return false;
 }
 
@@ -113,6 +124,7 @@ void SystemMonitorEngine::answerReceived(int id, const QList<QByteArray> &answer
     if (id == -1) {
         QSet<QString> sensors;
         m_sensors.clear();
+        m_sensorIndexes.clear();
         int count = 0;
 
         foreach (const QByteArray &sens, answer) {
@@ -126,6 +138,7 @@ void SystemMonitorEngine::answerReceived(int id, const QList<QByteArray> &answer
 
             const QString newSensor = newSensorInfo[0].toString();
             sensors.insert(newSensor);
+            m_sensorIndexes.insert(newSensor, m_sensors.count());
             m_sensors.append(newSensor);
             {
                 // HACK: for backwards compatibility
@@ -10,9 +10,12 @@
 
 #include <ksgrd/SensorClient.h>
 
+#include <QHash>
 #include <QStringList>
 #include <QVector>
 
+#include "procsampler.h"
+
 class QTimer;
 
 /**
@@ -41,6 +44,9 @@ protected Q_SLOTS:
 
 private:
     QVector<QString> m_sensors;
+    QHash<QString, int> m_sensorIndexes;
+    // Answers the sensors it knows without asking ksysguardd
+    ProcSampler m_sampler;
     QTimer *m_timer;
     int m_waitingFor;
 };
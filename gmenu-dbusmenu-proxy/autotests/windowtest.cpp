@@ -0,0 +1,295 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include <QCoreApplication>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusPendingReply>
+#include <QElapsedTimer>
+#include <QProcess>
+#include <QSignalSpy>
+#include <QTest>
+
+#include "../libdbusmenuqt/dbusmenutypes_p.h"
+#include "gdbusmenutypes_p.h"
+#include "utils.h"
+#include "window.h"
+
+static const QString s_menuBarPath = QStringLiteral("/org/gtk/menubar");
+static const QString s_actionsPath = QStringLiteral("/org/gtk/app");
+
+// The org.gtk.Menus side of a GTK application
+class FakeMenus : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.gtk.Menus")
+
+public:
+    QHash<uint, GMenuItemList> subscriptions;
+
+    void change(uint subscription, uint menu, uint position, uint removeCount, const VariantMapList &insert)
+    {
+        const GMenuChangeList changes{{subscription, menu, position, removeCount, insert}};
+        for (GMenuItem &section : subscriptions[subscription]) {
+            if (section.section == menu) {
+                for (uint i = 0; i < removeCount; ++i) {
+                    section.items.removeAt(position);
+                }
+                for (int i = 0; i < insert.count(); ++i) {
+                    section.items.insert(position + i, insert.at(i));
+                }
+            }
+        }
+        Q_EMIT Changed(changes);
+    }
+
+public Q_SLOTS:
+    GMenuItemList Start(const QList<uint> &ids)
+    {
+        GMenuItemList ret;
+        for (uint id : ids) {
+            ret << subscriptions.value(id);
+        }
+        return ret;
+    }
+
+    void End(const QList<uint> &ids)
+    {
+        Q_UNUSED(ids)
+    }
+
+Q_SIGNALS:
+    void Changed(const GMenuChangeList &changes);
+};
+
+// The org.gtk.Actions side of a GTK application
+class FakeActions : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.gtk.Actions")
+
+public:
+    GMenuActionMap actions;
+
+public Q_SLOTS:
+    GMenuActionMap DescribeAll()
+    {
+        return actions;
+    }
+
+    void Activate(const QString &name, const QVariantList &parameter, const QVariantMap &platformData)
+    {
+        Q_UNUSED(name)
+        Q_UNUSED(parameter)
+        Q_UNUSED(platformData)
+    }
+
+Q_SIGNALS:
+    void Changed(const QStringList &removed, const StringBoolMap &enabledChanges, const QVariantMap &stateChanges, const GMenuActionMap &added);
+};
+
+class WindowTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void testGetLayout();
+    void testItemChanged();
+    void testSectionChanged();
+    void testActionChanged();
+    void benchmarkReplay();
+
+private:
+    DBusMenuLayoutItem layout(int parentId);
+    static QVariantMap item(const QString &label, const QString &action);
+    static QVariantMap link(const QString &type, uint subscription, uint menu);
+    static QStringList labels(const DBusMenuLayoutItem &layout);
+
+    QProcess m_bus;
+    FakeMenus m_menus;
+    FakeActions m_actions;
+    Window *m_window = nullptr;
+    int m_fileMenu = Utils::treeStructureToInt(1, 0, 0);
+    int m_viewMenu = Utils::treeStructureToInt(2, 0, 0);
+};
+
+QVariantMap WindowTest::item(const QString &label, const QString &action)
+{
+    return {{QStringLiteral("label"), label}, {QStringLiteral("action"), action}};
+}
+
+QVariantMap WindowTest::link(const QString &type, uint subscription, uint menu)
+{
+    return {{type, QVariant::fromValue(GMenuSection{subscription, menu})}};
+}
+
+QStringList WindowTest::labels(const DBusMenuLayoutItem &layout)
+{
+    QStringList ret;
+    for (const DBusMenuLayoutItem &child : layout.children) {
+        ret << child.properties.value(QStringLiteral("label")).toString();
+    }
+    return ret;
+}
+
+DBusMenuLayoutItem WindowTest::layout(int parentId)
+{
+    // Asked over the bus like the global menu does, the proxy may defer its reply
+    QDBusMessage msg = QDBusMessage::createMethodCall(QDBusConnection::sessionBus().baseService(),
+                                                      m_window->proxyObjectPath(),
+                                                      QStringLiteral("com.canonical.dbusmenu"),
+                                                      QStringLiteral("GetLayout"));
+    msg << parentId << -1 << QStringList();
+    QDBusPendingReply<uint, DBusMenuLayoutItem> reply = QDBusConnection(QStringLiteral("client")).asyncCall(msg);
+
+    QElapsedTimer timer;
+    timer.start();
+    while (!reply.isFinished() && timer.elapsed() < 5000) {
+        QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents, 50);
+    }
+    if (!reply.isValid()) {
+        qWarning() << "GetLayout failed" << reply.error();
+        return DBusMenuLayoutItem();
+    }
+    return reply.argumentAt<1>();
+}
+
+void WindowTest::initTestCase()
+{
+    // Everything talks over a private bus, the proxy only knows about the session bus
+    m_bus.start(QStringLiteral("dbus-daemon"), {QStringLiteral("--session"), QStringLiteral("--nofork"), QStringLiteral("--print-address")});
+    if (!m_bus.waitForStarted() || !m_bus.waitForReadyRead()) {
+        QSKIP("Cannot run dbus-daemon");
+    }
+    qputenv("DBUS_SESSION_BUS_ADDRESS", m_bus.readLine().trimmed());
+    QVERIFY(QDBusConnection::sessionBus().isConnected());
+
+    GDBusMenuTypes_register();
+    DBusMenuTypes_register();
+
+    // A menu bar with a "File" menu made of two sections and a "View" menu with a checkbox
+    m_menus.subscriptions[0] = {{0, 0, {link(QStringLiteral(":submenu"), 1, 0), link(QStringLiteral(":submenu"), 2, 0)}}};
+    m_menus.subscriptions[0][0].items[0].insert(QStringLiteral("label"), QStringLiteral("_File"));
+    m_menus.subscriptions[0][0].items[1].insert(QStringLiteral("label"), QStringLiteral("_View"));
+    m_menus.subscriptions[1] = {
+        {1, 0, {link(QStringLiteral(":section"), 1, 1), link(QStringLiteral(":section"), 1, 2)}},
+        {1, 1, {item(QStringLiteral("New"), QStringLiteral("app.new")), item(QStringLiteral("Open"), QStringLiteral("app.open"))}},
+        {1, 2, {item(QStringLiteral("Quit"), QStringLiteral("app.quit"))}},
+    };
+    m_menus.subscriptions[2] = {{2, 0, {item(QStringLiteral("Word Wrap"), QStringLiteral("app.wrap"))}}};
+
+    for (const QString &action : {QStringLiteral("new"), QStringLiteral("open"), QStringLiteral("quit"), QStringLiteral("close")}) {
+        m_actions.actions.insert(action, GMenuAction{true, QDBusSignature(), {}});
+    }
+    m_actions.actions.insert(QStringLiteral("wrap"), GMenuAction{true, QDBusSignature(), {true}});
+
+    QDBusConnection app = QDBusConnection::connectToBus(QDBusConnection::SessionBus, QStringLiteral("app"));
+    QVERIFY(app.registerObject(s_menuBarPath, &m_menus, QDBusConnection::ExportAllSlots | QDBusConnection::ExportAllSignals));
+    QVERIFY(app.registerObject(s_actionsPath, &m_actions, QDBusConnection::ExportAllSlots | QDBusConnection::ExportAllSignals));
+    QVERIFY(QDBusConnection::connectToBus(QDBusConnection::SessionBus, QStringLiteral("client")).isConnected());
+
+    m_window = new Window(app.baseService());
+    m_window->setMenuBarObjectPath(s_menuBarPath);
+    m_window->setApplicationObjectPath(s_actionsPath);
+    QSignalSpy menuSpy(m_window, &Window::requestWriteWindowProperties);
+    m_window->init();
+    QVERIFY(menuSpy.wait());
+}
+
+void WindowTest::cleanupTestCase()
+{
+    delete m_window;
+    QDBusConnection::disconnectFromBus(QStringLiteral("app"));
+    QDBusConnection::disconnectFromBus(QStringLiteral("client"));
+    m_bus.terminate();
+    m_bus.waitForFinished();
+}
+
+void WindowTest::testGetLayout()
+{
+    QCOMPARE(labels(layout(0)), (QStringList{QStringLiteral("_File"), QStringLiteral("_View")}));
+
+    // Sections show up as separators followed by their items
+    const DBusMenuLayoutItem file = layout(m_fileMenu);
+    QCOMPARE(labels(file), (QStringList{QString(), QStringLiteral("New"), QStringLiteral("Open"), QString(), QStringLiteral("Quit")}));
+    QCOMPARE(file.children.at(0).properties.value(QStringLiteral("type")).toString(), QStringLiteral("separator"));
+    QCOMPARE(file.children.at(2).id, Utils::treeStructureToInt(1, 1, 2));
+
+    // Served again from what was translated before
+    QCOMPARE(labels(layout(m_fileMenu)), labels(file));
+}
+
+void WindowTest::testItemChanged()
+{
+    layout(m_fileMenu);
+
+    // Replacing an item in place, like LibreOffice does for its Undo entry
+    QSignalSpy propertiesSpy(m_window, &Window::ItemsPropertiesUpdated);
+    m_menus.change(1, 1, 1, 1, {item(QStringLiteral("Open Recent"), QStringLiteral("app.open"))});
+    QVERIFY(propertiesSpy.wait());
+
+    const auto items = propertiesSpy.first().at(0).value<DBusMenuItemList>();
+    QCOMPARE(items.count(), 1);
+    QCOMPARE(items.first().id, Utils::treeStructureToInt(1, 1, 2));
+    QCOMPARE(items.first().properties.value(QStringLiteral("label")).toString(), QStringLiteral("Open Recent"));
+
+    QCOMPARE(labels(layout(m_fileMenu)).at(2), QStringLiteral("Open Recent"));
+}
+
+void WindowTest::testSectionChanged()
+{
+    layout(m_fileMenu);
+
+    QSignalSpy layoutSpy(m_window, &Window::LayoutUpdated);
+    m_menus.change(1, 2, 0, 0, {item(QStringLiteral("Close"), QStringLiteral("app.close"))});
+    QVERIFY(layoutSpy.wait());
+    QCOMPARE(layoutSpy.first().at(1).toInt(), Utils::treeStructureToInt(1, 2, 0));
+
+    // The items after the inserted one moved, their ids now refer to other items
+    const QStringList fileLabels = labels(layout(m_fileMenu));
+    QCOMPARE(fileLabels.mid(3), (QStringList{QString(), QStringLiteral("Close"), QStringLiteral("Quit")}));
+
+    m_menus.change(1, 2, 0, 1, {});
+    QVERIFY(layoutSpy.wait());
+    QCOMPARE(labels(layout(m_fileMenu)).mid(3), (QStringList{QString(), QStringLiteral("Quit")}));
+}
+
+void WindowTest::testActionChanged()
+{
+    const DBusMenuLayoutItem view = layout(m_viewMenu);
+    QCOMPARE(view.children.first().properties.value(QStringLiteral("toggle-state")).toInt(), 1);
+
+    QSignalSpy propertiesSpy(m_window, &Window::ItemsPropertiesUpdated);
+    Q_EMIT m_actions.Changed({}, {}, {{QStringLiteral("wrap"), false}}, {});
+    QVERIFY(propertiesSpy.wait());
+
+    QCOMPARE(layout(m_viewMenu).children.first().properties.value(QStringLiteral("toggle-state")).toInt(), 0);
+
+    Q_EMIT m_actions.Changed({}, {{QStringLiteral("quit"), false}}, {}, {});
+    QVERIFY(propertiesSpy.wait());
+    QCOMPARE(layout(m_fileMenu).children.last().properties.value(QStringLiteral("enabled")).toBool(), false);
+}
+
+void WindowTest::benchmarkReplay()
+{
+    // An application updating a menu entry while the user opens the menus
+    QSignalSpy propertiesSpy(m_window, &Window::ItemsPropertiesUpdated);
+    int step = 0;
+
+    QBENCHMARK {
+        m_menus.change(1, 1, 0, 1, {item(QStringLiteral("New %1").arg(++step), QStringLiteral("app.new"))});
+        QVERIFY(propertiesSpy.wait());
+        QCOMPARE(labels(layout(m_fileMenu)).at(1), QStringLiteral("New %1").arg(step));
+        layout(m_viewMenu);
+        layout(0);
+    }
+}
+
+QTEST_GUILESS_MAIN(WindowTest)
+
+#include "windowtest.moc"
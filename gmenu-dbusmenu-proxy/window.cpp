@@ -230,9 +230,17 @@ void Window::menuItemsChanged(const QVector<uint> &itemIds)
     for (uint id : itemIds) {
         const auto newItem = m_currentMenu->getItem(id);
 
+        // An item which is or was a section brings in the items of another one
+        const bool wasSection = m_itemProperties.value(id).value(QStringLiteral("type")) == QLatin1String("separator");
+        if (wasSection || newItem.contains(QLatin1String(":section"))) {
+            invalidateSections({id - id % 1000});
+        }
+
+        m_itemProperties.remove(id);
+
         DBusMenuItem dBusItem{// 0 is menu, items start at 1
                               static_cast<int>(id),
-                              gMenuToDBusMenuProperties(newItem)};
+                              itemProperties(id, newItem)};
         items.append(dBusItem);
     }
 
@@ -245,13 +253,19 @@ void Window::menuChanged(const QVector<uint> &menuIds)
         return;
     }
 
+    invalidateSections(menuIds);
+
+    ++m_revision;
     for (uint menu : menuIds) {
-        Q_EMIT LayoutUpdated(3 /*revision*/, menu);
+        Q_EMIT LayoutUpdated(m_revision, menu);
     }
 }
 
 void Window::onMenuSubscribed(uint id)
 {
+    // Sections of the new subscription may have been referenced before they were known
+    m_layouts.clear();
+
     // When it was a delayed GetLayout request, send the reply now
     const auto pendingReplies = m_pendingGetLayouts.values(id);
     if (!pendingReplies.isEmpty()) {
@@ -269,7 +283,7 @@ void Window::onMenuSubscribed(uint id)
         }
         m_pendingGetLayouts.remove(id);
     } else {
-        Q_EMIT LayoutUpdated(2 /*revision*/, id);
+        Q_EMIT LayoutUpdated(++m_revision, id);
     }
 }
 
@@ -314,6 +328,13 @@ Actions *Window::getActionsForAction(const QString &name, QString &lookupName) c
 
 void Window::onActionsChanged(const QStringList &dirty, const QString &prefix)
 {
+    for (const QString &action : dirty) {
+        const QSet<int> ids = m_itemsForAction.take(prefix + action);
+        for (int id : ids) {
+            m_itemProperties.remove(id);
+        }
+    }
+
     if (m_applicationMenu) {
         m_applicationMenu->actionsChanged(dirty, prefix);
     }
@@ -367,7 +388,8 @@ void Window::updateWindowProperties()
 
     if (m_currentMenu != oldMenu) {
         // update entire menu now
-        Q_EMIT LayoutUpdated(4 /*revision*/, 0);
+        clearLayouts();
+        Q_EMIT LayoutUpdated(++m_revision, 0);
     }
 
     Q_EMIT requestWriteWindowProperties();
@@ -430,7 +452,15 @@ uint Window::GetLayout(int parentId, int recursionDepth, const QStringList &prop
         setDelayedReply(true);
 
         m_currentMenu->start(subscription);
-        return 1;
+        return m_revision;
+    }
+
+    if (index == 0) {
+        const auto it = m_layouts.constFind(parentId);
+        if (it != m_layouts.constEnd()) {
+            fillLayout(parentId, *it, dbusItem);
+            return m_revision;
+        }
     }
 
     bool ok;
@@ -463,19 +493,25 @@ uint Window::GetLayout(int parentId, int recursionDepth, const QStringList &prop
         }
     }
 
-    dbusItem.id = parentId; // TODO
-    dbusItem.properties = {{QStringLiteral("children-display"), QStringLiteral("submenu")}};
+    const Layout layout = translateLayout(parentId, section, sectionId);
+    m_layouts.insert(parentId, layout);
+    fillLayout(parentId, layout, dbusItem);
+
+    return m_revision;
+}
+
+Window::Layout Window::translateLayout(int parentId, const GMenuItem &section, int sectionId)
+{
+    Layout layout;
+    layout.sections.append(parentId);
 
     int count = 0;
 
     const auto itemsToBeAdded = section.items;
     for (const auto &item : itemsToBeAdded) {
-        DBusMenuLayoutItem child{
-            Utils::treeStructureToInt(section.id, sectionId, ++count),
-            gMenuToDBusMenuProperties(item),
-            {} // children
-        };
-        dbusItem.children.append(child);
+        const int id = Utils::treeStructureToInt(section.id, sectionId, ++count);
+        layout.children.append(id);
+        itemProperties(id, item);
 
         // Now resolve section aliases
         auto it = item.constFind(QStringLiteral(":section"));
@@ -487,6 +523,7 @@ uint Window::GetLayout(int parentId, int recursionDepth, const QStringList &prop
             // so updates signalled by the app will map to the right place
             int originalSubscription = gmenuSection.subscription;
             int originalMenu = gmenuSection.menu;
+            layout.sections.append(Utils::treeStructureToInt(originalSubscription, originalMenu, 0));
 
             // TODO start subscription if we don't have it
             auto items = m_currentMenu->getSection(gmenuSection.subscription, gmenuSection.menu).items;
@@ -502,23 +539,80 @@ uint Window::GetLayout(int parentId, int recursionDepth, const QStringList &prop
 
                     originalSubscription = gmenuSection2.subscription;
                     originalMenu = gmenuSection2.menu;
+                    layout.sections.append(Utils::treeStructureToInt(originalSubscription, originalMenu, 0));
                 }
             }
 
             int aliasedCount = 0;
             for (const auto &aliasedItem : qAsConst(items)) {
-                DBusMenuLayoutItem aliasedChild{
-                    Utils::treeStructureToInt(originalSubscription, originalMenu, ++aliasedCount),
-                    gMenuToDBusMenuProperties(aliasedItem),
-                    {} // children
-                };
-                dbusItem.children.append(aliasedChild);
+                const int aliasedId = Utils::treeStructureToInt(originalSubscription, originalMenu, ++aliasedCount);
+                layout.children.append(aliasedId);
+                itemProperties(aliasedId, aliasedItem);
             }
         }
     }
 
-    // revision, unused in libdbusmenuqt
-    return 1;
+    return layout;
+}
+
+void Window::fillLayout(int parentId, const Layout &layout, DBusMenuLayoutItem &dbusItem)
+{
+    dbusItem.id = parentId; // TODO
+    dbusItem.properties = {{QStringLiteral("children-display"), QStringLiteral("submenu")}};
+
+    dbusItem.children.reserve(layout.children.count());
+    for (int id : layout.children) {
+        const auto it = m_itemProperties.constFind(id);
+        dbusItem.children.append(DBusMenuLayoutItem{
+            id,
+            it != m_itemProperties.constEnd() ? *it : itemProperties(id, m_currentMenu->getItem(id)),
+            {} // children
+        });
+    }
+}
+
+QVariantMap Window::itemProperties(int id, const QVariantMap &item)
+{
+    auto it = m_itemProperties.find(id);
+    if (it == m_itemProperties.end()) {
+        // remember which items show an action, so they can be updated when it changes
+        const QString actionName = Utils::itemActionName(item);
+        if (!actionName.isEmpty()) {
+            m_itemsForAction[actionName].insert(id);
+        }
+        it = m_itemProperties.insert(id, gMenuToDBusMenuProperties(item));
+    }
+    return *it;
+}
+
+void Window::invalidateSections(const QVector<uint> &sections)
+{
+    for (auto it = m_layouts.begin(); it != m_layouts.end();) {
+        const bool outdated = std::any_of(it->sections.cbegin(), it->sections.cend(), [&sections](int section) {
+            return sections.contains(uint(section));
+        });
+        if (outdated) {
+            it = m_layouts.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // items moved around, their ids now refer to different items
+    for (auto it = m_itemProperties.begin(); it != m_itemProperties.end();) {
+        if (sections.contains(uint(it.key() - it.key() % 1000))) {
+            it = m_itemProperties.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void Window::clearLayouts()
+{
+    m_layouts.clear();
+    m_itemProperties.clear();
+    m_itemsForAction.clear();
 }
 
 QDBusVariant Window::GetProperty(int id, const QString &property)
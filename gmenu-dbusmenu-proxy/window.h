@@ -7,8 +7,10 @@
 #pragma once
 
 #include <QDBusContext>
+#include <QHash>
 #include <QMultiHash>
 #include <QObject>
+#include <QSet>
 #include <QString>
 #include <QVector>
 #include <QWindow> // for WId
@@ -82,6 +84,12 @@ Q_SIGNALS:
     void LayoutUpdated(uint revision, int parent);
 
 private:
+    // A menu as GetLayout serves it, kept up to date as the GMenu changes
+    struct Layout {
+        QVector<int> children; // ids of the items
+        QVector<int> sections; // the sections the items come from
+    };
+
     void initMenu();
 
     bool registerDBusObject();
@@ -99,6 +107,12 @@ private:
 
     QVariantMap gMenuToDBusMenuProperties(const QVariantMap &source) const;
 
+    Layout translateLayout(int parentId, const GMenuItem &section, int sectionId);
+    void fillLayout(int parentId, const Layout &layout, DBusMenuLayoutItem &dbusItem);
+    QVariantMap itemProperties(int id, const QVariantMap &item);
+    void invalidateSections(const QVector<uint> &sections);
+    void clearLayouts();
+
     WId m_winId = 0;
     QString m_serviceName; // original GMenu service (the gtk app)
 
@@ -114,6 +128,11 @@ private:
 
     QMultiHash<int, QDBusMessage> m_pendingGetLayouts;
 
+    uint m_revision = 1;
+    QHash<int, Layout> m_layouts;
+    QHash<int, QVariantMap> m_itemProperties;
+    QHash<QString, QSet<int>> m_itemsForAction;
+
     Menu *m_applicationMenu = nullptr;
     Menu *m_menuBar = nullptr;
 
@@ -0,0 +1,291 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <QDBusConnection>
+#include <QDBusContext>
+#include <QDBusMessage>
+#include <QDBusVariant>
+#include <QMenu>
+#include <QProcess>
+#include <QSignalSpy>
+#include <QTest>
+
+#include "dbusmenuimporter.h"
+#include "dbusmenutypes_p.h"
+
+static const QString s_path = QStringLiteral("/MenuBar");
+static const QString s_interface = QStringLiteral("com.canonical.dbusmenu");
+
+// An exporter with a File menu holding a Recent submenu, counting the calls it gets
+class FakeExporter : public QObject, protected QDBusContext
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "com.canonical.dbusmenu")
+
+public:
+    explicit FakeExporter(const QDBusConnection &connection)
+        : m_connection(connection)
+    {
+        addItem(0, -1, QString(), true);
+        addItem(1, 0, QStringLiteral("File"), true);
+        addItem(2, 1, QStringLiteral("Open"));
+        addItem(3, 1, QStringLiteral("Recent"), true);
+        addItem(4, 3, QStringLiteral("a.txt"));
+    }
+
+    void addItem(int id, int parentId, const QString &label, bool submenu = false)
+    {
+        QVariantMap properties;
+        if (!label.isEmpty()) {
+            properties.insert(QStringLiteral("label"), label);
+        }
+        if (submenu) {
+            properties.insert(QStringLiteral("children-display"), QStringLiteral("submenu"));
+        }
+        m_properties.insert(id, properties);
+        if (parentId >= 0) {
+            m_children[parentId] << id;
+        }
+    }
+
+    // Changes the layout of @p parentId and tells the importers about it
+    void changeLayout(int id, int parentId, const QString &label)
+    {
+        addItem(id, parentId, label);
+        ++m_revision;
+        m_connection.send(QDBusMessage::createSignal(s_path, s_interface, QStringLiteral("LayoutUpdated")) << m_revision << parentId);
+    }
+
+    // Keeps GetLayout from answering until release() is called
+    void hold()
+    {
+        m_holding = true;
+    }
+
+    void release()
+    {
+        m_holding = false;
+        for (const QDBusMessage &message : qAsConst(m_heldLayouts)) {
+            const DBusMenuLayoutItem item = layout(message.arguments().at(0).toInt(), message.arguments().at(1).toInt());
+            m_connection.send(message.createReply({m_revision, QVariant::fromValue(item)}));
+        }
+        m_heldLayouts.clear();
+    }
+
+    int heldLayouts() const
+    {
+        return m_heldLayouts.count();
+    }
+
+    QList<int> layoutCalls;
+    QList<int> layoutDepths;
+    QList<int> aboutToShowCalls;
+    QStringList events;
+
+public Q_SLOTS:
+    uint GetLayout(int parentId, int recursionDepth, const QStringList &propertyNames, DBusMenuLayoutItem &item)
+    {
+        Q_UNUSED(propertyNames)
+        layoutCalls << parentId;
+        layoutDepths << recursionDepth;
+        if (m_holding) {
+            setDelayedReply(true);
+            m_heldLayouts << message();
+            return 0;
+        }
+        item = layout(parentId, recursionDepth);
+        return m_revision;
+    }
+
+    bool AboutToShow(int id)
+    {
+        aboutToShowCalls << id;
+        return false;
+    }
+
+    void Event(int id, const QString &eventId, const QDBusVariant &data, uint timestamp)
+    {
+        Q_UNUSED(data)
+        Q_UNUSED(timestamp)
+        events << QStringLiteral("%1 %2").arg(eventId).arg(id);
+    }
+
+private:
+    DBusMenuLayoutItem layout(int id, int depth) const
+    {
+        DBusMenuLayoutItem item;
+        item.id = id;
+        item.properties = m_properties.value(id);
+        if (depth != 0) {
+            for (int child : m_children.value(id)) {
+                item.children << layout(child, depth - 1);
+            }
+        }
+        return item;
+    }
+
+    QDBusConnection m_connection;
+    QHash<int, QVariantMap> m_properties;
+    QHash<int, QList<int>> m_children;
+    uint m_revision = 1;
+    bool m_holding = false;
+    QList<QDBusMessage> m_heldLayouts;
+};
+
+class DBusMenuImporterTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+    void testPrefetch();
+    void testCacheHit();
+    void testCacheDisabled();
+    void testRevisionChange();
+
+private:
+    QMenu *submenu(int id) const;
+
+    QProcess m_bus;
+    FakeExporter *m_exporter = nullptr;
+    DBusMenuImporter *m_importer = nullptr;
+};
+
+void DBusMenuImporterTest::initTestCase()
+{
+    // Everything talks over a private bus, the importer only knows about the session bus
+    m_bus.start(QStringLiteral("dbus-daemon"), {QStringLiteral("--session"), QStringLiteral("--nofork"), QStringLiteral("--print-address")});
+    if (!m_bus.waitForStarted() || !m_bus.waitForReadyRead()) {
+        QSKIP("Cannot run dbus-daemon");
+    }
+    qputenv("DBUS_SESSION_BUS_ADDRESS", m_bus.readLine().trimmed());
+    QVERIFY(QDBusConnection::sessionBus().isConnected());
+
+    DBusMenuTypes_register();
+}
+
+void DBusMenuImporterTest::cleanupTestCase()
+{
+    m_bus.terminate();
+    m_bus.waitForFinished();
+}
+
+void DBusMenuImporterTest::init()
+{
+    QDBusConnection exporter = QDBusConnection::connectToBus(QDBusConnection::SessionBus, QStringLiteral("exporter"));
+    m_exporter = new FakeExporter(exporter);
+    QVERIFY(exporter.registerObject(s_path, m_exporter, QDBusConnection::ExportAllSlots));
+
+    m_importer = new DBusMenuImporter(exporter.baseService(), s_path);
+    m_importer->setPrefetchDepth(1);
+    m_importer->setLayoutCacheEnabled(true);
+
+    QSignalSpy updateSpy(m_importer, &DBusMenuImporter::menuUpdated);
+    QVERIFY(updateSpy.wait());
+}
+
+void DBusMenuImporterTest::cleanup()
+{
+    delete m_importer;
+    delete m_exporter;
+    QDBusConnection::disconnectFromBus(QStringLiteral("exporter"));
+}
+
+QMenu *DBusMenuImporterTest::submenu(int id) const
+{
+    QAction *action = m_importer->actionForId(id);
+    return action ? action->menu() : nullptr;
+}
+
+void DBusMenuImporterTest::testPrefetch()
+{
+    // The prefetch depth set after construction applies to the first layout already
+    QCOMPARE(m_exporter->layoutCalls, QList<int>{0});
+    QCOMPARE(m_exporter->layoutDepths, QList<int>{2});
+
+    QMenu *file = submenu(1);
+    QVERIFY(file);
+    QCOMPARE(file->actions().count(), 2);
+
+    // Recent is one level too deep to come along with the menu bar
+    QMenu *recent = submenu(3);
+    QVERIFY(recent);
+    QVERIFY(recent->actions().isEmpty());
+}
+
+void DBusMenuImporterTest::testCacheHit()
+{
+    QSignalSpy updateSpy(m_importer, &DBusMenuImporter::menuUpdated);
+
+    // File came along with the menu bar and is shown without waiting
+    QMenu *file = submenu(1);
+    m_importer->updateMenu(file);
+    QCOMPARE(updateSpy.count(), 1);
+    QCOMPARE(updateSpy.first().at(0).value<QMenu *>(), file);
+
+    // The exporter gets told anyway, and as it did not change the menu, there is nothing to fetch
+    QTRY_COMPARE(m_exporter->events, QStringList{QStringLiteral("opened 1")});
+    QCOMPARE(m_exporter->aboutToShowCalls, QList<int>{1});
+    QTest::qWait(100);
+    QCOMPARE(m_exporter->layoutCalls.count(), 1);
+    QCOMPARE(updateSpy.count(), 1);
+
+    // Recent was not fetched yet, so it waits for its layout
+    updateSpy.clear();
+    QMenu *recent = submenu(3);
+    m_importer->updateMenu(recent);
+    QCOMPARE(updateSpy.count(), 0);
+    QVERIFY(updateSpy.wait());
+    QCOMPARE(m_exporter->layoutCalls.last(), 3);
+    QCOMPARE(recent->actions().count(), 1);
+
+    // and is cached from now on
+    updateSpy.clear();
+    m_importer->updateMenu(recent);
+    QCOMPARE(updateSpy.count(), 1);
+}
+
+void DBusMenuImporterTest::testCacheDisabled()
+{
+    m_importer->setLayoutCacheEnabled(false);
+    QSignalSpy updateSpy(m_importer, &DBusMenuImporter::menuUpdated);
+
+    m_importer->updateMenu(submenu(1));
+    QCOMPARE(updateSpy.count(), 0);
+    QVERIFY(updateSpy.wait());
+    QCOMPARE(m_exporter->aboutToShowCalls, QList<int>{1});
+}
+
+void DBusMenuImporterTest::testRevisionChange()
+{
+    QSignalSpy updateSpy(m_importer, &DBusMenuImporter::menuUpdated);
+    QMenu *file = submenu(1);
+
+    // Once the importer learns about the new revision, the cached layout is gone
+    m_exporter->hold();
+    m_exporter->changeLayout(5, 1, QStringLiteral("Save"));
+    QTRY_COMPARE(m_exporter->heldLayouts(), 1);
+    QCOMPARE(m_exporter->layoutCalls.last(), 1);
+
+    m_importer->updateMenu(file);
+    QCOMPARE(updateSpy.count(), 0);
+
+    m_exporter->release();
+    QTRY_COMPARE(file->actions().count(), 3);
+    QVERIFY(updateSpy.count() > 0);
+
+    // The new layout is cached again
+    updateSpy.clear();
+    m_importer->updateMenu(file);
+    QCOMPARE(updateSpy.count(), 1);
+}
+
+QTEST_MAIN(DBusMenuImporterTest)
+
+#include "dbusmenuimportertest.moc"
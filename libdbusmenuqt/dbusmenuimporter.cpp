@@ -15,11 +15,12 @@
 #include <QDBusReply>
 #include <QDBusVariant>
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QFont>
+#include <QHash>
 #include <QMenu>
 #include <QPointer>
 #include <QSet>
-#include <QTime>
 #include <QTimer>
 #include <QToolButton>
 #include <QWidgetAction>
@@ -32,11 +33,6 @@
 // Generated
 #include "dbusmenu_interface.h"
 
-//#define BENCHMARK
-#ifdef BENCHMARK
-static QTime sChrono;
-#endif
-
 #define DMRETURN_IF_FAIL(cond)                                                                                                                                 \
     if (!(cond)) {                                                                                                                                             \
         qCWarning(DBUSMENUQT) << "Condition failed: " #cond;                                                                                                   \
@@ -77,9 +73,22 @@ public:
     QSet<int> m_idsRefreshedByAboutToShow;
     QSet<int> m_pendingLayoutUpdates;
 
+    int m_prefetchDepth = 0;
+    bool m_layoutCacheEnabled = false;
+    // Revision each menu was fetched at, for menus whose layout is still current
+    QHash<int, uint> m_layoutRevisions;
+    // Menus which got shown from the cache before AboutToShow returned
+    QSet<int> m_idsShownFromCache;
+
+    struct PendingOpen {
+        QElapsedTimer timer;
+        int calls = 0;
+    };
+    QHash<int, PendingOpen> m_pendingOpens;
+
     QDBusPendingCallWatcher *refresh(int id)
     {
-        auto call = m_interface->GetLayout(id, 1, QStringList());
+        auto call = m_interface->GetLayout(id, 1 + m_prefetchDepth, QStringList());
         QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(call, q);
         watcher->setProperty(DBUSMENU_PROPERTY_ID, id);
         QObject::connect(watcher, &QDBusPendingCallWatcher::finished, q, &DBusMenuImporter::slotGetLayoutFinished);
@@ -250,6 +259,67 @@ public:
         return action->menu();
     }
 
+    /**
+     * Forget the cached layout of menu @p id and of its submenus, unless it was
+     * fetched after @p revision
+     */
+    void invalidateLayout(int id, uint revision)
+    {
+        const auto it = m_layoutRevisions.constFind(id);
+        if (it != m_layoutRevisions.constEnd() && *it > revision) {
+            return;
+        }
+        forgetLayout(id);
+    }
+
+    void forgetLayout(int id)
+    {
+        m_layoutRevisions.remove(id);
+        QMenu *menu = menuForId(id);
+        if (!menu) {
+            return;
+        }
+        const auto actions = menu->actions();
+        for (QAction *action : actions) {
+            if (action->menu()) {
+                forgetLayout(action->property(DBUSMENU_PROPERTY_ID).toInt());
+            }
+        }
+    }
+
+    void startOpen(int id)
+    {
+        PendingOpen &open = m_pendingOpens[id];
+        open.timer.start();
+        open.calls = 0;
+    }
+
+    void countCall(int id)
+    {
+        auto it = m_pendingOpens.find(id);
+        if (it != m_pendingOpens.end()) {
+            ++it->calls;
+        }
+    }
+
+    /**
+     * Emits menuUpdated() for @p menu, and reports how long it took if it was being opened
+     */
+    void finishOpen(int id, QMenu *menu)
+    {
+        auto it = m_pendingOpens.find(id);
+        if (it != m_pendingOpens.end()) {
+            qCDebug(DBUSMENUQT) << "Menu" << id << "updated after" << it->timer.elapsed() << "ms and" << it->calls << "D-Bus calls";
+            m_pendingOpens.erase(it);
+        }
+        Q_EMIT q->menuUpdated(menu);
+    }
+
+    /**
+     * Turns the actions of @p menu into the children of @p rootItem, which holds @p depth levels of submenus
+     */
+    void updateLayout(QMenu *menu, const DBusMenuLayoutItem &rootItem, uint revision, int depth);
+
     void slotItemsPropertiesUpdated(const DBusMenuItemList &updatedList, const DBusMenuItemKeysList &removedList);
 
     void sendEvent(int id, const QString &eventId)
@@ -281,7 +351,10 @@ DBusMenuImporter::DBusMenuImporter(const QString &service, const QString &path,
                 d->slotItemsPropertiesUpdated(updatedList, removedList);
             });
 
-    d->refresh(0);
+    // Deferred, so that the prefetch depth set right after construction applies
+    QTimer::singleShot(0, this, [this]() {
+        d->refresh(0);
+    });
 }
 
 DBusMenuImporter::~DBusMenuImporter()
@@ -295,7 +368,7 @@ DBusMenuImporter::~DBusMenuImporter()
 
 void DBusMenuImporter::slotLayoutUpdated(uint revision, int parentId)
 {
-    Q_UNUSED(revision)
+    d->invalidateLayout(parentId, revision);
     if (d->m_idsRefreshedByAboutToShow.remove(parentId)) {
         return;
     }
@@ -314,6 +387,26 @@ void DBusMenuImporter::processPendingLayoutUpdates()
     }
 }
 
+void DBusMenuImporter::setPrefetchDepth(int depth)
+{
+    d->m_prefetchDepth = qMax(0, depth);
+}
+
+int DBusMenuImporter::prefetchDepth() const
+{
+    return d->m_prefetchDepth;
+}
+
+void DBusMenuImporter::setLayoutCacheEnabled(bool enabled)
+{
+    d->m_layoutCacheEnabled = enabled;
+}
+
+bool DBusMenuImporter::isLayoutCacheEnabled() const
+{
+    return d->m_layoutCacheEnabled;
+}
+
 QMenu *DBusMenuImporter::menu() const
 {
     if (!d->m_menu) {
@@ -373,21 +466,29 @@ void DBusMenuImporter::slotGetLayoutFinished(QDBusPendingCallWatcher *watcher)
     if (!reply.isValid()) {
         qDebug(DBUSMENUQT) << reply.error().message();
         if (menu) {
-            Q_EMIT menuUpdated(menu);
+            d->finishOpen(parentId, menu);
+        } else {
+            d->m_pendingOpens.remove(parentId);
         }
         return;
     }
 
-#ifdef BENCHMARK
-    DMDEBUG << "- items received:" << sChrono.elapsed() << "ms";
-#endif
+    uint revision = reply.argumentAt<0>();
     DBusMenuLayoutItem rootItem = reply.argumentAt<1>();
 
     if (!menu) {
         qDebug(DBUSMENUQT) << "No menu for id" << parentId;
+        d->m_pendingOpens.remove(parentId);
         return;
     }
 
+    d->updateLayout(menu, rootItem, revision, 1 + d->m_prefetchDepth);
+
+    d->finishOpen(parentId, menu);
+}
+
+void DBusMenuImporterPrivate::updateLayout(QMenu *menu, const DBusMenuLayoutItem &rootItem, uint revision, int depth)
+{
     // remove outdated actions
     QSet<int> newDBusMenuItemIds;
     newDBusMenuItemIds.reserve(rootItem.children.count());
@@ -404,31 +505,33 @@ void DBusMenuImporter::slotGetLayoutFinished(QDBusPendingCallWatcher *watcher)
             if (action->menu()) {
                 action->menu()->deleteLater();
             }
-            d->m_actionForId.remove(id);
+            m_actionForId.remove(id);
+            m_layoutRevisions.remove(id);
         }
     }
 
     // insert or update new actions into our menu
     for (const DBusMenuLayoutItem &dbusMenuItem : qAsConst(rootItem.children)) {
-        DBusMenuImporterPrivate::ActionForId::Iterator it = d->m_actionForId.find(dbusMenuItem.id);
+        ActionForId::Iterator it = m_actionForId.find(dbusMenuItem.id);
         QAction *action = nullptr;
-        if (it == d->m_actionForId.end()) {
+        if (it == m_actionForId.end()) {
             int id = dbusMenuItem.id;
-            action = d->createAction(id, dbusMenuItem.properties, menu);
-            d->m_actionForId.insert(id, action);
+            action = createAction(id, dbusMenuItem.properties, menu);
+            m_actionForId.insert(id, action);
 
-            connect(action, &QObject::destroyed, this, [this, id]() {
-                d->m_actionForId.remove(id);
+            QObject::connect(action, &QObject::destroyed, q, [this, id]() {
+                m_actionForId.remove(id);
+                m_layoutRevisions.remove(id);
             });
 
-            connect(action, &QAction::triggered, this, [id, this]() {
-                sendClickedEvent(id);
+            QObject::connect(action, &QAction::triggered, q, [id, this]() {
+                q->sendClickedEvent(id);
             });
 
             if (QMenu *menuAction = action->menu()) {
-                connect(menuAction, &QMenu::aboutToShow, this, &DBusMenuImporter::slotMenuAboutToShow, Qt::UniqueConnection);
+                QObject::connect(menuAction, &QMenu::aboutToShow, q, &DBusMenuImporter::slotMenuAboutToShow, Qt::UniqueConnection);
             }
-            connect(menu, &QMenu::aboutToHide, this, &DBusMenuImporter::slotMenuAboutToHide, Qt::UniqueConnection);
+            QObject::connect(menu, &QMenu::aboutToHide, q, &DBusMenuImporter::slotMenuAboutToHide, Qt::UniqueConnection);
 
             menu->addAction(action);
         } else {
@@ -437,14 +540,24 @@ void DBusMenuImporter::slotGetLayoutFinished(QDBusPendingCallWatcher *watcher)
             filteredKeys.removeOne("type");
             filteredKeys.removeOne("toggle-type");
             filteredKeys.removeOne("children-display");
-            d->updateAction(*it, dbusMenuItem.properties, filteredKeys);
+            updateAction(*it, dbusMenuItem.properties, filteredKeys);
             // Move the action to the tail so we can keep the order same as the dbus request.
             menu->removeAction(action);
             menu->addAction(action);
         }
+
+        // Prefetched submenus
+        if (depth > 1 && action->menu()) {
+            updateLayout(action->menu(), dbusMenuItem, revision, depth - 1);
+        }
     }
 
-    Q_EMIT menuUpdated(menu);
+    // Empty menus may be populated in AboutToShow, always ask for them
+    if (rootItem.children.isEmpty()) {
+        m_layoutRevisions.remove(rootItem.id);
+    } else {
+        m_layoutRevisions.insert(rootItem.id, revision);
+    }
 }
 
 void DBusMenuImporter::sendClickedEvent(int id)
@@ -466,6 +579,18 @@ void DBusMenuImporter::updateMenu(QMenu *menu)
 
     int id = action->property(DBUSMENU_PROPERTY_ID).toInt();
 
+    d->startOpen(id);
+
+    if (d->m_layoutCacheEnabled && d->m_layoutRevisions.contains(id)) {
+        // Nothing changed since the menu was fetched, show it right away.
+        // The exporter still gets told, in case it populates the menu when it is about to be shown.
+        d->m_idsShownFromCache << id;
+        d->finishOpen(id, menu);
+    } else {
+        d->m_idsShownFromCache.remove(id);
+        d->countCall(id);
+    }
+
     auto call = d->m_interface->AboutToShow(id);
     QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(call, this);
     watcher->setProperty(DBUSMENU_PROPERTY_ID, id);
@@ -480,15 +605,20 @@ void DBusMenuImporter::slotAboutToShowDBusCallFinished(QDBusPendingCallWatcher *
     int id = watcher->property(DBUSMENU_PROPERTY_ID).toInt();
     watcher->deleteLater();
 
+    const bool shownFromCache = d->m_idsShownFromCache.remove(id);
+
     QMenu *menu = d->menuForId(id);
     if (!menu) {
+        d->m_pendingOpens.remove(id);
         return;
     }
 
     QDBusPendingReply<bool> reply = *watcher;
     if (reply.isError()) {
         qDebug(DBUSMENUQT) << "Call to AboutToShow() failed:" << reply.error().message();
-        Q_EMIT menuUpdated(menu);
+        if (!shownFromCache) {
+            d->finishOpen(id, menu);
+        }
         return;
     }
     // Note, this isn't used by Qt's QPT - but we get a LayoutChanged emitted before
@@ -497,9 +627,10 @@ void DBusMenuImporter::slotAboutToShowDBusCallFinished(QDBusPendingCallWatcher *
 
     if (needRefresh || menu->actions().isEmpty()) {
         d->m_idsRefreshedByAboutToShow << id;
+        d->countCall(id);
         d->refresh(id);
-    } else if (menu) {
-        Q_EMIT menuUpdated(menu);
+    } else if (!shownFromCache) {
+        d->finishOpen(id, menu);
     }
 }
 
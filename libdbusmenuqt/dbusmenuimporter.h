@@ -38,6 +38,25 @@ public:
      */
     QMenu *menu() const;
 
+    /**
+     * Number of submenu levels fetched along with a menu, so that they are
+     * populated before they get opened. Defaults to 0, only fetching the
+     * items of the menu itself.
+     */
+    void setPrefetchDepth(int depth);
+    int prefetchDepth() const;
+
+    /**
+     * Whether menus whose layout did not change since it was last fetched
+     * are shown right away, without waiting for the exporter.
+     *
+     * The exporter still receives AboutToShow, and if it changes the menu
+     * in response, menuUpdated() is emitted again once the new layout
+     * arrived. Disabled by default.
+     */
+    void setLayoutCacheEnabled(bool enabled);
+    bool isLayoutCacheEnabled() const;
+
 public Q_SLOTS:
     /**
      * Load the menu
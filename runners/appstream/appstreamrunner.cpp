@@ -7,21 +7,191 @@
 #include "appstreamrunner.h"
 
 #include <AppStreamQt/icon.h>
+#include <AppStreamQt/pool.h>
 
 #include <QDebug>
 #include <QDesktopServices>
 #include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
 #include <QIcon>
-#include <QTimer>
+#include <QMap>
+#include <QRegularExpression>
+#include <QtConcurrent>
 
 #include <KApplicationTrader>
 #include <KLocalizedString>
 #include <KSycoca>
 
+#include <algorithm>
+#include <iterator>
+
 #include "debug.h"
 
 K_PLUGIN_CLASS_WITH_JSON(InstallerRunner, "plasma-runner-appstream.json")
 
+// Where the distributions put their AppStream catalogs and the pool its cache
+static const QStringList s_catalogDirs = {
+    QStringLiteral("/usr/share/swcatalog"),
+    QStringLiteral("/usr/share/app-info"),
+    QStringLiteral("/usr/share/metainfo"),
+    QStringLiteral("/var/lib/swcatalog"),
+    QStringLiteral("/var/lib/app-info"),
+    QStringLiteral("/var/cache/swcatalog"),
+    QStringLiteral("/var/cache/app-info"),
+};
+
+static const int s_reloadDelay = 5000; // ms, catalogs are usually updated file by file
+
+/**
+ * @returns the existing catalog directories and the ones right below them which hold
+ * the actual catalogs, like xml/, yaml/ or cache/; the icons are of no interest
+ */
+static QStringList catalogDirectories()
+{
+    QStringList dirs;
+    for (const QString &dir : s_catalogDirs) {
+        if (!QFileInfo::exists(dir)) {
+            continue;
+        }
+        dirs << dir;
+        QDirIterator it(dir, QDir::Dirs | QDir::NoDotAndDotDot);
+        while (it.hasNext()) {
+            it.next();
+            if (it.fileName() != QLatin1String("icons")) {
+                dirs << it.filePath();
+            }
+        }
+    }
+    return dirs;
+}
+
+/**
+ * @returns when the catalogs were last changed, in ms since the epoch
+ *
+ * Adding, removing or renaming a catalog touches its directory. The few catalogs in the
+ * subdirectories are also looked at themselves, as they may get rewritten in place.
+ */
+static qint64 catalogTimestamp()
+{
+    qint64 newest = 0;
+    for (const QString &dir : catalogDirectories()) {
+        newest = qMax(newest, QFileInfo(dir).lastModified().toMSecsSinceEpoch());
+        if (s_catalogDirs.contains(dir)) {
+            continue;
+        }
+        const QFileInfoList catalogs = QDir(dir).entryInfoList(QDir::Files);
+        for (const QFileInfo &catalog : catalogs) {
+            newest = qMax(newest, catalog.lastModified().toMSecsSinceEpoch());
+        }
+    }
+    return newest;
+}
+
+/**
+ * Token index over the names, summaries and keywords of the desktop applications in the AppStream pool
+ */
+struct ComponentIndex {
+    struct Entry {
+        AppStream::Component component;
+        QString lowerName;
+    };
+
+    QVector<Entry> entries;
+    // lower-cased token -> entries containing it, sorted so that prefixes can be looked up
+    QMap<QString, QVector<int>> tokens;
+
+    static QStringList tokenize(const QString &text)
+    {
+        static const QRegularExpression separators(QStringLiteral("\\W+"), QRegularExpression::UseUnicodePropertiesOption);
+        return text.toLower().split(separators, Qt::SkipEmptyParts);
+    }
+
+    static std::shared_ptr<const ComponentIndex> load()
+    {
+        AppStream::Pool pool;
+        QString error;
+        if (!pool.load(&error)) {
+            qCWarning(RUNNER_APPSTREAM) << "Had errors when loading AppStream metadata pool" << error;
+        }
+
+        auto index = std::make_shared<ComponentIndex>();
+        const QList<AppStream::Component> components = pool.components();
+        for (const AppStream::Component &component : components) {
+            if (component.kind() != AppStream::Component::KindDesktopApp) {
+                continue;
+            }
+
+            const int row = index->entries.size();
+            index->entries.append({component, component.name().toLower()});
+
+            QStringList componentTokens = tokenize(component.name()) + tokenize(component.summary());
+            const QStringList keywords = component.keywords();
+            for (const QString &keyword : keywords) {
+                componentTokens += tokenize(keyword);
+            }
+            componentTokens.removeDuplicates();
+            for (const QString &token : qAsConst(componentTokens)) {
+                index->tokens[token].append(row);
+            }
+        }
+
+        qCDebug(RUNNER_APPSTREAM) << "Indexed" << index->entries.size() << "components with" << index->tokens.size() << "tokens";
+        return index;
+    }
+
+    /**
+     * @returns the entries having, for every word of @p query, a token starting with it; best matches first
+     */
+    QVector<int> search(const QString &query) const
+    {
+        const QStringList words = tokenize(query);
+        if (words.isEmpty()) {
+            return {};
+        }
+
+        QVector<int> result;
+        for (int i = 0; i < words.size(); ++i) {
+            const QString &word = words.at(i);
+            QVector<int> rows;
+            for (auto it = tokens.lowerBound(word); it != tokens.cend() && it.key().startsWith(word); ++it) {
+                rows += it.value();
+            }
+            std::sort(rows.begin(), rows.end());
+            rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+            if (i == 0) {
+                result = rows;
+            } else {
+                QVector<int> intersection;
+                std::set_intersection(result.cbegin(), result.cend(), rows.cbegin(), rows.cend(), std::back_inserter(intersection));
+                result = intersection;
+            }
+            if (result.isEmpty()) {
+                break;
+            }
+        }
+
+        // the whole name first, then names starting with the query, then names containing it
+        const QString lowerQuery = query.toLower();
+        auto score = [this, &lowerQuery](int row) {
+            const QString &name = entries.at(row).lowerName;
+            if (name == lowerQuery) {
+                return 0;
+            } else if (name.startsWith(lowerQuery)) {
+                return 1;
+            } else if (name.contains(lowerQuery)) {
+                return 2;
+            }
+            return 3;
+        };
+        std::stable_sort(result.begin(), result.end(), [&score](int a, int b) {
+            return score(a) < score(b);
+        });
+        return result;
+    }
+};
+
 InstallerRunner::InstallerRunner(QObject *parent, const KPluginMetaData &metaData, const QVariantList &args)
     : Plasma::AbstractRunner(parent, metaData, args)
 {
@@ -31,10 +201,93 @@ InstallerRunner::InstallerRunner(QObject *parent, const KPluginMetaData &metaDat
 
     addSyntax(Plasma::RunnerSyntax(":q:", i18n("Looks for non-installed components according to :q:")));
     setMinLetterCount(3);
+
+    // Load the pool in the background as soon as a query session starts, then keep it around
+    // until the catalogs change, also those the watcher cannot see like newly created directories
+    connect(this, &Plasma::AbstractRunner::prepare, this, [this]() {
+        QMutexLocker locker(&m_indexMutex);
+        if (!m_indexFuture.isFinished()) {
+            return;
+        }
+        const bool loaded = bool(m_index);
+        const qint64 timestamp = m_indexTimestamp;
+        locker.unlock();
+        if (!loaded || timestamp != catalogTimestamp()) {
+            reloadIndex();
+        }
+    });
+
+    m_reloadTimer.setSingleShot(true);
+    m_reloadTimer.setInterval(s_reloadDelay);
+    connect(&m_reloadTimer, &QTimer::timeout, this, &InstallerRunner::reloadIndex);
+
+    watchCatalogs();
+    connect(&m_catalogWatcher, &QFileSystemWatcher::directoryChanged, this, [this]() {
+        // a new subdirectory may have shown up
+        watchCatalogs();
+        m_reloadTimer.start();
+    });
 }
 
 InstallerRunner::~InstallerRunner()
 {
+    QMutexLocker locker(&m_indexMutex);
+    QFuture<void> future = m_indexFuture;
+    locker.unlock();
+    future.waitForFinished();
+}
+
+void InstallerRunner::watchCatalogs()
+{
+    const QStringList watched = m_catalogWatcher.directories();
+    for (const QString &dir : catalogDirectories()) {
+        if (!watched.contains(dir)) {
+            m_catalogWatcher.addPath(dir);
+        }
+    }
+}
+
+void InstallerRunner::reloadIndex()
+{
+    QMutexLocker locker(&m_indexMutex);
+    if (!m_indexFuture.isFinished()) {
+        // try again once the current one is done
+        m_reloadTimer.start();
+        return;
+    }
+
+    m_indexFuture = QtConcurrent::run([this]() {
+        // taken before loading, so changes made meanwhile cause another reload
+        const qint64 timestamp = catalogTimestamp();
+        auto index = ComponentIndex::load();
+        QMutexLocker locker(&m_indexMutex);
+        m_index = std::move(index);
+        m_indexTimestamp = timestamp;
+    });
+}
+
+std::shared_ptr<const ComponentIndex> InstallerRunner::index()
+{
+    QMutexLocker locker(&m_indexMutex);
+    if (!m_index) {
+        QFuture<void> future = m_indexFuture;
+        locker.unlock();
+        future.waitForFinished();
+        locker.relock();
+    }
+
+    if (!m_index) {
+        // nobody started loading it yet
+        locker.unlock();
+        const qint64 timestamp = catalogTimestamp();
+        auto index = ComponentIndex::load();
+        locker.relock();
+        if (!m_index) {
+            m_index = std::move(index);
+            m_indexTimestamp = timestamp;
+        }
+    }
+    return m_index;
 }
 
 static QIcon componentIcon(const AppStream::Component &comp)
@@ -68,12 +321,6 @@ static QIcon componentIcon(const AppStream::Component &comp)
 
 void InstallerRunner::match(Plasma::RunnerContext &context)
 {
-    // Give the other runners a bit of time to produce results
-    QEventLoop loop;
-    QTimer::singleShot(200, &loop, [&loop]() {
-        loop.quit();
-    });
-    loop.exec();
     if (!context.isValid()) {
         return;
     }
@@ -87,11 +334,11 @@ void InstallerRunner::match(Plasma::RunnerContext &context)
         }
     }
 
-    const auto components = findComponentsByString(context.query()).mid(0, 3);
+    const std::shared_ptr<const ComponentIndex> components = index();
+    const QVector<int> rows = components->search(context.query()).mid(0, 3);
 
-    for (const AppStream::Component &component : components) {
-        if (component.kind() != AppStream::Component::KindDesktopApp)
-            continue;
+    for (int row : rows) {
+        const AppStream::Component &component = components->entries.at(row).component;
 
         // KApplicationTrader uses KService which uses KSycoca which holds
         // KDirWatch instances to monitor changes. We don't need this on
@@ -138,22 +385,4 @@ void InstallerRunner::run(const Plasma::RunnerContext & /*context*/, const Plasm
         qCWarning(RUNNER_APPSTREAM) << "couldn't open" << appstreamUrl;
 }
 
-QList<AppStream::Component> InstallerRunner::findComponentsByString(const QString &query)
-{
-    QMutexLocker locker(&m_appstreamMutex);
-    QString error;
-    static bool warnedOnce = false;
-    static bool opened = m_db.load(&error);
-    if (!opened) {
-        if (warnedOnce) {
-            qCDebug(RUNNER_APPSTREAM) << "Had errors when loading AppStream metadata pool" << error;
-        } else {
-            qCWarning(RUNNER_APPSTREAM) << "Had errors when loading AppStream metadata pool" << error;
-            warnedOnce = true;
-        }
-    }
-
-    return m_db.search(query);
-}
-
 #include "appstreamrunner.moc"
@@ -6,9 +6,15 @@
 
 #pragma once
 
-#include <AppStreamQt/pool.h>
 #include <KRunner/AbstractRunner>
+#include <QFileSystemWatcher>
+#include <QFuture>
 #include <QMutex>
+#include <QTimer>
+
+#include <memory>
+
+struct ComponentIndex;
 
 class InstallerRunner : public Plasma::AbstractRunner
 {
@@ -21,9 +27,26 @@ public:
     void match(Plasma::RunnerContext &context) override;
     void run(const Plasma::RunnerContext &context, const Plasma::QueryMatch &action) override;
 
-private:
-    QList<AppStream::Component> findComponentsByString(const QString &query);
+private Q_SLOTS:
+    void reloadIndex();
 
-    AppStream::Pool m_db;
-    QMutex m_appstreamMutex;
+private:
+    /**
+     * Watches the catalog directories and their subdirectories not watched yet
+     */
+    void watchCatalogs();
+
+    /**
+     * @returns the component index, waiting for it to be loaded on first use
+     */
+    std::shared_ptr<const ComponentIndex> index();
+
+    std::shared_ptr<const ComponentIndex> m_index;
+    // catalogTimestamp() of the catalogs m_index was loaded from
+    qint64 m_indexTimestamp = 0;
+    QFuture<void> m_indexFuture;
+    QMutex m_indexMutex;
+
+    QFileSystemWatcher m_catalogWatcher;
+    QTimer m_reloadTimer;
 };
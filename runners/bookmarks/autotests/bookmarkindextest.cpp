@@ -0,0 +1,166 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include <QFile>
+#include <QObject>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "bookmarkindex.h"
+
+class TestBookmarkIndex : public QObject
+{
+    Q_OBJECT
+public:
+    using QObject::QObject;
+
+private:
+    QStringList urls(const QVector<BookmarkIndex::Bookmark> &bookmarks);
+
+private Q_SLOTS:
+    void testMatch();
+    void testMatch_data();
+    void testRanking();
+    void testSources();
+    void testPersistence();
+    void benchmarkTyping();
+};
+
+QStringList TestBookmarkIndex::urls(const QVector<BookmarkIndex::Bookmark> &bookmarks)
+{
+    QStringList ret;
+    for (const auto &bookmark : bookmarks) {
+        ret << bookmark.url;
+    }
+    return ret;
+}
+
+void TestBookmarkIndex::testMatch_data()
+{
+    QTest::addColumn<QString>("query");
+    QTest::addColumn<QStringList>("expectedUrls");
+
+    QTest::newRow("query that matches nothing") << "this does not exist" << QStringList{};
+    QTest::newRow("query that matches url") << "reddit.com" << QStringList{"https://www.reddit.com/"};
+    QTest::newRow("query that matches title case insensitively") << "kde community" << QStringList{"https://kde.org/"};
+    QTest::newRow("query that matches description") << "front page" << QStringList{"https://www.reddit.com/"};
+    QTest::newRow("short query") << "de" << QStringList{"https://kde.org/", "https://planet.kde.org/"};
+}
+
+void TestBookmarkIndex::testMatch()
+{
+    QFETCH(QString, query);
+    QFETCH(QStringList, expectedUrls);
+
+    BookmarkIndex index{QString()};
+    index.update(QStringLiteral("source"),
+                 QDateTime::currentDateTime(),
+                 {{QStringLiteral("KDE Community"), QStringLiteral("https://kde.org/"), QString()},
+                  {QStringLiteral("Reddit"), QStringLiteral("https://www.reddit.com/"), QStringLiteral("The front page of the internet")},
+                  {QStringLiteral("Planet KDE"), QStringLiteral("https://planet.kde.org/"), QString()}});
+
+    QCOMPARE(urls(index.match({QStringLiteral("source")}, query, false)), expectedUrls);
+    QCOMPARE(index.match({QStringLiteral("source")}, query, true).size(), 3);
+}
+
+void TestBookmarkIndex::testRanking()
+{
+    BookmarkIndex index{QString()};
+    index.update(QStringLiteral("source"),
+                 QDateTime::currentDateTime(),
+                 {{QStringLiteral("Some page"), QStringLiteral("https://plasma.example/"), QString()},
+                  {QStringLiteral("About the desktop"), QStringLiteral("https://a.example/"), QStringLiteral("Plasma")},
+                  {QStringLiteral("Myplasma"), QStringLiteral("https://b.example/"), QString()},
+                  {QStringLiteral("KDE Plasma"), QStringLiteral("https://c.example/"), QString()},
+                  {QStringLiteral("Plasma"), QStringLiteral("https://d.example/"), QString()}});
+
+    const QStringList expected{
+        QStringLiteral("https://a.example/"), // description equals the query
+        QStringLiteral("https://d.example/"), // title equals the query
+        QStringLiteral("https://c.example/"), // title has a word starting with the query
+        QStringLiteral("https://b.example/"), // title contains the query
+        QStringLiteral("https://plasma.example/"), // only the url contains the query
+    };
+    QCOMPARE(urls(index.match({QStringLiteral("source")}, QStringLiteral("plasma"), false)), expected);
+}
+
+void TestBookmarkIndex::testSources()
+{
+    BookmarkIndex index{QString()};
+    const QDateTime timestamp = QDateTime::currentDateTime();
+    index.update(QStringLiteral("first"), timestamp, {{QStringLiteral("First"), QStringLiteral("https://first.example/"), QString()}});
+    index.update(QStringLiteral("second"), timestamp, {{QStringLiteral("Second"), QStringLiteral("https://second.example/"), QString()}});
+
+    QCOMPARE(index.count({QStringLiteral("first"), QStringLiteral("second")}), 2);
+    QCOMPARE(urls(index.match({QStringLiteral("second")}, QStringLiteral("example"), false)), QStringList{QStringLiteral("https://second.example/")});
+    QVERIFY(index.isUpToDate(QStringLiteral("first"), timestamp));
+    QVERIFY(!index.isUpToDate(QStringLiteral("first"), timestamp.addSecs(1)));
+
+    index.update(QStringLiteral("first"), timestamp.addSecs(1), {});
+    QCOMPARE(index.count({QStringLiteral("first")}), 0);
+
+    index.remove(QStringLiteral("second"));
+    QVERIFY(!index.isUpToDate(QStringLiteral("second"), timestamp));
+    QVERIFY(index.match({QStringLiteral("second")}, QStringLiteral("example"), true).isEmpty());
+}
+
+void TestBookmarkIndex::testPersistence()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString storage = dir.filePath(QStringLiteral("index"));
+    const QString source = dir.filePath(QStringLiteral("bookmarks.json"));
+    const QString removedSource = dir.filePath(QStringLiteral("removed.json"));
+    for (const QString &path : {source, removedSource}) {
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+    }
+    const QDateTime timestamp = QDateTime::currentDateTime();
+
+    {
+        BookmarkIndex index(storage);
+        index.update(source, timestamp, {{QStringLiteral("KDE Community"), QStringLiteral("https://kde.org/"), QStringLiteral("Home of Plasma")}});
+        index.update(removedSource, timestamp, {{QStringLiteral("Gone"), QStringLiteral("https://gone.example/"), QString()}});
+    }
+    QVERIFY(QFile::remove(removedSource));
+
+    BookmarkIndex index(storage);
+    QVERIFY(index.isUpToDate(source, timestamp));
+    QVERIFY(!index.isUpToDate(removedSource, timestamp));
+    const auto matches = index.match({source}, QStringLiteral("plasma"), false);
+    QCOMPARE(matches.size(), 1);
+    QCOMPARE(matches.first().title, QStringLiteral("KDE Community"));
+    QCOMPARE(matches.first().description, QStringLiteral("Home of Plasma"));
+}
+
+void TestBookmarkIndex::benchmarkTyping()
+{
+    // 50k bookmarks spread over the sources of three browsers
+    BookmarkIndex index{QString()};
+    const QStringList sources{QStringLiteral("firefox"), QStringLiteral("chrome"), QStringLiteral("falkon")};
+    const int bookmarksPerSource = 50000 / sources.size() + 1;
+    for (const QString &source : sources) {
+        QVector<BookmarkIndex::Bookmark> bookmarks;
+        bookmarks.reserve(bookmarksPerSource);
+        for (int i = 0; i < bookmarksPerSource; ++i) {
+            bookmarks << BookmarkIndex::Bookmark{QStringLiteral("%1 bookmark number %2").arg(source).arg(i),
+                                                 QStringLiteral("https://host%1.%2.example/page/%3").arg(i % 997).arg(source).arg(i),
+                                                 QString()};
+        }
+        index.update(source, QDateTime::currentDateTime(), bookmarks);
+    }
+    QVERIFY(index.count(sources) >= 50000);
+    QCOMPARE(index.match(sources, QStringLiteral("number 12345"), false).size(), 3);
+
+    QBENCHMARK {
+        for (const QString &query : {QStringLiteral("hos"), QStringLiteral("host"), QStringLiteral("host42"), QStringLiteral("host42.chrome")}) {
+            index.match(sources, query, false);
+        }
+    }
+}
+
+QTEST_MAIN(TestBookmarkIndex)
+
+#include "bookmarkindextest.moc"
@@ -8,8 +8,24 @@
 #include <QTest>
 
 #include "browsers/firefox.h"
+#include "favicon.h"
 
 using namespace Plasma;
+
+class CountingFavicon : public Favicon
+{
+    Q_OBJECT
+public:
+    using Favicon::Favicon;
+    QIcon iconFor(const QString &url) override
+    {
+        Q_UNUSED(url)
+        ++lookups;
+        return QIcon::fromTheme(QStringLiteral("kde"));
+    }
+    int lookups = 0;
+};
+
 class TestBookmarksMatch : public QObject
 {
     Q_OBJECT
@@ -20,6 +36,7 @@ private Q_SLOTS:
     void testQueryMatchConversion();
     void testQueryMatchConversion_data();
     void testAddToList();
+    void testIconIsFetchedOnDemand();
 };
 
 void TestBookmarksMatch::testQueryMatchConversion()
@@ -74,6 +91,23 @@ void TestBookmarksMatch::testAddToList()
     QCOMPARE(allMatches.count(), 2);
 }
 
+void TestBookmarksMatch::testIconIsFetchedOnDemand()
+{
+    CountingFavicon favicon;
+    BookmarkMatch match(&favicon, "kde", "KDE Community", "https://kde.org/");
+
+    QList<BookmarkMatch> matches;
+    match.addTo(matches, false);
+    QCOMPARE(matches.count(), 1);
+    QCOMPARE(matches.first().favicon(), &favicon);
+    QCOMPARE(matches.first().asQueryMatch(nullptr).icon().name(), favicon.defaultIcon().name());
+    QCOMPARE(favicon.lookups, 0);
+
+    matches.first().fetchIcon();
+    QCOMPARE(favicon.lookups, 1);
+    QCOMPARE(matches.first().asQueryMatch(nullptr).icon().name(), QStringLiteral("kde"));
+}
+
 QTEST_MAIN(TestBookmarksMatch)
 
 #include "bookmarksmatchtest.moc"
@@ -0,0 +1,314 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "bookmarkindex.h"
+#include "bookmarks_debug.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QSet>
+#include <QStandardPaths>
+
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+
+namespace
+{
+const quint32 s_magic = 0x4b424958; // "KBIX"
+const quint32 s_version = 1;
+
+QVector<int> intersect(const QVector<int> &a, const QVector<int> &b)
+{
+    QVector<int> ret;
+    std::set_intersection(a.cbegin(), a.cend(), b.cbegin(), b.cend(), std::back_inserter(ret));
+    return ret;
+}
+
+void addTrigrams(const QString &foldedText, QSet<quint64> &trigrams)
+{
+    for (int i = 0; i + 2 < foldedText.size(); ++i) {
+        trigrams.insert(quint64(foldedText.at(i).unicode()) << 32 | quint64(foldedText.at(i + 1).unicode()) << 16 | quint64(foldedText.at(i + 2).unicode()));
+    }
+}
+
+// Same notion of a matching field as BookmarkMatch::addTo
+bool fieldMatches(const QString &foldedField, const QString &foldedTerm)
+{
+    return !foldedField.trimmed().isEmpty() && foldedField.contains(foldedTerm);
+}
+
+} // namespace
+
+struct BookmarkIndex::Source {
+    explicit Source(const QDateTime &lastModified, const QVector<Bookmark> &bookmarks);
+
+    QVector<int> candidates(const QString &foldedTerm) const;
+    int rank(int row, const QString &foldedTerm) const;
+
+    QDateTime lastModified;
+    QVector<Bookmark> bookmarks;
+    QVector<QString> titles;
+    QVector<QString> descriptions;
+    QVector<QString> urls;
+    QHash<quint64, QVector<int>> trigrams;
+};
+
+BookmarkIndex::Source::Source(const QDateTime &lastModified, const QVector<Bookmark> &bookmarks)
+    : lastModified(lastModified)
+    , bookmarks(bookmarks)
+{
+    titles.reserve(bookmarks.size());
+    descriptions.reserve(bookmarks.size());
+    urls.reserve(bookmarks.size());
+
+    for (int row = 0; row < bookmarks.size(); ++row) {
+        const Bookmark &bookmark = bookmarks.at(row);
+        titles << bookmark.title.toCaseFolded();
+        descriptions << bookmark.description.toCaseFolded();
+        urls << bookmark.url.toCaseFolded();
+
+        QSet<quint64> rowTrigrams;
+        addTrigrams(titles.constLast(), rowTrigrams);
+        addTrigrams(descriptions.constLast(), rowTrigrams);
+        addTrigrams(urls.constLast(), rowTrigrams);
+        for (quint64 trigram : qAsConst(rowTrigrams)) {
+            trigrams[trigram] << row;
+        }
+    }
+}
+
+QVector<int> BookmarkIndex::Source::candidates(const QString &foldedTerm) const
+{
+    QSet<quint64> termTrigrams;
+    addTrigrams(foldedTerm, termTrigrams);
+
+    if (termTrigrams.isEmpty()) {
+        // Too short to be looked up, every bookmark is a candidate
+        QVector<int> all(bookmarks.size());
+        std::iota(all.begin(), all.end(), 0);
+        return all;
+    }
+
+    // Start with the rarest trigram to keep the intersections small
+    QVector<const QVector<int> *> postings;
+    for (quint64 trigram : qAsConst(termTrigrams)) {
+        const auto it = trigrams.constFind(trigram);
+        if (it == trigrams.constEnd()) {
+            return {};
+        }
+        postings << &it.value();
+    }
+    std::sort(postings.begin(), postings.end(), [](const QVector<int> *a, const QVector<int> *b) {
+        return a->size() < b->size();
+    });
+
+    QVector<int> ret = *postings.first();
+    for (int i = 1; i < postings.size() && !ret.isEmpty(); ++i) {
+        ret = intersect(ret, *postings.at(i));
+    }
+    return ret;
+}
+
+int BookmarkIndex::Source::rank(int row, const QString &foldedTerm) const
+{
+    const QString &title = titles.at(row);
+    const QString &description = descriptions.at(row);
+
+    if (title == foldedTerm || (!description.isEmpty() && description == foldedTerm)) {
+        return 0;
+    }
+    if (fieldMatches(title, foldedTerm)) {
+        if (title.startsWith(foldedTerm) || title.contains(QLatin1Char(' ') + foldedTerm)) {
+            return 1;
+        }
+        return 2;
+    }
+    if (fieldMatches(description, foldedTerm)) {
+        return 3;
+    }
+    if (fieldMatches(urls.at(row), foldedTerm)) {
+        return 4;
+    }
+    return -1;
+}
+
+BookmarkIndex *BookmarkIndex::self()
+{
+    static BookmarkIndex index(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/bookmarksrunnerindex"));
+    return &index;
+}
+
+BookmarkIndex::BookmarkIndex(const QString &storageFile)
+    : m_storageFile(storageFile)
+{
+    load();
+}
+
+bool BookmarkIndex::isUpToDate(const QString &source, const QDateTime &lastModified) const
+{
+    QMutexLocker locker(&m_mutex);
+    const auto it = m_sources.constFind(source);
+    return it != m_sources.constEnd() && lastModified.isValid() && (*it)->lastModified == lastModified;
+}
+
+void BookmarkIndex::update(const QString &source, const QDateTime &lastModified, const QVector<Bookmark> &bookmarks)
+{
+    auto newSource = std::make_shared<const Source>(lastModified, bookmarks);
+    {
+        QMutexLocker locker(&m_mutex);
+        m_sources.insert(source, std::move(newSource));
+    }
+    qCDebug(RUNNER_BOOKMARKS) << "Indexed" << bookmarks.size() << "bookmarks of" << source;
+    save();
+}
+
+void BookmarkIndex::remove(const QString &source)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_sources.remove(source)) {
+            return;
+        }
+    }
+    save();
+}
+
+QVector<BookmarkIndex::Bookmark> BookmarkIndex::match(const QStringList &sources, const QString &term, bool addEverything) const
+{
+    QVector<std::shared_ptr<const Source>> snapshot;
+    {
+        QMutexLocker locker(&m_mutex);
+        for (const QString &source : sources) {
+            if (auto indexed = m_sources.value(source)) {
+                snapshot << indexed;
+            }
+        }
+    }
+
+    QVector<Bookmark> ret;
+    if (addEverything) {
+        for (const auto &source : qAsConst(snapshot)) {
+            ret << source->bookmarks;
+        }
+        return ret;
+    }
+
+    const QString foldedTerm = term.toCaseFolded();
+    QVector<QPair<int, const Bookmark *>> ranked;
+    for (const auto &source : qAsConst(snapshot)) {
+        const QVector<int> candidates = source->candidates(foldedTerm);
+        for (int row : candidates) {
+            const int rank = source->rank(row, foldedTerm);
+            if (rank >= 0) {
+                ranked << qMakePair(rank, &source->bookmarks.at(row));
+            }
+        }
+    }
+    std::stable_sort(ranked.begin(), ranked.end(), [](const QPair<int, const Bookmark *> &a, const QPair<int, const Bookmark *> &b) {
+        return a.first < b.first;
+    });
+
+    ret.reserve(ranked.size());
+    for (const auto &match : qAsConst(ranked)) {
+        ret << *match.second;
+    }
+    return ret;
+}
+
+int BookmarkIndex::count(const QStringList &sources) const
+{
+    QMutexLocker locker(&m_mutex);
+    int ret = 0;
+    for (const QString &source : sources) {
+        if (auto indexed = m_sources.value(source)) {
+            ret += indexed->bookmarks.size();
+        }
+    }
+    return ret;
+}
+
+void BookmarkIndex::load()
+{
+    if (m_storageFile.isEmpty()) {
+        return;
+    }
+
+    QFile file(m_storageFile);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QDataStream stream(&file);
+    quint32 magic;
+    quint32 version;
+    stream >> magic >> version;
+    if (magic != s_magic || version != s_version) {
+        qCDebug(RUNNER_BOOKMARKS) << "Ignoring incompatible bookmark index" << m_storageFile;
+        return;
+    }
+
+    quint32 sourceCount;
+    stream >> sourceCount;
+    for (quint32 i = 0; i < sourceCount && stream.status() == QDataStream::Ok; ++i) {
+        QString source;
+        QDateTime lastModified;
+        quint32 bookmarkCount;
+        stream >> source >> lastModified >> bookmarkCount;
+
+        QVector<Bookmark> bookmarks;
+        for (quint32 j = 0; j < bookmarkCount && stream.status() == QDataStream::Ok; ++j) {
+            Bookmark bookmark;
+            stream >> bookmark.title >> bookmark.url >> bookmark.description;
+            bookmarks << bookmark;
+        }
+
+        // Forget about browsers and profiles which are gone
+        if (stream.status() == QDataStream::Ok && QFileInfo::exists(source)) {
+            m_sources.insert(source, std::make_shared<const Source>(lastModified, bookmarks));
+        }
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        qCWarning(RUNNER_BOOKMARKS) << "Could not read bookmark index" << m_storageFile;
+        m_sources.clear();
+    }
+}
+
+void BookmarkIndex::save() const
+{
+    if (m_storageFile.isEmpty()) {
+        return;
+    }
+
+    QHash<QString, std::shared_ptr<const Source>> sources;
+    {
+        QMutexLocker locker(&m_mutex);
+        sources = m_sources;
+    }
+
+    QDir().mkpath(QFileInfo(m_storageFile).absolutePath());
+    QSaveFile file(m_storageFile);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(RUNNER_BOOKMARKS) << "Could not write bookmark index" << m_storageFile;
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream << s_magic << s_version << quint32(sources.size());
+    for (auto it = sources.constBegin(); it != sources.constEnd(); ++it) {
+        const QVector<Bookmark> &bookmarks = it.value()->bookmarks;
+        stream << it.key() << it.value()->lastModified << quint32(bookmarks.size());
+        for (const Bookmark &bookmark : bookmarks) {
+            stream << bookmark.title << bookmark.url << bookmark.description;
+        }
+    }
+    file.commit();
+}
@@ -0,0 +1,78 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <memory>
+
+/**
+ * Normalized store of the bookmarks of all browsers, persisted in the cache directory.
+ *
+ * Every browser backend registers its bookmark files as sources, together with the
+ * modification time they were read at. A source only needs to be read again once its
+ * file changed, queries never touch the browser's own files or databases.
+ *
+ * Each source keeps a trigram index over the case-folded title, description and url
+ * of its bookmarks, so that substring lookups don't have to scan every bookmark.
+ */
+class BookmarkIndex
+{
+public:
+    struct Bookmark {
+        QString title;
+        QString url;
+        QString description;
+    };
+
+    /**
+     * The index shared by all browser backends
+     */
+    static BookmarkIndex *self();
+
+    /**
+     * Creates an index persisted in @p storageFile, loading what was stored there before.
+     * An empty @p storageFile gives an index only living in memory.
+     */
+    explicit BookmarkIndex(const QString &storageFile);
+
+    /**
+     * @returns whether @p source was indexed with the modification time @p lastModified
+     */
+    bool isUpToDate(const QString &source, const QDateTime &lastModified) const;
+
+    /**
+     * Replaces all bookmarks of @p source
+     */
+    void update(const QString &source, const QDateTime &lastModified, const QVector<Bookmark> &bookmarks);
+    void remove(const QString &source);
+
+    /**
+     * @returns the bookmarks of @p sources having @p term in their title, description or url.
+     * Bookmarks whose title equals or starts with @p term are ranked first, bookmarks which
+     * only match by url last. If @p addEverything is set all bookmarks are returned in the
+     * order they were indexed in.
+     */
+    QVector<Bookmark> match(const QStringList &sources, const QString &term, bool addEverything) const;
+
+    int count(const QStringList &sources) const;
+
+private:
+    struct Source;
+
+    void load();
+    void save() const;
+
+    mutable QMutex m_mutex;
+    QHash<QString, std::shared_ptr<const Source>> m_sources;
+    const QString m_storageFile;
+};
@@ -6,6 +6,7 @@
 */
 
 #include "bookmarkmatch.h"
+#include "favicon.h"
 #include <QVariant>
 
 // TODO: test
@@ -19,28 +20,58 @@ BookmarkMatch::BookmarkMatch(const QIcon &icon, const QString &searchTerm, const
 {
 }
 
-Plasma::QueryMatch BookmarkMatch::asQueryMatch(Plasma::AbstractRunner *runner)
+BookmarkMatch::BookmarkMatch(Favicon *favicon, const QString &searchTerm, const QString &bookmarkTitle, const QString &bookmarkURL, const QString &description)
+    : m_icon(favicon ? favicon->defaultIcon() : QIcon())
+    , m_favicon(favicon)
+    , m_searchTerm(searchTerm)
+    , m_bookmarkTitle(bookmarkTitle)
+    , m_bookmarkURL(bookmarkURL)
+    , m_description(description)
+{
+}
+
+void BookmarkMatch::fetchIcon()
+{
+    if (m_favicon) {
+        m_icon = m_favicon->iconFor(m_bookmarkURL);
+    }
+}
+
+qreal BookmarkMatch::relevance() const
 {
-    Plasma::QueryMatch::Type type;
     qreal relevance = 0;
+    type(&relevance);
+    return relevance;
+}
+
+Plasma::QueryMatch::Type BookmarkMatch::type(qreal *relevance) const
+{
+    Plasma::QueryMatch::Type type;
 
     if (m_bookmarkTitle.compare(m_searchTerm, Qt::CaseInsensitive) == 0
         || (!m_description.isEmpty() && m_description.compare(m_searchTerm, Qt::CaseInsensitive) == 0)) {
         type = Plasma::QueryMatch::ExactMatch;
-        relevance = 1.0;
+        *relevance = 1.0;
     } else if (m_bookmarkTitle.contains(m_searchTerm, Qt::CaseInsensitive)) {
         type = Plasma::QueryMatch::PossibleMatch;
-        relevance = 0.45;
+        *relevance = 0.45;
     } else if (!m_description.isEmpty() && m_description.contains(m_searchTerm, Qt::CaseInsensitive)) {
         type = Plasma::QueryMatch::PossibleMatch;
-        relevance = 0.3;
+        *relevance = 0.3;
     } else if (m_bookmarkURL.contains(m_searchTerm, Qt::CaseInsensitive)) {
         type = Plasma::QueryMatch::PossibleMatch;
-        relevance = 0.2;
+        *relevance = 0.2;
     } else {
         type = Plasma::QueryMatch::PossibleMatch;
-        relevance = 0.18;
+        *relevance = 0.18;
     }
+    return type;
+}
+
+Plasma::QueryMatch BookmarkMatch::asQueryMatch(Plasma::AbstractRunner *runner)
+{
+    qreal relevance = 0;
+    const Plasma::QueryMatch::Type type = this->type(&relevance);
 
     bool isNameEmpty = m_bookmarkTitle.isEmpty();
     bool isDescriptionEmpty = m_description.isEmpty();
@@ -12,6 +12,8 @@
 #include <QList>
 #include <QString>
 
+class Favicon;
+
 class BookmarkMatch
 {
 public:
@@ -20,9 +22,29 @@ public:
                   const QString &bookmarkTitle,
                   const QString &bookmarkURL,
                   const QString &description = QString());
+    /**
+     * Creates a match showing the default icon of @p favicon until fetchIcon() is called
+     */
+    BookmarkMatch(Favicon *favicon,
+                  const QString &searchTerm,
+                  const QString &bookmarkTitle,
+                  const QString &bookmarkURL,
+                  const QString &description = QString());
     void addTo(QList<BookmarkMatch> &listOfResults, bool addEvenOnNoMatch);
     Plasma::QueryMatch asQueryMatch(Plasma::AbstractRunner *runner);
 
+    /**
+     * Looks up the icon of the bookmark using the favicon it was created with
+     */
+    void fetchIcon();
+
+    Q_REQUIRED_RESULT qreal relevance() const;
+
+    Q_REQUIRED_RESULT Favicon *favicon() const
+    {
+        return m_favicon;
+    }
+
     Q_REQUIRED_RESULT QString bookmarkTitle() const
     {
         return m_bookmarkTitle;
@@ -35,9 +57,11 @@ public:
 
 private:
     bool matches(const QString &search, const QString &matchingField);
+    Plasma::QueryMatch::Type type(qreal *relevance) const;
 
 private:
     QIcon m_icon;
+    Favicon *m_favicon = nullptr;
     QString m_searchTerm;
     QString m_bookmarkTitle;
     QString m_bookmarkURL;
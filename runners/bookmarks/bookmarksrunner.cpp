@@ -11,9 +11,11 @@
 #include <QDebug>
 #include <QDesktopServices>
 #include <QDir>
+#include <QHash>
 #include <QList>
 #include <QStack>
 #include <QUrl>
+#include <QVector>
 
 #include <KApplicationTrader>
 #include <KLocalizedString>
@@ -22,6 +24,13 @@
 #include "bookmarkmatch.h"
 #include "bookmarksrunner_defs.h"
 #include "browserfactory.h"
+#include "favicon.h"
+
+#include <algorithm>
+#include <numeric>
+
+// Matches for which the favicon gets looked up
+static const int s_maxMatchesWithIcon = 20;
 
 K_PLUGIN_CLASS_WITH_JSON(BookmarksRunner, "plasma-runner-bookmarks.json")
 
@@ -57,10 +66,41 @@ void BookmarksRunner::match(Plasma::RunnerContext &context)
     const QString term = context.query();
     bool allBookmarks = term.compare(i18nc("list of all konqueror bookmarks", "bookmarks"), Qt::CaseInsensitive) == 0;
 
-    const QList<BookmarkMatch> matches = m_browser->match(term, allBookmarks);
-    for (BookmarkMatch match : matches) {
+    QList<BookmarkMatch> matches = m_browser->match(term, allBookmarks);
+
+    QVector<qreal> relevance;
+    relevance.reserve(matches.size());
+    for (const BookmarkMatch &match : qAsConst(matches)) {
+        relevance << match.relevance();
+    }
+    QVector<int> order(matches.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&relevance](int a, int b) {
+        return relevance.at(a) > relevance.at(b);
+    });
+
+    // Only the best matches make it to the top of the result list, the others keep the default icon
+    const int matchesWithIcon = std::min(order.size(), s_maxMatchesWithIcon);
+    QHash<Favicon *, QStringList> urls;
+    for (int i = 0; i < matchesWithIcon; ++i) {
+        const BookmarkMatch &match = matches.at(order.at(i));
+        if (match.favicon()) {
+            urls[match.favicon()] << match.bookmarkUrl();
+        }
+    }
+    for (auto it = urls.constBegin(); it != urls.constEnd(); ++it) {
         if (!context.isValid())
             return;
+        it.key()->prefetch(it.value());
+    }
+
+    for (int i = 0; i < order.size(); ++i) {
+        if (!context.isValid())
+            return;
+        BookmarkMatch &match = matches[order.at(i)];
+        if (i < matchesWithIcon) {
+            match.fetchIcon();
+        }
         context.addMatch(match.asQueryMatch(this));
     }
 }
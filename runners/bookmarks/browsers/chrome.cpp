@@ -6,6 +6,7 @@
 */
 
 #include "chrome.h"
+#include "bookmarkindex.h"
 #include "browsers/findprofile.h"
 #include "faviconfromblob.h"
 
@@ -22,36 +23,27 @@ public:
         : m_profile(profile)
     {
     }
-    inline QJsonArray bookmarks()
-    {
-        return m_bookmarks;
-    }
     inline Profile profile()
     {
         return m_profile;
     }
-    void tearDown()
-    {
-        m_profile.favicon()->teardown();
-        clear();
-    }
-    void add(const QJsonObject &bookmarkEntry)
+    inline bool isPrepared() const
     {
-        m_bookmarks << bookmarkEntry;
+        return m_prepared;
     }
-    void add(const QJsonArray &entries)
+    void setPrepared(bool prepared)
     {
-        for (const auto &e : entries)
-            m_bookmarks << e;
+        m_prepared = prepared;
     }
-    void clear()
+    void tearDown()
     {
-        m_bookmarks = QJsonArray();
+        m_profile.favicon()->teardown();
+        m_prepared = false;
     }
 
 private:
     Profile m_profile;
-    QJsonArray m_bookmarks;
+    bool m_prepared = false;
 };
 
 Chrome::Chrome(FindProfile *findProfile, QObject *parent)
@@ -92,13 +84,14 @@ QList<BookmarkMatch> Chrome::match(const QString &term, bool addEveryThing)
 QList<BookmarkMatch> Chrome::match(const QString &term, bool addEveryThing, ProfileBookmarks *profileBookmarks)
 {
     QList<BookmarkMatch> results;
+    if (!profileBookmarks->isPrepared()) {
+        return results;
+    }
 
-    const auto bookmarks = profileBookmarks->bookmarks();
+    const auto bookmarks = BookmarkIndex::self()->match({profileBookmarks->profile().path()}, term, addEveryThing);
     Favicon *favicon = profileBookmarks->profile().favicon();
-    for (const QJsonValue &bookmarkValue : bookmarks) {
-        const QJsonObject bookmark = bookmarkValue.toObject();
-        const QString url = bookmark.value(QStringLiteral("url")).toString();
-        BookmarkMatch bookmarkMatch(favicon->iconFor(url), term, bookmark.value(QStringLiteral("name")).toString(), url);
+    for (const BookmarkIndex::Bookmark &bookmark : bookmarks) {
+        BookmarkMatch bookmarkMatch(favicon, term, bookmark.title, bookmark.url);
         bookmarkMatch.addTo(results, addEveryThing);
     }
     return results;
@@ -109,12 +102,22 @@ void Chrome::prepare()
     m_dirty = false;
     for (ProfileBookmarks *profileBookmarks : qAsConst(m_profileBookmarks)) {
         Profile profile = profileBookmarks->profile();
-        profileBookmarks->clear();
-        const QJsonArray bookmarks = readChromeFormatBookmarks(profile.path());
-        if (bookmarks.isEmpty()) {
+        const QDateTime lastModified = QFileInfo(profile.path()).lastModified();
+        if (!lastModified.isValid()) {
+            BookmarkIndex::self()->remove(profile.path());
             continue;
         }
-        profileBookmarks->add(bookmarks);
+        if (!BookmarkIndex::self()->isUpToDate(profile.path(), lastModified)) {
+            const QJsonArray bookmarks = readChromeFormatBookmarks(profile.path());
+            QVector<BookmarkIndex::Bookmark> entries;
+            entries.reserve(bookmarks.size());
+            for (const QJsonValue &bookmarkValue : bookmarks) {
+                const QJsonObject bookmark = bookmarkValue.toObject();
+                entries << BookmarkIndex::Bookmark{bookmark.value(QStringLiteral("name")).toString(), bookmark.value(QStringLiteral("url")).toString(), QString()};
+            }
+            BookmarkIndex::self()->update(profile.path(), lastModified, entries);
+        }
+        profileBookmarks->setPrepared(true);
         updateCacheFile(profile.faviconSource(), profile.faviconCache());
         profile.favicon()->prepare();
     }
@@ -5,6 +5,7 @@
 */
 
 #include "falkon.h"
+#include "bookmarkindex.h"
 #include "favicon.h"
 #include "faviconfromblob.h"
 #include <KConfigGroup>
@@ -18,6 +19,7 @@
 Falkon::Falkon(QObject *parent)
     : QObject(parent)
     , m_startupProfile(getStartupProfileDir())
+    , m_bookmarksFile(m_startupProfile + QStringLiteral("/bookmarks.json"))
     , m_favicon(FaviconFromBlob::falkon(m_startupProfile, this))
 {
 }
@@ -25,10 +27,13 @@ Falkon::Falkon(QObject *parent)
 QList<BookmarkMatch> Falkon::match(const QString &term, bool addEverything)
 {
     QList<BookmarkMatch> matches;
-    for (const auto &bookmark : qAsConst(m_falkonBookmarkEntries)) {
-        const auto obj = bookmark.toObject();
-        const QString url = obj.value(QStringLiteral("url")).toString();
-        BookmarkMatch bookmarkMatch(m_favicon->iconFor(url), term, obj.value(QStringLiteral("name")).toString(), url);
+    if (!m_prepared) {
+        return matches;
+    }
+
+    const auto bookmarks = BookmarkIndex::self()->match({m_bookmarksFile}, term, addEverything);
+    for (const BookmarkIndex::Bookmark &bookmark : bookmarks) {
+        BookmarkMatch bookmarkMatch(m_favicon, term, bookmark.title, bookmark.url);
         bookmarkMatch.addTo(matches, addEverything);
     }
     return matches;
@@ -36,12 +41,30 @@ QList<BookmarkMatch> Falkon::match(const QString &term, bool addEverything)
 
 void Falkon::prepare()
 {
-    m_falkonBookmarkEntries = readChromeFormatBookmarks(m_startupProfile + QStringLiteral("/bookmarks.json"));
+    m_prepared = true;
+
+    const QDateTime lastModified = QFileInfo(m_bookmarksFile).lastModified();
+    if (!lastModified.isValid()) {
+        BookmarkIndex::self()->remove(m_bookmarksFile);
+        return;
+    }
+    if (BookmarkIndex::self()->isUpToDate(m_bookmarksFile, lastModified)) {
+        return;
+    }
+
+    const QJsonArray bookmarks = readChromeFormatBookmarks(m_bookmarksFile);
+    QVector<BookmarkIndex::Bookmark> entries;
+    entries.reserve(bookmarks.size());
+    for (const auto &bookmark : bookmarks) {
+        const auto obj = bookmark.toObject();
+        entries << BookmarkIndex::Bookmark{obj.value(QStringLiteral("name")).toString(), obj.value(QStringLiteral("url")).toString(), QString()};
+    }
+    BookmarkIndex::self()->update(m_bookmarksFile, lastModified, entries);
 }
 
 void Falkon::teardown()
 {
-    m_falkonBookmarkEntries = QJsonArray();
+    m_prepared = false;
 }
 
 QString Falkon::getStartupProfileDir()
@@ -22,7 +22,8 @@ public Q_SLOTS:
 
 private:
     QString getStartupProfileDir();
-    QJsonArray m_falkonBookmarkEntries;
     QString m_startupProfile;
+    QString m_bookmarksFile;
+    bool m_prepared = false;
     Favicon *m_favicon;
 };
@@ -6,6 +6,7 @@
 */
 
 #include "firefox.h"
+#include "bookmarkindex.h"
 #include "bookmarkmatch.h"
 #include "bookmarks_debug.h"
 #include "favicon.h"
@@ -15,6 +16,7 @@
 #include <KSharedConfig>
 #include <QDir>
 #include <QFile>
+#include <QFileInfo>
 #include <QRegularExpression>
 
 Firefox::Firefox(const QString &firefoxConfigDir, QObject *parent)
@@ -22,7 +24,6 @@ Firefox::Firefox(const QString &firefoxConfigDir, QObject *parent)
     , m_dbCacheFile(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/bookmarkrunnerfirefoxdbfile.sqlite"))
     , m_dbCacheFile_fav(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/bookmarkrunnerfirefoxfavdbfile.sqlite"))
     , m_favicon(new FallbackFavicon(this))
-    , m_fetchsqlite(nullptr)
     , m_fetchsqlite_fav(nullptr)
 {
     if (!QSqlDatabase::isDriverAvailable(QStringLiteral("QSQLITE"))) {
@@ -103,38 +104,31 @@ Firefox::~Firefox()
 
 void Firefox::prepare()
 {
-    if (updateCacheFile(m_dbFile, m_dbCacheFile) != Error) {
-        m_fetchsqlite = new FetchSqlite(m_dbCacheFile);
-        m_fetchsqlite->prepare();
-    }
     updateCacheFile(m_dbFile_fav, m_dbCacheFile_fav);
     m_favicon->prepare();
-}
 
-QList<BookmarkMatch> Firefox::match(const QString &term, bool addEverything)
-{
-    QList<BookmarkMatch> matches;
-    if (!m_fetchsqlite) {
-        return matches;
+    if (m_dbFile.isEmpty()) {
+        return;
     }
+    m_prepared = true;
 
-    QString query;
-    if (addEverything) {
-        query = QStringLiteral(
-            "SELECT moz_bookmarks.fk, moz_bookmarks.title, moz_places.url "
-            "FROM moz_bookmarks, moz_places WHERE "
-            "moz_bookmarks.type = 1 AND moz_bookmarks.fk = moz_places.id");
-    } else {
-        query = QStringLiteral(
-            "SELECT moz_bookmarks.fk, moz_bookmarks.title, moz_places.url "
-            "FROM moz_bookmarks, moz_places WHERE "
-            "moz_bookmarks.type = 1 AND moz_bookmarks.fk = moz_places.id AND "
-            "(moz_bookmarks.title LIKE :term OR moz_places.url LIKE :term)");
+    const QDateTime lastModified = QFileInfo(m_dbFile).lastModified();
+    if (BookmarkIndex::self()->isUpToDate(m_dbFile, lastModified)) {
+        return;
     }
-    const QMap<QString, QVariant> bindVariables{
-        {QStringLiteral(":term"), QStringLiteral("%%%1%%").arg(term)},
-    };
-    const QList<QVariantMap> results = m_fetchsqlite->query(query, bindVariables);
+    if (updateCacheFile(m_dbFile, m_dbCacheFile) == Error) {
+        BookmarkIndex::self()->remove(m_dbFile);
+        return;
+    }
+
+    FetchSqlite fetchSqlite(m_dbCacheFile);
+    const QString query = QStringLiteral(
+        "SELECT moz_bookmarks.fk, moz_bookmarks.title, moz_places.url "
+        "FROM moz_bookmarks, moz_places WHERE "
+        "moz_bookmarks.type = 1 AND moz_bookmarks.fk = moz_places.id");
+    const QList<QVariantMap> results = fetchSqlite.query(query);
+    fetchSqlite.teardown();
+
     QMultiMap<QString, QString> uniqueResults;
     for (const QVariantMap &result : results) {
         const QString title = result.value(QStringLiteral("title")).toString();
@@ -172,9 +166,24 @@ QList<BookmarkMatch> Firefox::match(const QString &term, bool addEverything)
         }
     }
 
+    QVector<BookmarkIndex::Bookmark> bookmarks;
+    bookmarks.reserve(uniqueResults.size());
     for (auto result = uniqueResults.constKeyValueBegin(); result != uniqueResults.constKeyValueEnd(); ++result) {
-        const QString url = (*result).first;
-        BookmarkMatch bookmarkMatch(m_favicon->iconFor(url), term, (*result).second, url);
+        bookmarks << BookmarkIndex::Bookmark{(*result).second, (*result).first, QString()};
+    }
+    BookmarkIndex::self()->update(m_dbFile, lastModified, bookmarks);
+}
+
+QList<BookmarkMatch> Firefox::match(const QString &term, bool addEverything)
+{
+    QList<BookmarkMatch> matches;
+    if (!m_prepared) {
+        return matches;
+    }
+
+    const auto bookmarks = BookmarkIndex::self()->match({m_dbFile}, term, addEverything);
+    for (const BookmarkIndex::Bookmark &bookmark : bookmarks) {
+        BookmarkMatch bookmarkMatch(m_favicon, term, bookmark.title, bookmark.url);
         bookmarkMatch.addTo(matches, addEverything);
     }
 
@@ -183,10 +192,6 @@ QList<BookmarkMatch> Firefox::match(const QString &term, bool addEverything)
 
 void Firefox::teardown()
 {
-    if (m_fetchsqlite) {
-        m_fetchsqlite->teardown();
-        delete m_fetchsqlite;
-        m_fetchsqlite = nullptr;
-    }
+    m_prepared = false;
     m_favicon->teardown();
 }
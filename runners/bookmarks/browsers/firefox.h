@@ -30,6 +30,6 @@ private:
     const QString m_dbCacheFile;
     const QString m_dbCacheFile_fav;
     Favicon *m_favicon;
-    FetchSqlite *m_fetchsqlite;
+    bool m_prepared = false;
     FetchSqlite *m_fetchsqlite_fav;
 };
@@ -6,10 +6,11 @@
 */
 
 #include "konqueror.h"
+#include "bookmarkindex.h"
 #include "bookmarkmatch.h"
 
+#include <QFileInfo>
 #include <QIcon>
-#include <QStack>
 #include <QUrl>
 
 #include <KBookmarkManager>
@@ -38,56 +39,42 @@ Konqueror::Konqueror(QObject *parent)
 
 QList<BookmarkMatch> Konqueror::match(const QString &term, bool addEverything)
 {
-    KBookmarkGroup bookmarkGroup = m_bookmarkManager->root();
-
     QList<BookmarkMatch> matches;
-    QStack<KBookmarkGroup> groups;
-
-    KBookmark bookmark = bookmarkGroup.first();
-    while (!bookmark.isNull()) {
-        //         if (!context.isValid()) {
-        //             return;
-        //         } TODO: restore?
+    const auto bookmarks = BookmarkIndex::self()->match({m_bookmarkManager->path()}, term, addEverything);
+    for (const BookmarkIndex::Bookmark &bookmark : bookmarks) {
+        BookmarkMatch bookmarkMatch(m_favicon, term, bookmark.title, bookmark.url);
+        bookmarkMatch.addTo(matches, addEverything);
+    }
+    return matches;
+}
 
+static void collectBookmarks(const KBookmarkGroup &bookmarkGroup, QVector<BookmarkIndex::Bookmark> &bookmarks)
+{
+    for (KBookmark bookmark = bookmarkGroup.first(); !bookmark.isNull(); bookmark = bookmarkGroup.next(bookmark)) {
         if (bookmark.isSeparator()) {
-            bookmark = bookmarkGroup.next(bookmark);
             continue;
         }
-
         if (bookmark.isGroup()) { // descend
-            // qDebug(kdbg_code) << "descending into" << bookmark.text();
-            groups.push(bookmarkGroup);
-            bookmarkGroup = bookmark.toGroup();
-            bookmark = bookmarkGroup.first();
-
-            while (bookmark.isNull() && !groups.isEmpty()) {
-                //                 if (!context.isValid()) {
-                //                     return;
-                //                 } TODO: restore?
-
-                bookmark = bookmarkGroup;
-                bookmarkGroup = groups.pop();
-                bookmark = bookmarkGroup.next(bookmark);
-            }
-
+            collectBookmarks(bookmark.toGroup(), bookmarks);
             continue;
         }
+        bookmarks << BookmarkIndex::Bookmark{bookmark.text(), bookmark.url().url(), QString()};
+    }
+}
 
-        const QString url = bookmark.url().url();
-        BookmarkMatch bookmarkMatch(m_favicon->iconFor(url), term, bookmark.text(), url);
-        bookmarkMatch.addTo(matches, addEverything);
-
-        bookmark = bookmarkGroup.next(bookmark);
-        while (bookmark.isNull() && !groups.isEmpty()) {
-            //             if (!context.isValid()) {
-            //                 return;
-            //             } // TODO: restore?
-
-            bookmark = bookmarkGroup;
-            bookmarkGroup = groups.pop();
-            ////qDebug() << "ascending from" << bookmark.text() << "to" << bookmarkGroup.text();
-            bookmark = bookmarkGroup.next(bookmark);
-        }
+void Konqueror::prepare()
+{
+    const QString path = m_bookmarkManager->path();
+    const QDateTime lastModified = QFileInfo(path).lastModified();
+    if (!lastModified.isValid()) {
+        BookmarkIndex::self()->remove(path);
+        return;
     }
-    return matches;
+    if (BookmarkIndex::self()->isUpToDate(path, lastModified)) {
+        return;
+    }
+
+    QVector<BookmarkIndex::Bookmark> bookmarks;
+    collectBookmarks(m_bookmarkManager->root(), bookmarks);
+    BookmarkIndex::self()->update(path, lastModified, bookmarks);
 }
@@ -28,6 +28,7 @@ public:
     QList<BookmarkMatch> match(const QString &term, bool addEverything) override;
 
 public Q_SLOTS:
+    void prepare() override;
     void teardown() override
     {
     }
@@ -6,14 +6,17 @@
 */
 
 #include "opera.h"
+#include "bookmarkindex.h"
 #include "bookmarksrunner_defs.h"
 #include "favicon.h"
 #include <QDebug>
 #include <QDir>
 #include <QFile>
+#include <QFileInfo>
 
 Opera::Opera(QObject *parent)
     : QObject(parent)
+    , m_bookmarksFile(QDir::homePath() + QStringLiteral("/.opera/bookmarks.adr"))
     , m_favicon(new FallbackFavicon(this))
 {
 }
@@ -21,34 +24,13 @@ Opera::Opera(QObject *parent)
 QList<BookmarkMatch> Opera::match(const QString &term, bool addEverything)
 {
     QList<BookmarkMatch> matches;
+    if (!m_prepared) {
+        return matches;
+    }
 
-    QLatin1String nameStart("\tNAME=");
-    QLatin1String urlStart("\tURL=");
-    QLatin1String descriptionStart("\tDESCRIPTION=");
-
-    // search
-    for (const QString &entry : qAsConst(m_operaBookmarkEntries)) {
-        QStringList entryLines = entry.split(QStringLiteral("\n"));
-        if (!entryLines.first().startsWith(QLatin1String("#URL"))) {
-            continue; // skip folder entries
-        }
-        entryLines.pop_front();
-
-        QString name;
-        QString url;
-        QString description;
-
-        for (const QString &line : qAsConst(entryLines)) {
-            if (line.startsWith(nameStart)) {
-                name = line.mid(QString(nameStart).length()).simplified();
-            } else if (line.startsWith(urlStart)) {
-                url = line.mid(QString(urlStart).length()).simplified();
-            } else if (line.startsWith(descriptionStart)) {
-                description = line.mid(QString(descriptionStart).length()).simplified();
-            }
-        }
-
-        BookmarkMatch bookmarkMatch(m_favicon->iconFor(url), term, name, url, description);
+    const auto bookmarks = BookmarkIndex::self()->match({m_bookmarksFile}, term, addEverything);
+    for (const BookmarkIndex::Bookmark &bookmark : bookmarks) {
+        BookmarkMatch bookmarkMatch(m_favicon, term, bookmark.title, bookmark.url, bookmark.description);
         bookmarkMatch.addTo(matches, addEverything);
     }
     return matches;
@@ -56,11 +38,21 @@ QList<BookmarkMatch> Opera::match(const QString &term, bool addEverything)
 
 void Opera::prepare()
 {
+    m_prepared = true;
+
+    const QDateTime lastModified = QFileInfo(m_bookmarksFile).lastModified();
+    if (!lastModified.isValid()) {
+        BookmarkIndex::self()->remove(m_bookmarksFile);
+        return;
+    }
+    if (BookmarkIndex::self()->isUpToDate(m_bookmarksFile, lastModified)) {
+        return;
+    }
+
     // open bookmarks file
-    QString operaBookmarksFilePath = QDir::homePath() + "/.opera/bookmarks.adr";
-    QFile operaBookmarksFile(operaBookmarksFilePath);
+    QFile operaBookmarksFile(m_bookmarksFile);
     if (!operaBookmarksFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        // qDebug() << "Could not open Operas Bookmark File " + operaBookmarksFilePath;
+        // qDebug() << "Could not open Operas Bookmark File " + m_bookmarksFile;
         return;
     }
 
@@ -74,13 +66,39 @@ void Opera::prepare()
 
     // load contents
     QString contents = operaBookmarksFile.readAll();
-    m_operaBookmarkEntries = contents.split(QStringLiteral("\n\n"), Qt::SkipEmptyParts);
+    const QStringList operaBookmarkEntries = contents.split(QStringLiteral("\n\n"), Qt::SkipEmptyParts);
 
     // close file
     operaBookmarksFile.close();
+
+    QLatin1String nameStart("\tNAME=");
+    QLatin1String urlStart("\tURL=");
+    QLatin1String descriptionStart("\tDESCRIPTION=");
+
+    QVector<BookmarkIndex::Bookmark> bookmarks;
+    for (const QString &entry : operaBookmarkEntries) {
+        QStringList entryLines = entry.split(QStringLiteral("\n"));
+        if (!entryLines.first().startsWith(QLatin1String("#URL"))) {
+            continue; // skip folder entries
+        }
+        entryLines.pop_front();
+
+        BookmarkIndex::Bookmark bookmark;
+        for (const QString &line : qAsConst(entryLines)) {
+            if (line.startsWith(nameStart)) {
+                bookmark.title = line.mid(QString(nameStart).length()).simplified();
+            } else if (line.startsWith(urlStart)) {
+                bookmark.url = line.mid(QString(urlStart).length()).simplified();
+            } else if (line.startsWith(descriptionStart)) {
+                bookmark.description = line.mid(QString(descriptionStart).length()).simplified();
+            }
+        }
+        bookmarks << bookmark;
+    }
+    BookmarkIndex::self()->update(m_bookmarksFile, lastModified, bookmarks);
 }
 
 void Opera::teardown()
 {
-    m_operaBookmarkEntries.clear();
+    m_prepared = false;
 }
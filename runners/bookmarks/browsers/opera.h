@@ -8,7 +8,7 @@
 #pragma once
 
 #include "browser.h"
-#include <QStringList>
+#include <QString>
 
 class Favicon;
 
@@ -23,6 +23,7 @@ public Q_SLOTS:
     void teardown() override;
 
 private:
-    QStringList m_operaBookmarkEntries;
+    const QString m_bookmarksFile;
+    bool m_prepared = false;
     Favicon *const m_favicon;
 };
@@ -9,6 +9,7 @@
 
 #include <QIcon>
 #include <QObject>
+#include <QStringList>
 
 class Favicon : public QObject
 {
@@ -17,7 +18,15 @@ public:
     explicit Favicon(QObject *parent = nullptr);
     virtual QIcon iconFor(const QString &url) = 0;
 
-protected:
+    /**
+     * Looks up the icons of all @p urls at once, so that the following calls
+     * to iconFor() for them are cheap
+     */
+    virtual void prefetch(const QStringList &urls)
+    {
+        Q_UNUSED(urls)
+    }
+
     inline QIcon defaultIcon() const
     {
         return m_default_icon;
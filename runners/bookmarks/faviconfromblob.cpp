@@ -12,6 +12,8 @@
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <QHash>
+#include <QMutexLocker>
 #include <QPainter>
 #include <QPixmap>
 #include <QStandardPaths>
@@ -21,6 +23,14 @@
 #include <QSqlQuery>
 #include <QSqlRecord>
 
+namespace
+{
+// Favicons kept in memory, roughly the number of matches a couple of queries show
+const int s_maxCachedIcons = 256;
+// Stay well below the SQLite limit for host parameters in one statement
+const int s_maxUrlsPerQuery = 500;
+}
+
 FaviconFromBlob *FaviconFromBlob::chrome(const QString &profileDirectory, QObject *parent)
 {
     QString profileName = QFileInfo(profileDirectory).fileName();
@@ -31,43 +41,50 @@ FaviconFromBlob *FaviconFromBlob::chrome(const QString &profileDirectory, QObjec
     QString faviconQuery;
     if (fetchSqlite->tables().contains(QLatin1String("favicon_bitmaps"))) {
         faviconQuery = QLatin1String(
-            "SELECT * FROM favicons "
+            "SELECT icon_mapping.page_url, favicon_bitmaps.image_data FROM favicons "
             "inner join icon_mapping on icon_mapping.icon_id = favicons.id "
             "inner join favicon_bitmaps on icon_mapping.icon_id = favicon_bitmaps.icon_id "
-            "WHERE page_url = :url ORDER BY height desc LIMIT 1;");
+            "WHERE icon_mapping.page_url IN (%1) ORDER BY favicon_bitmaps.height desc;");
     } else {
         faviconQuery = QLatin1String(
-            "SELECT * FROM favicons "
+            "SELECT icon_mapping.page_url, favicons.image_data FROM favicons "
             "inner join icon_mapping on icon_mapping.icon_id = favicons.id "
-            "WHERE page_url = :url LIMIT 1;");
+            "WHERE icon_mapping.page_url IN (%1);");
     }
 
-    return new FaviconFromBlob(profileName, faviconQuery, QStringLiteral("image_data"), fetchSqlite, parent);
+    return new FaviconFromBlob(profileName, faviconQuery, QStringLiteral("page_url"), QStringLiteral("image_data"), fetchSqlite, parent);
 }
 
 FaviconFromBlob *FaviconFromBlob::firefox(FetchSqlite *fetchSqlite, QObject *parent)
 {
     QString faviconQuery = QStringLiteral(
-        "SELECT moz_icons.data FROM moz_icons"
+        "SELECT moz_pages_w_icons.page_url, moz_icons.data FROM moz_icons"
         " INNER JOIN moz_icons_to_pages ON moz_icons.id = moz_icons_to_pages.icon_id"
         " INNER JOIN moz_pages_w_icons ON moz_icons_to_pages.page_id = moz_pages_w_icons.id"
-        " WHERE moz_pages_w_icons.page_url = :url LIMIT 1;");
-    return new FaviconFromBlob(QStringLiteral("firefox-default"), faviconQuery, QStringLiteral("data"), fetchSqlite, parent);
+        " WHERE moz_pages_w_icons.page_url IN (%1);");
+    return new FaviconFromBlob(QStringLiteral("firefox-default"), faviconQuery, QStringLiteral("page_url"), QStringLiteral("data"), fetchSqlite, parent);
 }
 
 FaviconFromBlob *FaviconFromBlob::falkon(const QString &profileDirectory, QObject *parent)
 {
     const QString dbPath = profileDirectory + QStringLiteral("/browsedata.db");
     FetchSqlite *fetchSqlite = new FetchSqlite(dbPath, parent);
-    const QString faviconQuery = QStringLiteral("SELECT icon FROM icons WHERE url = :url LIMIT 1;");
-    return new FaviconFromBlob(QStringLiteral("falkon-default"), faviconQuery, QStringLiteral("icon"), fetchSqlite, parent);
+    const QString faviconQuery = QStringLiteral("SELECT url, icon FROM icons WHERE url IN (%1);");
+    return new FaviconFromBlob(QStringLiteral("falkon-default"), faviconQuery, QStringLiteral("url"), QStringLiteral("icon"), fetchSqlite, parent);
 }
 
-FaviconFromBlob::FaviconFromBlob(const QString &profileName, const QString &query, const QString &blobColumn, FetchSqlite *fetchSqlite, QObject *parent)
+FaviconFromBlob::FaviconFromBlob(const QString &profileName,
+                                 const QString &query,
+                                 const QString &urlColumn,
+                                 const QString &blobColumn,
+                                 FetchSqlite *fetchSqlite,
+                                 QObject *parent)
     : Favicon(parent)
     , m_query(query)
+    , m_urlcolumn(urlColumn)
     , m_blobcolumn(blobColumn)
     , m_fetchsqlite(fetchSqlite)
+    , m_icons(s_maxCachedIcons)
 {
     m_profileCacheDirectory = QStringLiteral("%1/KRunner-Favicons-%2").arg(QStandardPaths::writableLocation(QStandardPaths::CacheLocation), profileName);
     // qDebug() << "got cache directory: " << m_profileCacheDirectory;
@@ -88,6 +105,10 @@ void FaviconFromBlob::prepare()
 void FaviconFromBlob::teardown()
 {
     m_fetchsqlite->teardown();
+
+    // The browser may have changed its favicons until the next session
+    QMutexLocker locker(&m_mutex);
+    m_icons.clear();
 }
 
 void FaviconFromBlob::cleanCacheDirectory()
@@ -97,26 +118,69 @@ void FaviconFromBlob::cleanCacheDirectory()
 
 QIcon FaviconFromBlob::iconFor(const QString &url)
 {
-    // qDebug() << "got url: " << url;
-    QString fileChecksum = QString::number(qChecksum(url.toLatin1(), url.toLatin1().size()));
-    QFile iconFile(m_profileCacheDirectory + QDir::separator() + fileChecksum + QStringLiteral("_favicon"));
-    if (iconFile.size() == 0)
-        iconFile.remove();
-    if (!iconFile.exists()) {
+    {
+        QMutexLocker locker(&m_mutex);
+        if (const QIcon *icon = m_icons.object(url)) {
+            return *icon;
+        }
+    }
+
+    prefetch({url});
+
+    QMutexLocker locker(&m_mutex);
+    const QIcon *icon = m_icons.object(url);
+    return icon ? *icon : defaultIcon();
+}
+
+void FaviconFromBlob::prefetch(const QStringList &urls)
+{
+    QStringList missing;
+    {
+        QMutexLocker locker(&m_mutex);
+        for (const QString &url : urls) {
+            if (!m_icons.contains(url) && !missing.contains(url)) {
+                missing << url;
+            }
+        }
+    }
+
+    for (int first = 0; first < missing.size(); first += s_maxUrlsPerQuery) {
+        const QStringList batch = missing.mid(first, s_maxUrlsPerQuery);
+
+        QStringList placeholders;
         QMap<QString, QVariant> bindVariables;
-        bindVariables.insert(QStringLiteral(":url"), url);
-        QList<QVariantMap> faviconFound = m_fetchsqlite->query(m_query, bindVariables);
-        if (faviconFound.isEmpty())
-            return defaultIcon();
-
-        QByteArray iconData = faviconFound.first().value(m_blobcolumn).toByteArray();
-        // qDebug() << "Favicon found: " << iconData.size() << " bytes";
-        if (iconData.size() <= 0)
-            return defaultIcon();
-
-        iconFile.open(QFile::WriteOnly);
-        iconFile.write(iconData);
-        iconFile.close();
+        for (int i = 0; i < batch.size(); ++i) {
+            const QString placeholder = QStringLiteral(":url%1").arg(i);
+            placeholders << placeholder;
+            bindVariables.insert(placeholder, batch.at(i));
+        }
+        const QList<QVariantMap> faviconsFound = m_fetchsqlite->query(m_query.arg(placeholders.join(QLatin1Char(','))), bindVariables);
+
+        QHash<QString, QIcon> icons;
+        for (const QVariantMap &favicon : faviconsFound) {
+            const QString url = favicon.value(m_urlcolumn).toString();
+            if (icons.contains(url)) {
+                // Only the first, e.g. the largest, icon of a page is used
+                continue;
+            }
+            const QByteArray iconData = favicon.value(m_blobcolumn).toByteArray();
+            // qDebug() << "Favicon found: " << iconData.size() << " bytes";
+            if (iconData.size() <= 0) {
+                continue;
+            }
+
+            const QString fileChecksum = QString::number(qChecksum(url.toLatin1(), url.toLatin1().size()));
+            QFile iconFile(m_profileCacheDirectory + QDir::separator() + fileChecksum + QStringLiteral("_favicon"));
+            if (!iconFile.open(QFile::WriteOnly) || iconFile.write(iconData) != iconData.size()) {
+                continue;
+            }
+            iconFile.close();
+            icons.insert(url, QIcon(iconFile.fileName()));
+        }
+
+        QMutexLocker locker(&m_mutex);
+        for (const QString &url : batch) {
+            m_icons.insert(url, new QIcon(icons.value(url, defaultIcon())));
+        }
     }
-    return QIcon(iconFile.fileName());
 }
@@ -9,7 +9,9 @@
 
 #include "favicon.h"
 #include "fetchsqlite.h"
+#include <QCache>
 #include <QIcon>
+#include <QMutex>
 
 class FaviconFromBlob : public Favicon
 {
@@ -20,16 +22,30 @@ public:
     static FaviconFromBlob *falkon(const QString &profileDirectory, QObject *parent = nullptr);
     ~FaviconFromBlob() override;
     QIcon iconFor(const QString &url) override;
+    void prefetch(const QStringList &urls) override;
 
 public Q_SLOTS:
     void prepare() override;
     void teardown() override;
 
 private:
-    FaviconFromBlob(const QString &profileName, const QString &query, const QString &blobColumn, FetchSqlite *fetchSqlite, QObject *parent = nullptr);
+    /**
+     * @p query has to select the page url in @p urlColumn and the icon in @p blobColumn
+     * for the urls given as comma separated placeholders in place of %1
+     */
+    FaviconFromBlob(const QString &profileName,
+                    const QString &query,
+                    const QString &urlColumn,
+                    const QString &blobColumn,
+                    FetchSqlite *fetchSqlite,
+                    QObject *parent = nullptr);
     QString m_profileCacheDirectory;
     QString m_query;
+    QString const m_urlcolumn;
     QString const m_blobcolumn;
     FetchSqlite *m_fetchsqlite;
+    // Icons by page url, urls without a favicon are mapped to the default icon
+    QCache<QString, QIcon> m_icons;
+    QMutex m_mutex;
     void cleanCacheDirectory();
 };
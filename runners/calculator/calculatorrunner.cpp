@@ -54,6 +54,14 @@ CalculatorRunner::~CalculatorRunner()
 #endif
 }
 
+void CalculatorRunner::reloadConfiguration()
+{
+#ifdef ENABLE_QALCULATE
+    // Time after which evaluating an expression gets aborted, in milliseconds
+    m_engine->setTimeout(config().readEntry("evaluationTimeout", 2000));
+#endif
+}
+
 #ifndef ENABLE_QALCULATE
 void CalculatorRunner::powSubstitutions(QString &cmd)
 {
@@ -185,14 +193,14 @@ void CalculatorRunner::userFriendlySubstitutions(QString &cmd)
     hexSubstitutions(cmd);
     powSubstitutions(cmd);
 
-    QRegularExpression re(QStringLiteral("(\\d+)and(\\d+)"));
-    cmd.replace(re, QStringLiteral("\\1&\\2"));
+    static const QRegularExpression andRegex(QStringLiteral("(\\d+)and(\\d+)"));
+    cmd.replace(andRegex, QStringLiteral("\\1&\\2"));
 
-    re.setPattern(QStringLiteral("(\\d+)or(\\d+)"));
-    cmd.replace(re, QStringLiteral("\\1|\\2"));
+    static const QRegularExpression orRegex(QStringLiteral("(\\d+)or(\\d+)"));
+    cmd.replace(orRegex, QStringLiteral("\\1|\\2"));
 
-    re.setPattern(QStringLiteral("(\\d+)xor(\\d+)"));
-    cmd.replace(re, QStringLiteral("\\1^\\2"));
+    static const QRegularExpression xorRegex(QStringLiteral("(\\d+)xor(\\d+)"));
+    cmd.replace(xorRegex, QStringLiteral("\\1^\\2"));
 #endif
 }
 
@@ -255,7 +263,8 @@ void CalculatorRunner::match(Plasma::RunnerContext &context)
     userFriendlySubstitutions(cmd);
 #ifndef ENABLE_QALCULATE
     // needed for accessing math functions like sin(),....
-    cmd.replace(QRegularExpression(QStringLiteral("([a-zA-Z]+)")), QStringLiteral("Math.\\1"));
+    static const QRegularExpression functionRegex(QStringLiteral("([a-zA-Z]+)"));
+    cmd.replace(functionRegex, QStringLiteral("Math.\\1"));
 #endif
 
     bool isApproximate = false;
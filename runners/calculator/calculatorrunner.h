@@ -29,6 +29,7 @@ public:
     ~CalculatorRunner() override;
 
     void match(Plasma::RunnerContext &context) override;
+    void reloadConfiguration() override;
 
 protected Q_SLOTS:
     void run(const Plasma::RunnerContext &context, const Plasma::QueryMatch &match) override;
@@ -17,17 +17,36 @@
 #include <QClipboard>
 #include <QDebug>
 #include <QFile>
+#include <QMutexLocker>
+#include <QRegularExpression>
 
 #include <KIO/Job>
 #include <KLocalizedString>
 #include <KProtocolManager>
 
 QAtomicInt QalculateEngine::s_counter;
+QMutex QalculateEngine::s_calculatorMutex;
+
+// Evaluating huge factorials or powers can take much longer than typing the next character
+static const int s_defaultTimeout = 2000;
+// Results of the expressions evaluated last
+static const int s_cachedResults = 100;
+
+// Variables and functions of libqalculate whose value changes without the expression changing
+static bool isTimeDependent(const QString &expression)
+{
+    static const QRegularExpression names(QStringLiteral("\\b(now|today|tomorrow|yesterday|timestamp|rand|randn|randbetween|randpoisson)\\b"),
+                                          QRegularExpression::CaseInsensitiveOption);
+    return names.match(expression).hasMatch();
+}
 
 QalculateEngine::QalculateEngine(QObject *parent)
     : QObject(parent)
+    , m_timeout(s_defaultTimeout)
+    , m_results(s_cachedResults)
 {
     s_counter.ref();
+    QMutexLocker locker(&s_calculatorMutex);
     if (!CALCULATOR) {
         new Calculator();
         CALCULATOR->terminateThreads();
@@ -41,6 +60,7 @@ QalculateEngine::QalculateEngine(QObject *parent)
 QalculateEngine::~QalculateEngine()
 {
     if (s_counter.deref()) {
+        QMutexLocker locker(&s_calculatorMutex);
         delete CALCULATOR;
         CALCULATOR = nullptr;
     }
@@ -49,7 +69,9 @@ QalculateEngine::~QalculateEngine()
 void QalculateEngine::updateExchangeRates()
 {
     QUrl source = QUrl("http://www.ecb.int/stats/eurofxref/eurofxref-daily.xml");
+    QMutexLocker locker(&s_calculatorMutex);
     QUrl dest = QUrl::fromLocalFile(QFile::decodeName(CALCULATOR->getExchangeRatesFileName().c_str()));
+    locker.unlock();
 
     KIO::Job *getJob = KIO::file_copy(source, dest, -1, KIO::Overwrite | KIO::HideProgressInfo);
     connect(getJob, &KJob::result, this, &QalculateEngine::updateResult);
@@ -60,8 +82,14 @@ void QalculateEngine::updateResult(KJob *job)
     if (job->error()) {
         qDebug() << i18n("The exchange rates could not be updated. The following error has been reported: %1", job->errorString());
     } else {
-        // the exchange rates have been successfully updated, now load them
+        // the exchange rates have been successfully updated, now load them, not in the middle of an evaluation
+        QMutexLocker calculatorLocker(&s_calculatorMutex);
         CALCULATOR->loadExchangeRates();
+        calculatorLocker.unlock();
+
+        QMutexLocker locker(&m_mutex);
+        m_results.clear();
+        ++m_ratesGeneration;
     }
 }
 
@@ -72,11 +100,24 @@ QString QalculateEngine::evaluate(const QString &expression, bool *isApproximate
     }
 
     QString input = expression;
+    input.replace(QChar(0xA3), "GBP").replace(QChar(0xA5), "JPY").replace('$', "USD").replace(QChar(0x20AC), "EUR");
+
+    // The cache is shared by all match threads, a cached result does not wait for evaluations
+    QMutexLocker locker(&m_mutex);
+    if (const Result *cached = m_results.object(input)) {
+        if (isApproximate) {
+            *isApproximate = cached->isApproximate;
+        }
+        m_lastResult = cached->text;
+        return m_lastResult;
+    }
+    const int ratesGeneration = m_ratesGeneration;
+    locker.unlock();
+
     // Make sure to use toLocal8Bit, the expression can contain non-latin1 characters
-    QByteArray ba = input.replace(QChar(0xA3), "GBP").replace(QChar(0xA5), "JPY").replace('$', "USD").replace(QChar(0x20AC), "EUR").toLocal8Bit();
+    QByteArray ba = input.toLocal8Bit();
     const char *ctext = ba.data();
 
-    CALCULATOR->terminateThreads();
     EvaluationOptions eo;
 
     eo.auto_post_conversion = POST_CONVERSION_BEST;
@@ -89,8 +130,20 @@ QString QalculateEngine::evaluate(const QString &expression, bool *isApproximate
     // to avoid memory overflow for seemingly innocent calculations (Bug 277011)
     eo.approximation = APPROXIMATION_APPROXIMATE;
 
+    // One evaluation at a time, concurrent ones would abort or overwrite each other
+    QMutexLocker calculatorLocker(&s_calculatorMutex);
     CALCULATOR->setPrecision(16);
-    MathStructure result = CALCULATOR->calculate(ctext, eo);
+
+    // Evaluated in the calculation thread of libqalculate, which gets aborted once the time is up
+    MathStructure result;
+    if (!CALCULATOR->calculate(&result, ctext, m_timeout, eo)) {
+        calculatorLocker.unlock();
+        // not cached, it may well finish in time once the system is less busy
+        qDebug() << "qalculate aborted the evaluation of" << input << "after" << m_timeout << "ms";
+        locker.relock();
+        m_lastResult.clear();
+        return m_lastResult;
+    }
 
     PrintOptions po;
     po.number_fraction_format = FRACTION_DECIMAL;
@@ -107,10 +160,19 @@ QString QalculateEngine::evaluate(const QString &expression, bool *isApproximate
 
     result.format(po);
 
-    m_lastResult = result.print(po).c_str();
+    const QString text = QString::fromUtf8(result.print(po).c_str());
+    const bool approximate = result.isApproximate();
+    calculatorLocker.unlock();
+
+    locker.relock();
+    m_lastResult = text;
+    // results based on exchange rates replaced meanwhile are not kept either
+    if (!text.isEmpty() && !isTimeDependent(input) && ratesGeneration == m_ratesGeneration) {
+        m_results.insert(input, new Result{text, approximate});
+    }
 
     if (isApproximate) {
-        *isApproximate = result.isApproximate();
+        *isApproximate = approximate;
     }
 
     return m_lastResult;
@@ -7,6 +7,8 @@
 #pragma once
 
 #include <QAtomicInt>
+#include <QCache>
+#include <QMutex>
 #include <QObject>
 
 class KJob;
@@ -23,6 +25,14 @@ public:
         return m_lastResult;
     }
 
+    /**
+     * Evaluations taking longer than @p msecs get aborted and have no result
+     */
+    void setTimeout(int msecs)
+    {
+        m_timeout = msecs;
+    }
+
 public Q_SLOTS:
     QString evaluate(const QString &expression, bool *isApproximate = nullptr);
     void updateExchangeRates();
@@ -37,6 +47,21 @@ Q_SIGNALS:
     void formattedResultReady(const QString &);
 
 private:
+    struct Result {
+        QString text;
+        bool isApproximate = false;
+    };
+
     QString m_lastResult;
+    int m_timeout;
+    // Results by expression, neither aborted evaluations nor ones depending on the time are kept
+    QCache<QString, Result> m_results;
+    // Bumped whenever new exchange rates got loaded
+    int m_ratesGeneration = 0;
+    // Guards m_results, m_ratesGeneration and m_lastResult, not the evaluation itself
+    QMutex m_mutex;
+    // Serializes every use of CALCULATOR, which is shared by the whole process and evaluates
+    // in a single calculation thread of its own
+    static QMutex s_calculatorMutex;
     static QAtomicInt s_counter;
 };
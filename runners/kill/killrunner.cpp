@@ -10,6 +10,9 @@
 #include <QAction>
 #include <QDebug>
 #include <QIcon>
+#include <QtConcurrent>
+
+#include <algorithm>
 
 #include <KAuth>
 #include <KLocalizedString>
@@ -20,9 +23,46 @@
 
 K_PLUGIN_CLASS_WITH_JSON(KillRunner, "plasma-runner-kill.json")
 
+static const int s_refreshInterval = 2000; // ms
+
+struct ProcessSnapshot {
+    struct Entry {
+        quint64 pid;
+        QString name;
+        QString lowerName;
+        qreal cpuUsage;
+    };
+
+    // ordered by CPU usage, highest first
+    QVector<Entry> entries;
+    // (entry, offset) of every suffix of every lower-cased name, sorted by suffix:
+    // a name contains a term iff one of its suffixes starts with it
+    QVector<QPair<int, int>> suffixes;
+
+    QStringView suffix(const QPair<int, int> &suffix) const
+    {
+        return QStringView(entries.at(suffix.first).lowerName).mid(suffix.second);
+    }
+
+    /** @returns the entries whose name contains @p lowerTerm, in CPU usage order */
+    QVector<int> find(const QString &lowerTerm) const
+    {
+        auto it = std::lower_bound(suffixes.cbegin(), suffixes.cend(), lowerTerm, [this](const QPair<int, int> &s, const QString &term) {
+            return suffix(s) < QStringView(term);
+        });
+
+        QVector<int> ret;
+        for (; it != suffixes.cend() && suffix(*it).startsWith(lowerTerm); ++it) {
+            ret << it->first;
+        }
+        std::sort(ret.begin(), ret.end());
+        ret.erase(std::unique(ret.begin(), ret.end()), ret.end());
+        return ret;
+    }
+};
+
 KillRunner::KillRunner(QObject *parent, const KPluginMetaData &metaData, const QVariantList &args)
     : Plasma::AbstractRunner(parent, metaData, args)
-    , m_processes(nullptr)
 {
     setObjectName(QStringLiteral("Kill Runner"));
 
@@ -38,9 +78,16 @@ KillRunner::KillRunner(QObject *parent, const KPluginMetaData &metaData, const Q
     m_delayedCleanupTimer.setInterval(50);
     m_delayedCleanupTimer.setSingleShot(true);
     connect(&m_delayedCleanupTimer, &QTimer::timeout, this, &KillRunner::cleanup);
+
+    // Sampling periodically also gives meaningful CPU usage values, which need two samples
+    m_refreshTimer.setInterval(s_refreshInterval);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &KillRunner::scheduleRefresh);
 }
 
-KillRunner::~KillRunner() = default;
+KillRunner::~KillRunner()
+{
+    m_refreshFuture.waitForFinished();
+}
 
 void KillRunner::reloadConfiguration()
 {
@@ -67,54 +114,105 @@ void KillRunner::reloadConfiguration()
 void KillRunner::prep()
 {
     m_delayedCleanupTimer.stop();
+    // Get the process list ready before the first query comes in
+    scheduleRefresh();
+    m_refreshTimer.start();
 }
 
 void KillRunner::cleanup()
 {
-    if (!m_processes) {
+    m_refreshTimer.stop();
+
+    if (!m_refreshFuture.isFinished() || !m_processesMutex.tryLock()) {
+        m_delayedCleanupTimer.start();
         return;
     }
 
-    if (m_prepLock.tryLockForWrite()) {
-        delete m_processes;
-        m_processes = nullptr;
+    m_processes.reset();
+    m_processesMutex.unlock();
 
-        m_prepLock.unlock();
-    } else {
-        m_delayedCleanupTimer.stop();
+    QMutexLocker locker(&m_snapshotMutex);
+    m_snapshot.reset();
+}
+
+void KillRunner::scheduleRefresh()
+{
+    if (!m_refreshFuture.isFinished()) {
+        return;
     }
+    m_refreshFuture = QtConcurrent::run([this] {
+        refreshSnapshot();
+    });
 }
 
-void KillRunner::match(Plasma::RunnerContext &context)
+void KillRunner::refreshSnapshot(bool onlyIfMissing)
 {
-    QString term = context.query();
-    m_prepLock.lockForRead();
+    QMutexLocker locker(&m_processesMutex);
+    // a refresh running concurrently might just have provided one
+    if (onlyIfMissing && snapshot()) {
+        return;
+    }
+
     if (!m_processes) {
-        m_prepLock.unlock();
-        m_prepLock.lockForWrite();
-        if (!m_processes) {
-            suspendMatching(true);
-            m_processes = new KSysGuard::Processes();
-            m_processes->updateAllProcesses();
-            suspendMatching(false);
+        m_processes = std::make_unique<KSysGuard::Processes>();
+    }
+    m_processes->updateAllProcesses();
+
+    auto newSnapshot = std::make_shared<ProcessSnapshot>();
+    const QList<KSysGuard::Process *> processlist = m_processes->getAllProcesses();
+    newSnapshot->entries.reserve(processlist.size());
+    for (const KSysGuard::Process *process : processlist) {
+        const QString name = process->name();
+        newSnapshot->entries.append({quint64(process->pid()), name, name.toLower(), (process->userUsage() + process->sysUsage()) / 100.0});
+    }
+    locker.unlock();
+
+    std::stable_sort(newSnapshot->entries.begin(), newSnapshot->entries.end(), [](const ProcessSnapshot::Entry &a, const ProcessSnapshot::Entry &b) {
+        return a.cpuUsage > b.cpuUsage;
+    });
+
+    for (int i = 0; i < newSnapshot->entries.size(); ++i) {
+        for (int offset = 0; offset < newSnapshot->entries.at(i).lowerName.size(); ++offset) {
+            newSnapshot->suffixes.append(qMakePair(i, offset));
         }
     }
-    m_prepLock.unlock();
+    std::sort(newSnapshot->suffixes.begin(), newSnapshot->suffixes.end(), [&newSnapshot](const QPair<int, int> &a, const QPair<int, int> &b) {
+        return newSnapshot->suffix(a) < newSnapshot->suffix(b);
+    });
+
+    QMutexLocker snapshotLocker(&m_snapshotMutex);
+    m_snapshot = std::move(newSnapshot);
+}
+
+std::shared_ptr<const ProcessSnapshot> KillRunner::snapshot()
+{
+    QMutexLocker locker(&m_snapshotMutex);
+    return m_snapshot;
+}
+
+void KillRunner::match(Plasma::RunnerContext &context)
+{
+    QString term = context.query();
+
+    std::shared_ptr<const ProcessSnapshot> processes = snapshot();
+    if (!processes) {
+        // The query came in before the background refresh was done
+        refreshSnapshot(true);
+        processes = snapshot();
+    }
 
     term = term.right(term.length() - m_triggerWord.length());
 
     QList<Plasma::QueryMatch> matches;
-    const QList<KSysGuard::Process *> processlist = m_processes->getAllProcesses();
-    for (const KSysGuard::Process *process : processlist) {
+    const QVector<int> found = processes->find(term.toLower());
+    for (int i : found) {
         if (!context.isValid()) {
             return;
         }
-        const QString name = process->name();
-        if (!name.contains(term, Qt::CaseInsensitive)) {
-            continue;
-        }
+        const ProcessSnapshot::Entry &process = processes->entries.at(i);
+        const QString &name = process.name;
 
-        const quint64 pid = process->pid();
+        const quint64 pid = process.pid;
         Plasma::QueryMatch match(this);
         match.setText(i18n("Terminate %1", name));
         match.setSubtext(i18n("Process ID: %1", QString::number(pid)));
@@ -126,10 +224,10 @@ void KillRunner::match(Plasma::RunnerContext &context)
         // Set the relevance
         switch (m_sorting) {
         case Sort::CPU:
-            match.setRelevance((process->userUsage() + process->sysUsage()) / 100);
+            match.setRelevance(process.cpuUsage);
             break;
         case Sort::CPUI:
-            match.setRelevance(1 - (process->userUsage() + process->sysUsage()) / 100);
+            match.setRelevance(1 - process.cpuUsage);
             break;
         case Sort::NONE:
             match.setRelevance(name.compare(term, Qt::CaseInsensitive) == 0 ? 1 : 9);
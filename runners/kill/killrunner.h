@@ -7,18 +7,21 @@
 
 #pragma once
 
-#include <QReadWriteLock>
+#include <QFuture>
+#include <QMutex>
 #include <QTimer>
 
 #include <KRunner/AbstractRunner>
 
+#include <memory>
+
 #include "config_keys.h"
 class QAction;
+struct ProcessSnapshot;
 
 namespace KSysGuard
 {
 class Processes;
-class Process;
 }
 
 class KillRunner : public Plasma::AbstractRunner
@@ -36,19 +39,30 @@ public:
 private Q_SLOTS:
     void prep();
     void cleanup();
+    void scheduleRefresh();
 
 private:
+    /** Updates the process list and swaps in a new snapshot of it */
+    void refreshSnapshot(bool onlyIfMissing = false);
+    std::shared_ptr<const ProcessSnapshot> snapshot();
+
     /** The trigger word */
     QString m_triggerWord;
 
     /** How to sort */
     Sort m_sorting;
 
-    /** process lister */
-    KSysGuard::Processes *m_processes;
+    /** process lister, only used by refreshSnapshot() */
+    std::unique_ptr<KSysGuard::Processes> m_processes;
+    QMutex m_processesMutex;
+
+    /** latest read-only snapshot of the processes, shared with the matching threads */
+    std::shared_ptr<const ProcessSnapshot> m_snapshot;
+    QMutex m_snapshotMutex;
 
-    /** lock for initializing m_processes */
-    QReadWriteLock m_prepLock;
+    /** timer for refreshing the snapshot in the background while a query session is running */
+    QTimer m_refreshTimer;
+    QFuture<void> m_refreshFuture;
 
     /** timer for retrying the cleanup due to lock contention */
     QTimer m_delayedCleanupTimer;
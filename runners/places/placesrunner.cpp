@@ -7,8 +7,8 @@
 #include "placesrunner.h"
 
 #include <QCoreApplication>
+#include <QMutexLocker>
 #include <QThread>
-#include <QTimer>
 
 #include <QDebug>
 #include <QIcon>
@@ -42,83 +42,48 @@ PlacesRunner::~PlacesRunner()
 
 void PlacesRunner::match(Plasma::RunnerContext &context)
 {
-    if (QThread::currentThread() == QCoreApplication::instance()->thread()) {
-        // from the main thread
-        // qDebug() << "calling";
-        m_helper->match(&context);
-    } else {
-        // from the non-gui thread
-        // qDebug() << "emitting";
-        Q_EMIT doMatch(&context);
-    }
-    // m_helper->match(c);
-}
-
-PlacesRunnerHelper::PlacesRunnerHelper(PlacesRunner *runner)
-    : QObject(runner)
-{
-    Q_ASSERT(QThread::currentThread() == QCoreApplication::instance()->thread());
-    connect(runner, &PlacesRunner::doMatch, this, &PlacesRunnerHelper::match, Qt::BlockingQueuedConnection);
+    const QString term = context.query();
+    const bool all = term.compare(i18n("places"), Qt::CaseInsensitive) == 0;
 
-    connect(&m_places, &KFilePlacesModel::setupDone, this, [this](const QModelIndex &index, bool success) {
-        if (success && m_pendingUdi == m_places.deviceForIndex(index).udi()) {
-            auto *job = new KIO::OpenUrlJob(m_places.url(index));
-            job->setUiDelegate(new KNotificationJobUiDelegate(KJobUiDelegate::AutoErrorHandlingEnabled));
-            job->setRunExecutables(false);
-            job->start();
+    const auto places = m_helper->places();
+    QList<Plasma::QueryMatch> matches;
+    for (const PlacesRunnerHelper::Place &place : *places) {
+        if (!context.isValid()) {
+            return;
         }
-        m_pendingUdi.clear();
-    });
-}
 
-void PlacesRunnerHelper::match(Plasma::RunnerContext *c)
-{
-    Plasma::RunnerContext &context = *c;
-    if (!context.isValid()) {
-        return;
-    }
-
-    const QString term = context.query();
-    QList<Plasma::QueryMatch> matches;
-    const bool all = term.compare(i18n("places"), Qt::CaseInsensitive) == 0;
-    for (int i = 0; i <= m_places.rowCount(); i++) {
-        QModelIndex current_index = m_places.index(i, 0);
         Plasma::QueryMatch::Type type = Plasma::QueryMatch::NoMatch;
         qreal relevance = 0;
 
-        const QString text = m_places.text(current_index);
-        if ((all && !text.isEmpty()) || text.compare(term, Qt::CaseInsensitive) == 0) {
+        if ((all && !place.text.isEmpty()) || place.text.compare(term, Qt::CaseInsensitive) == 0) {
             type = Plasma::QueryMatch::ExactMatch;
             relevance = all ? 0.9 : 1.0;
-        } else if (text.contains(term, Qt::CaseInsensitive)) {
+        } else if (place.text.contains(term, Qt::CaseInsensitive)) {
             type = Plasma::QueryMatch::PossibleMatch;
             relevance = 0.7;
         }
 
         if (type != Plasma::QueryMatch::NoMatch) {
-            Plasma::QueryMatch match(static_cast<PlacesRunner *>(parent()));
+            Plasma::QueryMatch match(this);
             match.setType(type);
             match.setRelevance(relevance);
-            match.setIcon(m_places.icon(current_index));
-            match.setText(text);
+            match.setIconName(place.iconName);
+            match.setText(place.text);
 
             // Add category as subtext so one can tell "Pictures" folder from "Search for Pictures"
             // Don't add it if it would match the category ("Places") of the runner to avoid "Places: Pictures (Places)"
-            const QString groupName = m_places.data(current_index, KFilePlacesModel::GroupRole).toString();
-            if (!groupName.isEmpty() && static_cast<PlacesRunner *>(parent())->name() != groupName) {
-                match.setSubtext(groupName);
+            if (!place.groupName.isEmpty() && name() != place.groupName) {
+                match.setSubtext(place.groupName);
             }
 
             // if we have to mount it set the device udi instead of the URL, as we can't open it directly
-            if (m_places.isDevice(current_index) && m_places.setupNeeded(current_index)) {
-                const QString udi = m_places.deviceForIndex(current_index).udi();
-                match.setId(udi);
-                match.setData(udi);
+            if (!place.udi.isEmpty()) {
+                match.setId(place.udi);
+                match.setData(place.udi);
             } else {
-                const QUrl url = KFilePlacesModel::convertedUrl(m_places.url(current_index));
-                match.setData(url);
-                match.setUrls({url});
-                match.setId(url.toDisplayString());
+                match.setData(place.url);
+                match.setUrls({place.url});
+                match.setId(place.url.toDisplayString());
             }
 
             matches << match;
@@ -128,6 +93,61 @@ void PlacesRunnerHelper::match(Plasma::RunnerContext *c)
     context.addMatches(matches);
 }
 
+PlacesRunnerHelper::PlacesRunnerHelper(PlacesRunner *runner)
+    : QObject(runner)
+{
+    Q_ASSERT(QThread::currentThread() == QCoreApplication::instance()->thread());
+
+    connect(&m_places, &KFilePlacesModel::setupDone, this, [this](const QModelIndex &index, bool success) {
+        if (success && m_pendingUdi == m_places.deviceForIndex(index).udi()) {
+            auto *job = new KIO::OpenUrlJob(m_places.url(index));
+            job->setUiDelegate(new KNotificationJobUiDelegate(KJobUiDelegate::AutoErrorHandlingEnabled));
+            job->setRunExecutables(false);
+            job->start();
+        }
+        m_pendingUdi.clear();
+    });
+
+    // The model is only ever touched here in the main thread, matching uses the snapshot
+    connect(&m_places, &QAbstractItemModel::rowsInserted, this, &PlacesRunnerHelper::updatePlaces);
+    connect(&m_places, &QAbstractItemModel::rowsRemoved, this, &PlacesRunnerHelper::updatePlaces);
+    connect(&m_places, &QAbstractItemModel::rowsMoved, this, &PlacesRunnerHelper::updatePlaces);
+    connect(&m_places, &QAbstractItemModel::dataChanged, this, &PlacesRunnerHelper::updatePlaces);
+    connect(&m_places, &QAbstractItemModel::layoutChanged, this, &PlacesRunnerHelper::updatePlaces);
+    connect(&m_places, &QAbstractItemModel::modelReset, this, &PlacesRunnerHelper::updatePlaces);
+    updatePlaces();
+}
+
+std::shared_ptr<const QVector<PlacesRunnerHelper::Place>> PlacesRunnerHelper::places() const
+{
+    QMutexLocker locker(&m_snapshotMutex);
+    return m_snapshot;
+}
+
+void PlacesRunnerHelper::updatePlaces()
+{
+    auto places = std::make_shared<QVector<Place>>();
+    places->reserve(m_places.rowCount());
+
+    for (int i = 0; i < m_places.rowCount(); ++i) {
+        const QModelIndex index = m_places.index(i, 0);
+
+        Place place;
+        place.text = m_places.text(index);
+        place.iconName = m_places.data(index, KFilePlacesModel::IconNameRole).toString();
+        place.groupName = m_places.data(index, KFilePlacesModel::GroupRole).toString();
+        if (m_places.isDevice(index) && m_places.setupNeeded(index)) {
+            place.udi = m_places.deviceForIndex(index).udi();
+        } else {
+            place.url = KFilePlacesModel::convertedUrl(m_places.url(index));
+        }
+        *places << place;
+    }
+
+    QMutexLocker locker(&m_snapshotMutex);
+    m_snapshot = std::move(places);
+}
+
 void PlacesRunnerHelper::openDevice(const QString &udi)
 {
     m_pendingUdi.clear();
@@ -9,22 +9,46 @@
 #include <kfileplacesmodel.h>
 #include <krunner/abstractrunner.h>
 
+#include <QMutex>
+#include <QVector>
+
+#include <memory>
+
 class PlacesRunner;
 
+/**
+ * Owns the places model, which has to live in the main thread, and keeps a
+ * snapshot of its entries which can be matched against from any thread.
+ */
 class PlacesRunnerHelper : public QObject
 {
     Q_OBJECT
 
 public:
+    struct Place {
+        QString text;
+        QString iconName;
+        QString groupName;
+        QUrl url;
+        // Set for devices which need to be set up before they can be opened
+        QString udi;
+    };
+
     explicit PlacesRunnerHelper(PlacesRunner *runner);
 
+    std::shared_ptr<const QVector<Place>> places() const;
+
 public Q_SLOTS:
-    void match(Plasma::RunnerContext *context);
     void openDevice(const QString &udi);
 
 private:
+    void updatePlaces();
+
     KFilePlacesModel m_places;
     QString m_pendingUdi;
+
+    mutable QMutex m_snapshotMutex;
+    std::shared_ptr<const QVector<Place>> m_snapshot;
 };
 
 class PlacesRunner : public Plasma::AbstractRunner
@@ -38,9 +62,6 @@ public:
     void match(Plasma::RunnerContext &context) override;
     void run(const Plasma::RunnerContext &context, const Plasma::QueryMatch &action) override;
 
-Q_SIGNALS:
-    void doMatch(Plasma::RunnerContext *context);
-
 private:
     PlacesRunnerHelper *m_helper;
 };
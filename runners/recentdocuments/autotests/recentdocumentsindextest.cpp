@@ -0,0 +1,114 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <QObject>
+#include <QTest>
+
+#include "recentdocumentsindex.h"
+
+class RecentDocumentsIndexTest : public QObject
+{
+    Q_OBJECT
+
+private:
+    QStringList fileNames(const RecentDocumentsIndex &index, const QVector<int> &rows);
+
+private Q_SLOTS:
+    void testMatch();
+    void testMatch_data();
+    void testNarrowing();
+    void testUpdatedEntries();
+    void benchmarkTyping();
+};
+
+QStringList RecentDocumentsIndexTest::fileNames(const RecentDocumentsIndex &index, const QVector<int> &rows)
+{
+    QStringList ret;
+    for (int row : rows) {
+        ret << index.entries().at(row).fileName;
+    }
+    return ret;
+}
+
+void RecentDocumentsIndexTest::testMatch_data()
+{
+    QTest::addColumn<QString>("term");
+    QTest::addColumn<QStringList>("expectedFileNames");
+
+    QTest::newRow("file name prefix") << "repo" << QStringList{"report.odt", "Reports"};
+    QTest::newRow("case insensitive") << "REPORT" << QStringList{"report.odt", "Reports"};
+    QTest::newRow("directory prefix") << "holi" << QStringList{"beach.jpg"};
+    QTest::newRow("no prefix match") << "port" << QStringList{};
+}
+
+void RecentDocumentsIndexTest::testMatch()
+{
+    QFETCH(QString, term);
+    QFETCH(QStringList, expectedFileNames);
+
+    const RecentDocumentsIndex index({
+        {"/home/user/Documents/report.odt", "report.odt"},
+        {"/home/user/Pictures/Holidays/beach.jpg", "beach.jpg"},
+        {"/home/user/Reports", "Reports"},
+        {"/home/user/notes.txt", "notes.txt"},
+    });
+
+    // Results keep the order the resources were used in
+    QCOMPARE(fileNames(index, index.match(term)), expectedFileNames);
+}
+
+void RecentDocumentsIndexTest::testNarrowing()
+{
+    const RecentDocumentsIndex index({
+        {"/home/user/Documents/report.odt", "report.odt"},
+        {"/home/user/Documents/receipt.pdf", "receipt.pdf"},
+        {"/home/user/Documents/recipe.txt", "recipe.txt"},
+    });
+
+    const QVector<int> re = index.match(QStringLiteral("re"));
+    QCOMPARE(re.size(), 3);
+    const QVector<int> rec = index.match(QStringLiteral("rec"), re);
+    QCOMPARE(rec, index.match(QStringLiteral("rec")));
+    QCOMPARE(fileNames(index, index.match(QStringLiteral("reci"), rec)), QStringList{"recipe.txt"});
+}
+
+void RecentDocumentsIndexTest::testUpdatedEntries()
+{
+    // As the runner does when a file gets used: the new entry goes first, the published index stays as it was
+    QVector<RecentDocumentsIndex::Entry> entries{RecentDocumentsIndex::entry("/home/user/Documents/report.odt", "report.odt")};
+    const RecentDocumentsIndex before(entries);
+    entries.prepend(RecentDocumentsIndex::entry("/home/user/Documents/receipt.pdf", "receipt.pdf"));
+    const RecentDocumentsIndex after(entries);
+
+    QCOMPARE(fileNames(before, before.match(QStringLiteral("re"))), QStringList{"report.odt"});
+    QCOMPARE(fileNames(after, after.match(QStringLiteral("re"))), QStringList({"receipt.pdf", "report.odt"}));
+}
+
+void RecentDocumentsIndexTest::benchmarkTyping()
+{
+    QVector<QPair<QString, QString>> resources;
+    resources.reserve(10000);
+    for (int i = 0; i < 10000; ++i) {
+        const QString fileName = QStringLiteral("document-%1.odt").arg(i);
+        resources << qMakePair(QStringLiteral("/home/user/Project %1/%2").arg(i % 100).arg(fileName), fileName);
+    }
+    const RecentDocumentsIndex index(resources);
+    QCOMPARE(index.match(QStringLiteral("document-9999")).size(), 1);
+
+    QBENCHMARK {
+        QVector<int> matches;
+        QString term;
+        for (const QChar c : QStringLiteral("document-42")) {
+            term += c;
+            matches = term.size() == 1 ? index.match(term) : index.match(term, matches);
+        }
+        QCOMPARE(matches.size(), 111); // document-42, document-420..429 and document-4200..4299
+    }
+}
+
+QTEST_MAIN(RecentDocumentsIndexTest)
+
+#include "recentdocumentsindextest.moc"
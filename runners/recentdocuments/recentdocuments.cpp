@@ -9,6 +9,9 @@
 #include <QAction>
 #include <QDir>
 #include <QMimeData>
+#include <QMutexLocker>
+
+#include <algorithm>
 
 #include <KIO/Job>
 #include <KIO/OpenFileManagerWindowJob>
@@ -24,6 +27,11 @@
 using namespace KActivities::Stats;
 using namespace KActivities::Stats::Terms;
 
+// Recently used resources kept in the index
+static const int s_maxResources = 10000;
+// Matches reported for a query
+static const int s_maxMatches = 20;
+
 K_PLUGIN_CLASS_WITH_JSON(RecentDocuments, "plasma-runner-recentdocuments.json")
 
 RecentDocuments::RecentDocuments(QObject *parent, const KPluginMetaData &metaData, const QVariantList &args)
@@ -35,52 +43,159 @@ RecentDocuments::RecentDocuments(QObject *parent, const KPluginMetaData &metaDat
 
     m_actions = {new QAction(QIcon::fromTheme(QStringLiteral("document-open-folder")), i18n("Open Containing Folder"), this)};
     setMinLetterCount(3);
+
+    // The model has to be created in the main thread, where the match session gets prepared
+    connect(this, &Plasma::AbstractRunner::prepare, this, &RecentDocuments::init);
 }
 
 RecentDocuments::~RecentDocuments()
 {
 }
 
-void RecentDocuments::match(Plasma::RunnerContext &context)
+void RecentDocuments::init()
 {
-    if (!context.isValid()) {
+    if (m_model) {
         return;
     }
 
     // clang-format off
-    const QString term = context.query();
     auto query = UsedResources
             | Activity::current()
             | Order::RecentlyUsedFirst
             | Agent::any()
             // we search only on file name, as KActivity does not support better options
-            | Url("/*/" + term + "*")
-            | Limit(20);
+            | Url::localFile()
+            | Limit(s_maxResources);
     // clang-format on
 
-    const auto result = new ResultModel(query);
+    m_model = std::make_unique<ResultModel>(query);
+
+    // Publish the changes of the model at once, e.g. when switching activities
+    m_publishTimer.setSingleShot(true);
+    m_publishTimer.setInterval(0);
+    connect(&m_publishTimer, &QTimer::timeout, this, &RecentDocuments::publishIndex);
+
+    // Fetching queries the database, one chunk per event loop pass keeps the main thread responsive
+    m_fetchTimer.setSingleShot(true);
+    m_fetchTimer.setInterval(0);
+    connect(&m_fetchTimer, &QTimer::timeout, this, &RecentDocuments::fetchMore);
+
+    // Only the rows which changed get read again
+    connect(m_model.get(), &QAbstractItemModel::rowsInserted, this, [this](const QModelIndex &, int first, int last) {
+        m_entries.insert(first, last - first + 1, RecentDocumentsIndex::Entry());
+        for (int row = first; row <= last; ++row) {
+            m_entries[row] = entryAt(row);
+        }
+        m_publishTimer.start();
+    });
+    connect(m_model.get(), &QAbstractItemModel::rowsRemoved, this, [this](const QModelIndex &, int first, int last) {
+        m_entries.remove(first, last - first + 1);
+        m_publishTimer.start();
+    });
+    connect(m_model.get(), &QAbstractItemModel::rowsMoved, this, [this](const QModelIndex &, int start, int end, const QModelIndex &, int row) {
+        const int count = end - start + 1;
+        const QVector<RecentDocumentsIndex::Entry> moved = m_entries.mid(start, count);
+        m_entries.remove(start, count);
+        const int destination = row > start ? row - count : row;
+        m_entries.insert(destination, count, RecentDocumentsIndex::Entry());
+        std::copy(moved.cbegin(), moved.cend(), m_entries.begin() + destination);
+        m_publishTimer.start();
+    });
+    connect(m_model.get(), &QAbstractItemModel::dataChanged, this, [this](const QModelIndex &topLeft, const QModelIndex &bottomRight, const QVector<int> &roles) {
+        // Using a file changes its score, which is not part of the index
+        if (!roles.isEmpty() && !roles.contains(ResultModel::ResourceRole) && !roles.contains(ResultModel::TitleRole)) {
+            return;
+        }
+        for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+            m_entries[row] = entryAt(row);
+        }
+        m_publishTimer.start();
+    });
+    connect(m_model.get(), &QAbstractItemModel::layoutChanged, this, &RecentDocuments::resetEntries);
+    connect(m_model.get(), &QAbstractItemModel::modelReset, this, &RecentDocuments::resetEntries);
+
+    resetEntries();
+}
+
+RecentDocumentsIndex::Entry RecentDocuments::entryAt(int row) const
+{
+    const auto index = m_model->index(row, 0);
+    return RecentDocumentsIndex::entry(m_model->data(index, ResultModel::ResourceRole).toString(), m_model->data(index, ResultModel::TitleRole).toString());
+}
 
-    for (int i = 0; i < result->rowCount(); ++i) {
-        const auto index = result->index(i, 0);
+void RecentDocuments::resetEntries()
+{
+    m_entries.clear();
+    m_entries.reserve(m_model->rowCount());
+    for (int row = 0; row < m_model->rowCount(); ++row) {
+        m_entries << entryAt(row);
+    }
+    m_fetchTimer.start();
+    m_publishTimer.start();
+}
+
+void RecentDocuments::fetchMore()
+{
+    if (!m_model->canFetchMore(QModelIndex())) {
+        return;
+    }
+    // The new rows arrive through rowsInserted
+    m_model->fetchMore(QModelIndex());
+    m_fetchTimer.start();
+}
+
+void RecentDocuments::publishIndex()
+{
+    // Shares the entries, the next change of the model copies them once
+    auto index = std::make_shared<const RecentDocumentsIndex>(m_entries);
+
+    QMutexLocker locker(&m_indexMutex);
+    m_index = std::move(index);
+}
+
+void RecentDocuments::match(Plasma::RunnerContext &context)
+{
+    if (!context.isValid()) {
+        return;
+    }
+
+    std::shared_ptr<const RecentDocumentsIndex> index;
+    {
+        QMutexLocker locker(&m_indexMutex);
+        index = m_index;
+    }
+    if (!index) {
+        return;
+    }
+
+    const QString term = context.query();
+    QVector<int> matches;
+    {
+        QMutexLocker locker(&m_cacheMutex);
+        if (m_cache.index == index && !m_cache.term.isEmpty() && term.startsWith(m_cache.term, Qt::CaseInsensitive)) {
+            matches = index->match(term, m_cache.matches);
+        } else {
+            matches = index->match(term);
+        }
+        m_cache = {index, term, matches};
+    }
 
-        const auto url = QUrl::fromUserInput(result->data(index, ResultModel::ResourceRole).toString(),
-                                             QString(),
-                                             // We can assume local file thanks to the request Url
-                                             QUrl::AssumeLocalFile);
-        const auto name = result->data(index, ResultModel::TitleRole).toString();
+    for (int i = 0; i < matches.size() && i < s_maxMatches; ++i) {
+        const RecentDocumentsIndex::Entry &entry = index->entries().at(matches.at(i));
+        const QUrl &url = entry.url;
 
         Plasma::QueryMatch match(this);
 
         auto relevance = 0.5;
         match.setType(Plasma::QueryMatch::PossibleMatch);
-        if (url.fileName() == term) {
+        if (entry.fileName == term) {
             relevance = 1.0;
             match.setType(Plasma::QueryMatch::ExactMatch);
-        } else if (url.fileName().startsWith(term)) {
+        } else if (entry.fileName.startsWith(term)) {
             relevance = 0.9;
             match.setType(Plasma::QueryMatch::PossibleMatch);
         }
-        match.setIconName(KIO::iconNameForUrl(url));
+        match.setIconName(RecentDocumentsIndex::iconName(url));
         match.setRelevance(relevance);
         match.setData(QVariant(url));
         match.setUrls({url});
@@ -88,7 +203,7 @@ void RecentDocuments::match(Plasma::RunnerContext &context)
         if (url.isLocalFile()) {
             match.setActions(m_actions);
         }
-        match.setText(name);
+        match.setText(entry.title);
 
         QString destUrlString = KShell::tildeCollapse(url.adjusted(QUrl::RemoveFilename | QUrl::StripTrailingSlash).path());
         match.setSubtext(destUrlString);
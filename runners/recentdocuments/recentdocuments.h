@@ -10,6 +10,20 @@
 
 #include <QAction>
 #include <QIcon>
+#include <QMutex>
+#include <QTimer>
+
+#include <memory>
+
+#include "recentdocumentsindex.h"
+
+namespace KActivities
+{
+namespace Stats
+{
+class ResultModel;
+}
+}
 
 class RecentDocuments : public Plasma::AbstractRunner
 {
@@ -23,5 +37,30 @@ public:
     void run(const Plasma::RunnerContext &context, const Plasma::QueryMatch &match) override;
 
 private:
+    void init();
+    RecentDocumentsIndex::Entry entryAt(int row) const;
+    void resetEntries();
+    void fetchMore();
+    void publishIndex();
+
     QList<QAction *> m_actions;
+
+    // Lives in the main thread and follows the current activity
+    std::unique_ptr<KActivities::Stats::ResultModel> m_model;
+    // The rows of the model, kept up to date with its changes and published as m_index
+    QVector<RecentDocumentsIndex::Entry> m_entries;
+    QTimer m_fetchTimer;
+    QTimer m_publishTimer;
+
+    QMutex m_indexMutex;
+    std::shared_ptr<const RecentDocumentsIndex> m_index;
+
+    // Matches of the previous query, narrowed down while the user keeps typing
+    struct QueryCache {
+        std::shared_ptr<const RecentDocumentsIndex> index;
+        QString term;
+        QVector<int> matches;
+    };
+    QMutex m_cacheMutex;
+    QueryCache m_cache;
 };
@@ -0,0 +1,83 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "recentdocumentsindex.h"
+
+#include <QCache>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <KIO/Global>
+
+#include <numeric>
+
+RecentDocumentsIndex::RecentDocumentsIndex(const QVector<QPair<QString, QString>> &resources)
+{
+    m_entries.reserve(resources.size());
+
+    for (const auto &resource : resources) {
+        m_entries << entry(resource.first, resource.second);
+    }
+}
+
+RecentDocumentsIndex::RecentDocumentsIndex(const QVector<Entry> &entries)
+    : m_entries(entries)
+{
+}
+
+RecentDocumentsIndex::Entry RecentDocumentsIndex::entry(const QString &resource, const QString &title)
+{
+    Entry entry;
+    entry.url = QUrl::fromUserInput(resource,
+                                    QString(),
+                                    // Only local files get indexed
+                                    QUrl::AssumeLocalFile);
+    entry.title = title;
+    entry.fileName = entry.url.fileName();
+    entry.lowerPath = entry.url.path().toLower();
+    return entry;
+}
+
+QVector<int> RecentDocumentsIndex::match(const QString &term, const QVector<int> &candidates) const
+{
+    // Same as the "/*/term*" url pattern we used to query the activity manager with
+    const QString needle = QLatin1Char('/') + term.toLower();
+
+    QVector<int> ret;
+    for (int row : candidates) {
+        if (m_entries.at(row).lowerPath.contains(needle)) {
+            ret << row;
+        }
+    }
+    return ret;
+}
+
+QVector<int> RecentDocumentsIndex::match(const QString &term) const
+{
+    QVector<int> all(m_entries.size());
+    std::iota(all.begin(), all.end(), 0);
+    return match(term, all);
+}
+
+QString RecentDocumentsIndex::iconName(const QUrl &url)
+{
+    static QMutex mutex;
+    static QCache<QUrl, QString> iconNames(1000);
+
+    {
+        QMutexLocker locker(&mutex);
+        if (const QString *iconName = iconNames.object(url)) {
+            return *iconName;
+        }
+    }
+
+    // Looking up the mime type may need to read the file
+    const QString iconName = KIO::iconNameForUrl(url);
+
+    QMutexLocker locker(&mutex);
+    iconNames.insert(url, new QString(iconName));
+    return iconName;
+}
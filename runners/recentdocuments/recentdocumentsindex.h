@@ -0,0 +1,61 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QPair>
+#include <QString>
+#include <QUrl>
+#include <QVector>
+
+/**
+ * Immutable index of recently used local files, in the order they were used.
+ *
+ * Lookups return positions in entries(). They can be narrowed down while the
+ * query grows, so that typing doesn't rescan all resources.
+ */
+class RecentDocumentsIndex
+{
+public:
+    struct Entry {
+        QUrl url;
+        QString title;
+        QString fileName;
+        // Lower-cased path, used for matching
+        QString lowerPath;
+    };
+
+    /**
+     * Builds the index from pairs of resource path and title
+     */
+    explicit RecentDocumentsIndex(const QVector<QPair<QString, QString>> &resources);
+    /**
+     * Builds the index from @p entries, which are shared rather than copied
+     */
+    explicit RecentDocumentsIndex(const QVector<Entry> &entries);
+
+    static Entry entry(const QString &resource, const QString &title);
+
+    const QVector<Entry> &entries() const
+    {
+        return m_entries;
+    }
+
+    /**
+     * @returns the resources among @p candidates having a path component starting with @p term.
+     * For a term starting with the term @p candidates were computed for, the result only ever shrinks.
+     */
+    QVector<int> match(const QString &term, const QVector<int> &candidates) const;
+    QVector<int> match(const QString &term) const;
+
+    /**
+     * Same as KIO::iconNameForUrl, remembering the icons of recently looked up urls
+     */
+    static QString iconName(const QUrl &url);
+
+private:
+    QVector<Entry> m_entries;
+};
@@ -32,6 +32,10 @@ private Q_SLOTS:
     void testKonsoleVsYakuakeComment();
     void testSystemSettings();
     void testINotifyUsage();
+    void testIncrementalQuery();
+    void testRepeatedSpaces();
+    void testExecArguments();
+    void benchmarkTyping();
 };
 
 void ServiceRunnerTest::initTestCase()
@@ -188,6 +192,93 @@ void ServiceRunnerTest::testINotifyUsage()
     QVERIFY(inotifyCountCool);
 }
 
+static QStringList matchTexts(ServiceRunner &runner, const QString &query)
+{
+    Plasma::RunnerContext context;
+    context.setQuery(query);
+    runner.match(context);
+
+    QStringList texts;
+    const auto matches = context.matches();
+    for (const auto &match : matches) {
+        texts << match.text();
+    }
+    texts.sort();
+    return texts;
+}
+
+void ServiceRunnerTest::testIncrementalQuery()
+{
+    // Narrowing down the candidates of the previous query must not lose any match
+    ServiceRunner typingRunner(this, KPluginMetaData(), QVariantList());
+    QStringList typed;
+    for (const QString &query : {QStringLiteral("k"), QStringLiteral("ko"), QStringLiteral("kon"), QStringLiteral("kons"), QStringLiteral("konso")}) {
+        typed = matchTexts(typingRunner, query);
+    }
+
+    ServiceRunner freshRunner(this, KPluginMetaData(), QVariantList());
+    QCOMPARE(typed, matchTexts(freshRunner, QStringLiteral("konso")));
+    QVERIFY(typed.contains(QLatin1String("Konsole ServiceRunnerTest")));
+}
+
+void ServiceRunnerTest::testRepeatedSpaces()
+{
+    // Empty words between the spaces must not change anything
+    ServiceRunner runner(this, KPluginMetaData(), QVariantList());
+    const QStringList expected = matchTexts(runner, QStringLiteral("konsole servicerunnertest"));
+    QVERIFY(expected.contains(QLatin1String("Konsole ServiceRunnerTest")));
+    QCOMPARE(matchTexts(runner, QStringLiteral("konsole  servicerunnertest")), expected);
+}
+
+void ServiceRunnerTest::testExecArguments()
+{
+    // The whole command line is matched, launchers are found by what they launch
+    ServiceRunner runner(this, KPluginMetaData(), QVariantList());
+    QVERIFY(matchTexts(runner, QStringLiteral("bikioccmkaf")).contains(QLatin1String("Signal ServiceRunnerTest")));
+    QVERIFY(matchTexts(runner, QStringLiteral("google-chrome")).contains(QLatin1String("Signal ServiceRunnerTest")));
+
+    // but not by its field codes
+    QVERIFY(!matchTexts(runner, QStringLiteral("%u")).contains(QLatin1String("Google Chrome ServiceRunnerTest")));
+}
+
+void ServiceRunnerTest::benchmarkTyping()
+{
+    // Runs last, it floods the database with generated services
+    const QString appsPath = QStandardPaths::writableLocation(QStandardPaths::ApplicationsLocation);
+    for (int i = 0; i < 3000; ++i) {
+        QFile file(appsPath + QStringLiteral("/benchmark-%1.desktop").arg(i));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(QStringLiteral("[Desktop Entry]\n"
+                                  "Type=Application\n"
+                                  "Name=Benchmark Application %1\n"
+                                  "GenericName=Generated Tool %1\n"
+                                  "Comment=Generated for the service runner benchmark\n"
+                                  "Keywords=benchmark;generated;tool%1;\n"
+                                  "Categories=Qt;KDE;Utility;\n"
+                                  "Exec=benchmark-app-%1\n"
+                                  "Actions=NewWindow;\n"
+                                  "\n"
+                                  "[Desktop Action NewWindow]\n"
+                                  "Name=Open New Benchmark Window\n"
+                                  "Exec=benchmark-app-%1 --new-window\n")
+                       .arg(i)
+                       .toUtf8());
+    }
+    KSycoca::self()->ensureCacheValid();
+
+    ServiceRunner runner(this, KPluginMetaData(), QVariantList());
+    QVERIFY(!matchTexts(runner, QStringLiteral("benchmark application 2999")).isEmpty());
+
+    QBENCHMARK {
+        for (const QString &query : {QStringLiteral("f"), QStringLiteral("fi"), QStringLiteral("fir"), QStringLiteral("fire"), QStringLiteral("firef")}) {
+            matchTexts(runner, query);
+        }
+        for (const QString &query : {QStringLiteral("b"), QStringLiteral("be"), QStringLiteral("ben"), QStringLiteral("bench"), QStringLiteral("benchmark 12")}) {
+            matchTexts(runner, query);
+        }
+    }
+}
+
 QTEST_MAIN(ServiceRunnerTest)
 
 #include "servicerunnertest.moc"
@@ -0,0 +1,198 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include "serviceindex.h"
+
+#include <QFileInfo>
+#include <QMutex>
+#include <QSet>
+
+#include <KServiceTypeTrader>
+#include <KSycoca>
+
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+
+#include "debug.h"
+
+namespace
+{
+QStringList toLower(const QStringList &list)
+{
+    QStringList ret;
+    ret.reserve(list.size());
+    for (const QString &string : list) {
+        ret << string.toLower();
+    }
+    return ret;
+}
+
+QVector<int> intersect(const QVector<int> &a, const QVector<int> &b)
+{
+    QVector<int> ret;
+    std::set_intersection(a.cbegin(), a.cend(), b.cbegin(), b.cend(), std::back_inserter(ret));
+    return ret;
+}
+
+// Exec without the field codes like %U, which are no part of what users search for
+QString withoutFieldCodes(const QString &exec)
+{
+    QString ret;
+    ret.reserve(exec.size());
+    for (int i = 0; i < exec.size(); ++i) {
+        if (exec.at(i) == QLatin1Char('%') && i + 1 < exec.size()) {
+            ++i;
+            if (exec.at(i) == QLatin1Char('%')) {
+                ret += QLatin1Char('%');
+            }
+            continue;
+        }
+        ret += exec.at(i);
+    }
+    return ret.simplified();
+}
+
+} // namespace
+
+std::shared_ptr<const ServiceIndex> ServiceIndex::current()
+{
+    static QMutex mutex;
+    static std::shared_ptr<const ServiceIndex> index;
+
+    // A new database is written whenever applications get (un)installed or changed
+    const QDateTime timestamp = QFileInfo(KSycoca::absoluteFilePath()).lastModified();
+
+    QMutexLocker locker(&mutex);
+    if (!index || index->m_databaseTimestamp != timestamp) {
+        auto newIndex = std::make_shared<ServiceIndex>(KServiceTypeTrader::self()->query(QStringLiteral("Application")));
+        newIndex->m_databaseTimestamp = timestamp;
+        qCDebug(RUNNER_SERVICES) << "Indexed" << newIndex->m_entries.size() << "services";
+        index = std::move(newIndex);
+    }
+    return index;
+}
+
+ServiceIndex::ServiceIndex(const KService::List &services)
+{
+    m_entries.reserve(services.size());
+
+    for (const KService::Ptr &service : services) {
+        Entry entry;
+        entry.service = service;
+        entry.name = service->name().toLower();
+        entry.genericName = service->genericName().toLower();
+        entry.comment = service->comment().toLower();
+        entry.exec = service->exec().toLower();
+        entry.command = withoutFieldCodes(entry.exec);
+        entry.keywords = toLower(service->keywords());
+        entry.categories = toLower(service->categories());
+        entry.actions = service->actions();
+        for (const KServiceAction &action : qAsConst(entry.actions)) {
+            entry.actionTexts << action.text().toLower();
+        }
+
+        const QStringList fields{entry.name, entry.genericName, entry.comment, entry.command};
+        entry.haystack = (fields + entry.keywords + entry.categories + entry.actionTexts).join(QLatin1Char('\n'));
+        entry.charMask = charMask(entry.haystack);
+
+        const int row = m_entries.size();
+        m_names[entry.name] << row;
+
+        QSet<quint64> entryTrigrams;
+        for (const QString &string : entry.categories + entry.actionTexts) {
+            const auto stringTrigrams = trigrams(string);
+            for (quint64 trigram : stringTrigrams) {
+                entryTrigrams.insert(trigram);
+            }
+        }
+        for (quint64 trigram : qAsConst(entryTrigrams)) {
+            m_trigrams[trigram] << row;
+        }
+
+        m_entries << entry;
+    }
+}
+
+QVector<int> ServiceIndex::exactName(const QString &term) const
+{
+    return m_names.value(term.toLower());
+}
+
+QVector<int> ServiceIndex::trigramCandidates(const QString &term) const
+{
+    const QVector<quint64> termTrigrams = trigrams(term.toLower());
+    if (termTrigrams.isEmpty()) {
+        return {};
+    }
+
+    QVector<int> ret = m_trigrams.value(termTrigrams.first());
+    for (int i = 1; i < termTrigrams.size() && !ret.isEmpty(); ++i) {
+        ret = intersect(ret, m_trigrams.value(termTrigrams.at(i)));
+    }
+    return ret;
+}
+
+QVector<int> ServiceIndex::candidates(const QString &term, const QVector<int> &candidates) const
+{
+    // Every kind of match requires at least the first word to be found, possibly as subsequence
+    const QString firstWord = term.section(QLatin1Char(' '), 0, 0, QString::SectionSkipEmpty).toLower();
+    if (firstWord.isEmpty()) {
+        return candidates;
+    }
+
+    const quint64 mask = charMask(firstWord);
+
+    QVector<int> ret;
+    for (int row : candidates) {
+        const Entry &entry = m_entries.at(row);
+        if ((entry.charMask & mask) == mask && isSubsequence(firstWord, entry.haystack)) {
+            ret << row;
+        }
+    }
+    return ret;
+}
+
+QVector<int> ServiceIndex::candidates(const QString &term) const
+{
+    QVector<int> all(m_entries.size());
+    std::iota(all.begin(), all.end(), 0);
+    return candidates(term, all);
+}
+
+bool ServiceIndex::isSubsequence(const QString &lowerPattern, const QString &lowerText)
+{
+    // Same semantics as the ~~ operator of the trader query language
+    if (lowerPattern.isEmpty()) {
+        return false;
+    }
+
+    auto j = lowerPattern.cbegin();
+    for (auto i = lowerText.cbegin(); i != lowerText.cend() && j != lowerPattern.cend(); ++i) {
+        if (*i == *j) {
+            ++j;
+        }
+    }
+    return j == lowerPattern.cend();
+}
+
+quint64 ServiceIndex::charMask(const QString &lowerText)
+{
+    quint64 mask = 0;
+    for (const QChar c : lowerText) {
+        mask |= quint64(1) << (c.unicode() % 64);
+    }
+    return mask;
+}
+
+QVector<quint64> ServiceIndex::trigrams(const QString &lowerText)
+{
+    QVector<quint64> ret;
+    for (int i = 0; i + 2 < lowerText.size(); ++i) {
+        ret << (quint64(lowerText.at(i).unicode()) << 32 | quint64(lowerText.at(i + 1).unicode()) << 16 | quint64(lowerText.at(i + 2).unicode()));
+    }
+    return ret;
+}
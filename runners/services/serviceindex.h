@@ -0,0 +1,96 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#pragma once
+
+#include <QDateTime>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <KService>
+#include <KServiceAction>
+
+#include <memory>
+
+/**
+ * Immutable, in-memory index of all application services known to KSycoca.
+ *
+ * All strings are stored lower-cased. Lookups return positions in entries(),
+ * which keeps the order KServiceTypeTrader reports the services in, so that
+ * results are ordered the same way the trader queries used to order them.
+ *
+ * Use ServiceIndex::current() to get an index matching the current KSycoca
+ * database; the returned snapshot can be used from any thread.
+ */
+class ServiceIndex
+{
+public:
+    struct Entry {
+        KService::Ptr service;
+        QString name;
+        QString genericName;
+        QString comment;
+        QString exec;
+        // Exec without its field codes, what gets matched
+        QString command;
+        QStringList keywords;
+        QStringList categories;
+        QList<KServiceAction> actions;
+        QStringList actionTexts;
+        // Every searchable string, used to narrow down candidates for a query
+        QString haystack;
+        quint64 charMask = 0;
+    };
+
+    static std::shared_ptr<const ServiceIndex> current();
+
+    /**
+     * Builds an index from @p services, mostly useful for testing.
+     */
+    explicit ServiceIndex(const KService::List &services);
+
+    const QVector<Entry> &entries() const
+    {
+        return m_entries;
+    }
+
+    /**
+     * @returns the services whose name is equal to @p term, case-insensitively
+     */
+    QVector<int> exactName(const QString &term) const;
+
+    /**
+     * @returns the services whose categories or action texts contain all the trigrams of @p term.
+     * This is a superset of the services having a category or action containing @p term.
+     * Only meaningful for terms of at least three characters.
+     */
+    QVector<int> trigramCandidates(const QString &term) const;
+
+    /**
+     * @returns the services among @p candidates which may match @p term in any field.
+     * For a term starting with the term @p candidates were computed for, the result only
+     * ever shrinks, so callers can narrow down the previous result while the user types.
+     */
+    QVector<int> candidates(const QString &term, const QVector<int> &candidates) const;
+    QVector<int> candidates(const QString &term) const;
+
+    /**
+     * Case-insensitive subsequence match, like the ~~ trader query operator
+     */
+    static bool isSubsequence(const QString &lowerPattern, const QString &lowerText);
+
+private:
+    static quint64 charMask(const QString &lowerText);
+    static QVector<quint64> trigrams(const QString &lowerText);
+
+    QVector<Entry> m_entries;
+    QHash<QString, QVector<int>> m_names;
+    QHash<quint64, QVector<int>> m_trigrams;
+
+    QDateTime m_databaseTimestamp;
+};
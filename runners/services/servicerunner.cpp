@@ -23,7 +23,6 @@
 #include <KLocalizedString>
 #include <KNotificationJobUiDelegate>
 #include <KServiceAction>
-#include <KServiceTypeTrader>
 #include <KStringHandler>
 #include <KSycoca>
 
@@ -31,6 +30,7 @@
 #include <KIO/DesktopExecParser>
 
 #include "debug.h"
+#include "serviceindex.h"
 
 namespace
 {
@@ -47,20 +47,17 @@ int weightedLength(const QString &query)
 class ServiceFinder
 {
 public:
-    ServiceFinder(ServiceRunner *runner)
+    ServiceFinder(ServiceRunner *runner, const std::shared_ptr<const ServiceIndex> &index, const QVector<int> &candidates)
         : m_runner(runner)
+        , m_index(index)
+        , m_candidates(candidates)
     {
     }
 
     void match(Plasma::RunnerContext &context)
     {
-        if (!context.isValid()) {
-            return;
-        }
-
-        KSycoca::disableAutoRebuild();
-
         term = context.query();
+        lowerTerm = term.toLower();
         weightedTermLength = weightedLength(term);
 
         matchExectuables();
@@ -130,31 +127,49 @@ private:
         return relevanceIncrement;
     }
 
-    QString generateQuery(const QVector<QStringRef> &strList)
+    static bool allSubsequences(const QStringList &words, const QString &text)
+    {
+        return !text.isEmpty() && std::all_of(words.cbegin(), words.cend(), [&text](const QString &word) {
+                   return ServiceIndex::isSubsequence(word, text);
+               });
+    }
+
+    static bool containedInAny(const QString &word, const QStringList &list)
+    {
+        return std::any_of(list.cbegin(), list.cend(), [&word](const QString &string) {
+            return string.contains(word);
+        });
+    }
+
+    bool matchesNameKeywordOrGenericName(const ServiceIndex::Entry &entry, const QStringList &words) const
     {
-        QString keywordTemplate = QStringLiteral("exist Keywords");
-        QString genericNameTemplate = QStringLiteral("exist GenericName");
-        QString nameTemplate = QStringLiteral("exist Name");
-        QString commentTemplate = QStringLiteral("exist Comment");
-
-        // Search for applications which are executable and the term case-insensitive matches any of
-        // * a substring of one of the keywords
-        // * a substring of the GenericName field
-        // * a substring of the Name field
-        // Note that before asking for the content of e.g. Keywords and GenericName we need to ask if
-        // they exist to prevent a tree evaluation error if they are not defined.
-        for (const QStringRef &str : strList) {
-            keywordTemplate += QStringLiteral(" and '%1' ~subin Keywords").arg(str.toString());
-            genericNameTemplate += QStringLiteral(" and '%1' ~~ GenericName").arg(str.toString());
-            nameTemplate += QStringLiteral(" and '%1' ~~ Name").arg(str.toString());
-            commentTemplate += QStringLiteral(" and '%1' ~~ Comment").arg(str.toString());
+        if (entry.exec.isEmpty()) {
+            return false;
+        }
+
+        // If the term length is < 3, no real point searching the Keywords and GenericName
+        if (weightedTermLength < 3) {
+            return ServiceIndex::isSubsequence(lowerTerm, entry.name) || ServiceIndex::isSubsequence(lowerTerm, entry.command);
         }
 
-        QString finalQuery = QStringLiteral("exist Exec and ( (%1) or (%2) or (%3) or ('%4' ~~ Exec) or (%5) )")
-                                 .arg(keywordTemplate, genericNameTemplate, nameTemplate, strList[0].toString(), commentTemplate);
+        if (words.isEmpty()) {
+            return false;
+        }
 
-        qCDebug(RUNNER_SERVICES) << "Final query : " << finalQuery;
-        return finalQuery;
+        // Match using subsequences (Bug: 262837): the term case-insensitively matches any of
+        // * a substring of one of the keywords, for every word
+        // * a subsequence of the GenericName field, for every word
+        // * a subsequence of the Name field, for every word
+        // * a subsequence of the Exec field, for the first word
+        // * a subsequence of the Comment field, for every word
+        return (!entry.keywords.isEmpty()
+                && std::all_of(words.cbegin(),
+                               words.cend(),
+                               [&entry](const QString &word) {
+                                   return containedInAny(word, entry.keywords);
+                               }))
+            || allSubsequences(words, entry.genericName) || allSubsequences(words, entry.name) || ServiceIndex::isSubsequence(words.first(), entry.command)
+            || allSubsequences(words, entry.comment);
     }
 
     void setupMatch(const KService::Ptr &service, Plasma::QueryMatch &match)
@@ -192,16 +207,13 @@ private:
         }
 
         // Search for applications which are executable and case-insensitively match the search term
-        // See https://techbase.kde.org/Development/Tutorials/Services/Traders#The_KTrader_Query_Language
-        // if the following is unclear to you.
-        query = QStringLiteral("exist Exec and ('%1' =~ Name)").arg(term);
-        const KService::List services = KServiceTypeTrader::self()->query(QStringLiteral("Application"), query);
-
-        if (services.isEmpty()) {
-            return;
-        }
-
-        for (const KService::Ptr &service : services) {
+        const QVector<int> rows = m_index->exactName(term);
+        for (int row : rows) {
+            const ServiceIndex::Entry &entry = m_index->entries().at(row);
+            if (entry.exec.isEmpty()) {
+                continue;
+            }
+            const KService::Ptr &service = entry.service;
             qCDebug(RUNNER_SERVICES) << service->name() << "is an exact match!" << service->storageId() << service->exec();
             if (disqualify(service)) {
                 continue;
@@ -217,20 +229,19 @@ private:
     void matchNameKeywordAndGenericName()
     {
         // Splitting the query term to match using subsequences
-        QVector<QStringRef> queryList = term.splitRef(QLatin1Char(' '));
-
-        // If the term length is < 3, no real point searching the Keywords and GenericName
-        if (weightedTermLength < 3) {
-            query = QStringLiteral("exist Exec and ( (exist Name and '%1' ~~ Name) or ('%1' ~~ Exec) )").arg(term);
-        } else {
-            // Match using subsequences (Bug: 262837)
-            query = generateQuery(queryList);
+        // Repeated spaces don't make empty words, those would match anything
+        QVector<QStringRef> queryList = term.splitRef(QLatin1Char(' '), Qt::SkipEmptyParts);
+        const QStringList words = lowerTerm.split(QLatin1Char(' '), Qt::SkipEmptyParts);
+        if (words.isEmpty()) {
+            return;
         }
 
-        const KService::List services = KServiceTypeTrader::self()->query(QStringLiteral("Application"), query);
-
-        qCDebug(RUNNER_SERVICES) << "got " << services.count() << " services from " << query;
-        for (const KService::Ptr &service : services) {
+        for (int row : qAsConst(m_candidates)) {
+            const ServiceIndex::Entry &entry = m_index->entries().at(row);
+            if (!matchesNameKeywordOrGenericName(entry, words)) {
+                continue;
+            }
+            const KService::Ptr &service = entry.service;
             if (disqualify(service)) {
                 continue;
             }
@@ -297,10 +308,13 @@ private:
     void matchCategories()
     {
         // search for applications whose categories contains the query
-        query = QStringLiteral("exist Exec and (exist Categories and '%1' ~subin Categories)").arg(term);
-        const auto services = KServiceTypeTrader::self()->query(QStringLiteral("Application"), query);
-
-        for (const KService::Ptr &service : services) {
+        const QVector<int> rows = lowerTerm.size() >= 3 ? m_index->trigramCandidates(lowerTerm) : m_candidates;
+        for (int row : rows) {
+            const ServiceIndex::Entry &entry = m_index->entries().at(row);
+            if (entry.exec.isEmpty() || !containedInAny(lowerTerm, entry.categories)) {
+                continue;
+            }
+            const KService::Ptr &service = entry.service;
             qCDebug(RUNNER_SERVICES) << service->name() << "is an exact match!" << service->storageId() << service->exec();
             if (disqualify(service)) {
                 continue;
@@ -330,11 +344,11 @@ private:
             return;
         }
 
-        query = QStringLiteral("exist Actions"); // doesn't work
-        const auto services = KServiceTypeTrader::self()->query(QStringLiteral("Application")); //, query);
-
-        for (const KService::Ptr &service : services) {
-            if (service->noDisplay()) {
+        const QVector<int> rows = lowerTerm.size() >= 3 ? m_index->trigramCandidates(lowerTerm) : m_candidates;
+        for (int row : rows) {
+            const ServiceIndex::Entry &entry = m_index->entries().at(row);
+            const KService::Ptr &service = entry.service;
+            if (entry.actions.isEmpty() || service->noDisplay()) {
                 continue;
             }
 
@@ -343,8 +357,7 @@ private:
                 continue;
             }
 
-            const auto actions = service->actions();
-            for (const KServiceAction &action : actions) {
+            for (const KServiceAction &action : entry.actions) {
                 if (action.text().isEmpty() || action.exec().isEmpty() || hasSeen(action)) {
                     continue;
                 }
@@ -389,11 +402,13 @@ private:
     }
 
     ServiceRunner *m_runner;
+    const std::shared_ptr<const ServiceIndex> m_index;
+    const QVector<int> m_candidates;
     QSet<QString> m_seen;
 
     QList<Plasma::QueryMatch> matches;
-    QString query;
     QString term;
+    QString lowerTerm;
     int weightedTermLength = -1;
 };
 
@@ -410,9 +425,37 @@ ServiceRunner::~ServiceRunner() = default;
 
 void ServiceRunner::match(Plasma::RunnerContext &context)
 {
+    if (!context.isValid()) {
+        return;
+    }
+
+    KSycoca::disableAutoRebuild();
+
+    const std::shared_ptr<const ServiceIndex> index = ServiceIndex::current();
+    const QString term = context.query();
+
+    QueryCache cache;
+    {
+        QMutexLocker locker(&m_cacheMutex);
+        cache = m_cache;
+    }
+
+    // While the user types, candidates only ever get fewer: narrow down the previous ones
+    QVector<int> candidates;
+    if (cache.index == index && !cache.term.isEmpty() && term.startsWith(cache.term, Qt::CaseInsensitive)) {
+        candidates = index->candidates(term, cache.candidates);
+    } else {
+        candidates = index->candidates(term);
+    }
+
+    {
+        QMutexLocker locker(&m_cacheMutex);
+        m_cache = {index, term, candidates};
+    }
+
     // This helper class aids in keeping state across numerous
     // different queries that together form the matches set.
-    ServiceFinder finder(this);
+    ServiceFinder finder(this, index, candidates);
     finder.match(context);
 }
 
@@ -6,11 +6,18 @@
 
 #pragma once
 
+#include <QMutex>
+#include <QVector>
+
 #include <KService>
 
+#include <memory>
+
 //#include <KRunner/AbstractRunner>
 #include <krunner/abstractrunner.h>
 
+class ServiceIndex;
+
 /**
  * This class looks for matches in the set of .desktop files installed by
  * applications. This way the user can type exactly what they see in the
@@ -34,4 +41,14 @@ protected Q_SLOTS:
 
 protected:
     void setupMatch(const KService::Ptr &service, Plasma::QueryMatch &action);
+
+private:
+    struct QueryCache {
+        std::shared_ptr<const ServiceIndex> index;
+        QString term;
+        QVector<int> candidates;
+    };
+
+    QMutex m_cacheMutex;
+    QueryCache m_cache;
 };
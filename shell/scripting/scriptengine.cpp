@@ -8,11 +8,13 @@
 #include "scriptengine_v1.h"
 
 #include <QDir>
+#include <QDateTime>
 #include <QDirIterator>
 #include <QFile>
 #include <QFileInfo>
 #include <QFutureWatcher>
 #include <QJSValueIterator>
+#include <QSet>
 #include <QStandardPaths>
 
 #include <KLocalizedContext>
@@ -274,6 +276,20 @@ QStringList ScriptEngine::pendingUpdateScripts(Plasma::Corona *corona)
     const QStringList dirs = QStandardPaths::locateAll(QStandardPaths::GenericDataLocation,
                                                        "plasma/shells/" + appName + QStringLiteral("/contents/updates"),
                                                        QStandardPaths::LocateDirectory);
+
+    // Scripts are only ever added by installing new files, which touches the directory:
+    // if none of the update directories changed since the last run, there is nothing to do
+    QStringList dirsState;
+    dirsState.reserve(dirs.count());
+    for (const QString &dir : dirs) {
+        dirsState.append(dir + QLatin1Char(':') + QString::number(QFileInfo(dir).lastModified().toMSecsSinceEpoch()));
+    }
+
+    KConfigGroup cg(KSharedConfig::openConfig(), "Updates");
+    if (cg.readEntry("directoriesState", QStringList()) == dirsState) {
+        return QStringList();
+    }
+
     for (const QString &dir : dirs) {
         QDirIterator it(dir, QStringList() << QStringLiteral("*.js"));
         while (it.hasNext()) {
@@ -282,16 +298,12 @@ QStringList ScriptEngine::pendingUpdateScripts(Plasma::Corona *corona)
     }
     QStringList scriptPaths;
 
-    if (scripts.isEmpty()) {
-        return scriptPaths;
-    }
-
-    KConfigGroup cg(KSharedConfig::openConfig(), "Updates");
     QStringList performed = cg.readEntry("performed", QStringList());
+    const QSet<QString> performedSet(performed.cbegin(), performed.cend());
     const QString localXdgDir = QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation);
 
-    foreach (const QString &script, scripts) {
-        if (performed.contains(script)) {
+    for (const QString &script : qAsConst(scripts)) {
+        if (performedSet.contains(script)) {
             continue;
         }
 
@@ -303,7 +315,10 @@ QStringList ScriptEngine::pendingUpdateScripts(Plasma::Corona *corona)
         performed.append(script);
     }
 
-    cg.writeEntry("performed", performed);
+    if (!scriptPaths.isEmpty()) {
+        cg.writeEntry("performed", performed);
+    }
+    cg.writeEntry("directoriesState", dirsState);
     KSharedConfig::openConfig()->sync();
     return scriptPaths;
 }
@@ -15,6 +15,7 @@
 #include <QApplication>
 #include <QDBusConnection>
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QMenu>
 #include <QQmlContext>
 #include <QScreen>
@@ -73,6 +74,7 @@
 #endif
 
 static const int s_configSyncDelay = 10000; // 10 seconds
+static const int s_viewCreationBudget = 16; // ms, roughly one frame
 
 ShellCorona::ShellCorona(QObject *parent)
     : Plasma::Corona(parent)
@@ -631,11 +633,28 @@ void ShellCorona::load()
 
     m_screenPool->load(m_primaryWatcher->primaryScreen());
 
+    QElapsedTimer loadTimer;
+    loadTimer.start();
+
     // TODO: a kconf_update script is needed
     QString configFileName(QStringLiteral("plasma-") + m_shell + QStringLiteral("-appletsrc"));
 
+    // Desktops of activities other than the current one are not shown at login:
+    // keep them as plain config and only instantiate them when switching to their activity.
+    // Holding the shared config here makes loadLayout() operate on this very same instance
+    KSharedConfig::Ptr layoutConfig = KSharedConfig::openConfig(configFileName, KConfig::SimpleConfig);
+    KConfig deferredStash(QString(), KConfig::SimpleConfig);
+    KConfigGroup deferredStashGroup(&deferredStash, "Containments");
+    const int deferredCount = stashInactiveActivityContainments(layoutConfig, deferredStashGroup);
+
     loadLayout(configFileName);
 
+    if (deferredCount > 0) {
+        // Put the stashed groups back right away, so that syncing the layout never loses them
+        KConfigGroup containmentsGroup(layoutConfig, "Containments");
+        deferredStashGroup.copyTo(&containmentsGroup);
+    }
+
     checkActivities();
 
     if (containments().isEmpty()) {
@@ -679,9 +698,17 @@ void ShellCorona::load()
         // the containments may have been created already by the startup script
         // check their existence in order to not have duplicated desktopviews
         if (!m_desktopViewforId.contains(m_screenPool->id(screen->name()))) {
-            addOutput(screen);
+            if (screen == m_primaryWatcher->primaryScreen()) {
+                m_pendingOutputs.prepend(screen);
+            } else {
+                m_pendingOutputs.append(screen);
+            }
         }
     }
+    // Views are created a few at a time, so the compositor doesn't see us frozen
+    // while all the screens are populated
+    addPendingOutputs();
+
     connect(qGuiApp, &QGuiApplication::screenAdded, this, &ShellCorona::addOutput, Qt::UniqueConnection);
     connect(qGuiApp, &QGuiApplication::screenRemoved, this, &ShellCorona::handleScreenRemoved, Qt::UniqueConnection);
     connect(m_primaryWatcher, &PrimaryOutputWatcher::primaryOutputNameChanged, this, &ShellCorona::primaryOutputNameChanged, Qt::UniqueConnection);
@@ -696,6 +723,133 @@ void ShellCorona::load()
         KConfigGroup coronaConfig(config(), "General");
         setImmutability((Plasma::Types::ImmutabilityType)coronaConfig.readEntry("immutability", static_cast<int>(Plasma::Types::Mutable)));
     }
+
+    qCDebug(PLASMASHELL) << "Layout loaded in" << loadTimer.elapsed() << "ms with" << containments().count() << "containments,"
+                         << deferredCount << "containments of inactive activities deferred";
+}
+
+int ShellCorona::stashInactiveActivityContainments(const KSharedConfig::Ptr &layoutConfig, KConfigGroup &stash)
+{
+    const QString currentActivity = m_activityController->currentActivity();
+    const QStringList activities = m_activityController->activities();
+
+    KConfigGroup containmentsGroup(layoutConfig, "Containments");
+    const QStringList groups = containmentsGroup.groupList();
+
+    auto maxIdOf = [](const KConfigGroup &containmentConfig) {
+        uint maxId = containmentConfig.name().toUInt();
+        const QStringList applets = KConfigGroup(&containmentConfig, "Applets").groupList();
+        for (const QString &applet : applets) {
+            maxId = std::max(maxId, applet.toUInt());
+        }
+        return maxId;
+    };
+
+    QStringList candidates;
+    uint maxLoadedId = 0;
+    uint maxDeferredId = 0;
+    QString maxDeferredGroup;
+    for (const QString &group : groups) {
+        const KConfigGroup containmentConfig(&containmentsGroup, group);
+        const QString activity = containmentConfig.readEntry("activityId", QString());
+        const uint maxId = maxIdOf(containmentConfig);
+        // Containments of unknown activities are still loaded, checkActivities() gets rid of them
+        if (activity.isEmpty() || activity == currentActivity || !activities.contains(activity)) {
+            maxLoadedId = std::max(maxLoadedId, maxId);
+            continue;
+        }
+        candidates << group;
+        if (maxId > maxDeferredId) {
+            maxDeferredId = maxId;
+            maxDeferredGroup = group;
+        }
+    }
+
+    // Plasma hands out new ids above the highest one it has seen: the deferred containment holding
+    // the highest id gets loaded anyways, so that new applets never collide with a deferred one
+    if (maxDeferredId > maxLoadedId) {
+        candidates.removeOne(maxDeferredGroup);
+    }
+
+    // Leave at least one containment, otherwise loadLayout() could fall back to the default layout
+    if (candidates.isEmpty() || candidates.count() == groups.count()) {
+        return 0;
+    }
+
+    for (const QString &group : qAsConst(candidates)) {
+        KConfigGroup containmentConfig(&containmentsGroup, group);
+        KConfigGroup stashed(&stash, group);
+        containmentConfig.copyTo(&stashed);
+        containmentConfig.deleteGroup();
+        m_deferredContainments[stashed.readEntry("activityId", QString())] << group;
+    }
+
+    return candidates.count();
+}
+
+QList<Plasma::Containment *> ShellCorona::importDeferredContainments(const QStringList &groups)
+{
+    if (groups.isEmpty()) {
+        return {};
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // importLayout() merges the given config into ours, so feed it a copy of just those groups
+    KConfig layout(QString(), KConfig::SimpleConfig);
+    KConfigGroup layoutContainments(&layout, "Containments");
+    KConfigGroup containmentsGroup(config(), "Containments");
+    for (const QString &group : groups) {
+        KConfigGroup containmentConfig(&containmentsGroup, group);
+        if (!containmentConfig.exists()) {
+            continue;
+        }
+        KConfigGroup copy(&layoutContainments, group);
+        containmentConfig.copyTo(&copy);
+    }
+
+    const QList<Plasma::Containment *> newContainments = importLayout(KConfigGroup(&layout, QString()));
+    for (Plasma::Containment *containment : newContainments) {
+        if (containment->containmentType() == Plasma::Types::DesktopContainment || containment->containmentType() == Plasma::Types::CustomContainment) {
+            insertContainment(containment->activity(), std::max(containment->lastScreen(), 0), containment);
+        }
+    }
+
+    qCDebug(PLASMASHELL) << "Instantiated" << newContainments.count() << "deferred containments in" << timer.elapsed() << "ms";
+
+    return newContainments;
+}
+
+void ShellCorona::importNextDeferredContainment(const QString &activity)
+{
+    auto it = m_deferredContainments.find(activity);
+    if (it != m_deferredContainments.end()) {
+        importDeferredContainments({it->takeFirst()});
+        // the hash may have been changed by whatever reacted to the new containment
+        it = m_deferredContainments.find(activity);
+        if (it != m_deferredContainments.end() && it->isEmpty()) {
+            m_deferredContainments.erase(it);
+        }
+    }
+
+    if (m_deferredContainments.contains(activity)) {
+        // one containment per event loop pass, so that the shell stays responsive
+        QTimer::singleShot(0, this, [this, activity]() {
+            importNextDeferredContainment(activity);
+        });
+    } else if (m_activityController->currentActivity() == activity) {
+        currentActivityChanged(activity);
+    }
+}
+
+void ShellCorona::importAllDeferredContainments()
+{
+    const auto deferred = m_deferredContainments;
+    m_deferredContainments.clear();
+    for (const QStringList &groups : deferred) {
+        importDeferredContainments(groups);
+    }
 }
 
 void ShellCorona::primaryOutputNameChanged()
@@ -839,7 +993,9 @@ void ShellCorona::unload()
     qDeleteAll(m_panelViews);
     m_panelViews.clear();
     m_waitingPanels.clear();
+    m_pendingOutputs.clear();
     m_activityContainmentPlugins.clear();
+    m_deferredContainments.clear();
 
     while (!containments().isEmpty()) {
         // Some applets react to destroyedChanged rather just destroyed,
@@ -938,6 +1094,9 @@ void ShellCorona::processUpdateScripts()
         return;
     }
 
+    // update scripts expect to see every containment
+    importAllDeferredContainments();
+
     WorkspaceScripting::ScriptEngine scriptEngine(this);
 
     connect(&scriptEngine, &WorkspaceScripting::ScriptEngine::printError, this, [](const QString &msg) {
@@ -1241,26 +1400,101 @@ void ShellCorona::addOutput(QScreen *screen)
     CHECK_SCREEN_INVARIANTS
 }
 
+void ShellCorona::addPendingOutputs()
+{
+    QElapsedTimer timer;
+    timer.start();
+    int createdViews = 0;
+    bool createdPanels = false;
+
+    while (!m_pendingOutputs.isEmpty()) {
+        // creating a view cannot be interrupted, so don't start one which would not fit in the frame anymore
+        if (createdViews > 0 && timer.elapsed() + m_lastViewCreationTime >= s_viewCreationBudget) {
+            break;
+        }
+
+        QScreen *screen = m_pendingOutputs.first();
+        const int screenId = screen ? m_screenPool->id(screen->name()) : -1;
+        // the screen may have gone away or been added by screenAdded in the meantime
+        if (!screen || m_desktopViewforId.contains(screenId)) {
+            m_pendingOutputs.removeFirst();
+            continue;
+        }
+
+        // the panels of a screen come first, they are what the user is waiting for.
+        // Only for screens which get a desktop, addOutput() takes care of null and redundant ones,
+        // and panels which were never placed wait for the desktops like before
+        Plasma::Containment *panel = nullptr;
+        if (screenId >= 0 && !screen->geometry().isNull() && !isOutputRedundant(screen)) {
+            auto it = std::find_if(m_waitingPanels.cbegin(), m_waitingPanels.cend(), [screenId](Plasma::Containment *cont) {
+                return cont->lastScreen() == screenId;
+            });
+            if (it != m_waitingPanels.cend()) {
+                panel = *it;
+            }
+        }
+
+        QElapsedTimer viewTimer;
+        viewTimer.start();
+        if (panel) {
+            m_waitingPanels.removeOne(panel);
+            createPanelView(panel, screen);
+            createdPanels = true;
+        } else {
+            m_pendingOutputs.removeFirst();
+            addOutput(screen);
+        }
+        m_lastViewCreationTime = viewTimer.elapsed();
+        ++createdViews;
+    }
+
+    if (createdPanels) {
+        Q_EMIT availableScreenRectChanged();
+    }
+
+    if (!m_pendingOutputs.isEmpty()) {
+        QTimer::singleShot(0, this, &ShellCorona::addPendingOutputs);
+    } else {
+        // desktops which were already ready when their view got created don't notify again
+        checkAllDesktopsUiReady(true);
+    }
+}
+
 void ShellCorona::checkAllDesktopsUiReady(bool ready)
 {
-    if (!ready)
+    if (!ready || m_desktopStageSent) {
         return;
+    }
+
+    int readyCount = 0;
     for (auto v : qAsConst(m_desktopViewforId)) {
-        if (!v->containment()->isUiReady())
-            return;
+        if (v->containment() && v->containment()->isUiReady()) {
+            ++readyCount;
+        }
+    }
+
+    const int totalCount = m_desktopViewforId.count() + m_pendingOutputs.count();
+    qCDebug(PLASMASHELL) << readyCount << "of" << totalCount << "desktops ready";
 
-        qDebug() << "Plasma Shell startup completed";
-        QDBusMessage ksplashProgressMessage = QDBusMessage::createMethodCall(QStringLiteral("org.kde.KSplash"),
-                                                                             QStringLiteral("/KSplash"),
-                                                                             QStringLiteral("org.kde.KSplash"),
-                                                                             QStringLiteral("setStage"));
-        ksplashProgressMessage.setArguments(QList<QVariant>() << QStringLiteral("desktop"));
-        QDBusConnection::sessionBus().asyncCall(ksplashProgressMessage);
+    if (readyCount < totalCount) {
+        return;
     }
+
+    m_desktopStageSent = true;
+    qDebug() << "Plasma Shell startup completed";
+    QDBusMessage ksplashProgressMessage = QDBusMessage::createMethodCall(QStringLiteral("org.kde.KSplash"),
+                                                                         QStringLiteral("/KSplash"),
+                                                                         QStringLiteral("org.kde.KSplash"),
+                                                                         QStringLiteral("setStage"));
+    ksplashProgressMessage.setArguments(QList<QVariant>() << QStringLiteral("desktop"));
+    QDBusConnection::sessionBus().asyncCall(ksplashProgressMessage);
 }
 
 Plasma::Containment *ShellCorona::createContainmentForActivity(const QString &activity, int screenNum)
 {
+    // never create a duplicate of a containment which is still deferred
+    importDeferredContainments(m_deferredContainments.take(activity));
+
     const auto containments = containmentsForActivity(activity);
     for (Plasma::Containment *cont : containments) {
         // in the case of a corrupt config file
@@ -1292,8 +1526,18 @@ Plasma::Containment *ShellCorona::createContainmentForActivity(const QString &ac
 void ShellCorona::createWaitingPanels()
 {
     QList<Plasma::Containment *> stillWaitingPanels;
+    bool overBudget = false;
+    QElapsedTimer timer;
+    timer.start();
 
     for (Plasma::Containment *cont : qAsConst(m_waitingPanels)) {
+        // leave the rest for the next event loop pass
+        if (overBudget || timer.elapsed() >= s_viewCreationBudget) {
+            overBudget = true;
+            stillWaitingPanels << cont;
+            continue;
+        }
+
         // ignore non existing (yet?) screens
         int requestedScreen = cont->lastScreen();
         if (requestedScreen < 0) {
@@ -1308,25 +1552,33 @@ void ShellCorona::createWaitingPanels()
 
         // TODO: does a similar check make sense?
         // Q_ASSERT(qBound(0, requestedScreen, m_screenPool->count() - 1) == requestedScreen);
-        QScreen *screen = desktopView->screenToFollow();
-        PanelView *panel = new PanelView(this, screen);
-        if (panel->rendererInterface()->graphicsApi() != QSGRendererInterface::Software) {
-            connect(panel, &QQuickWindow::sceneGraphError, this, &ShellCorona::glInitializationFailed);
-        }
-        connect(panel, &QWindow::visibleChanged, this, &Plasma::Corona::availableScreenRectChanged);
-        connect(panel, &QWindow::screenChanged, this, &Plasma::Corona::availableScreenRectChanged);
-        connect(panel, &PanelView::locationChanged, this, &Plasma::Corona::availableScreenRectChanged);
-        connect(panel, &PanelView::visibilityModeChanged, this, &Plasma::Corona::availableScreenRectChanged);
-        connect(panel, &PanelView::thicknessChanged, this, &Plasma::Corona::availableScreenRectChanged);
-
-        m_panelViews[cont] = panel;
-        panel->setContainment(cont);
-        cont->reactToScreenChange();
-
-        connect(cont, &QObject::destroyed, this, &ShellCorona::panelContainmentDestroyed);
+        createPanelView(cont, desktopView->screenToFollow());
     }
     m_waitingPanels = stillWaitingPanels;
     Q_EMIT availableScreenRectChanged();
+
+    if (overBudget) {
+        QTimer::singleShot(0, this, &ShellCorona::createWaitingPanels);
+    }
+}
+
+void ShellCorona::createPanelView(Plasma::Containment *cont, QScreen *screen)
+{
+    PanelView *panel = new PanelView(this, screen);
+    if (panel->rendererInterface()->graphicsApi() != QSGRendererInterface::Software) {
+        connect(panel, &QQuickWindow::sceneGraphError, this, &ShellCorona::glInitializationFailed);
+    }
+    connect(panel, &QWindow::visibleChanged, this, &Plasma::Corona::availableScreenRectChanged);
+    connect(panel, &QWindow::screenChanged, this, &Plasma::Corona::availableScreenRectChanged);
+    connect(panel, &PanelView::locationChanged, this, &Plasma::Corona::availableScreenRectChanged);
+    connect(panel, &PanelView::visibilityModeChanged, this, &Plasma::Corona::availableScreenRectChanged);
+    connect(panel, &PanelView::thicknessChanged, this, &Plasma::Corona::availableScreenRectChanged);
+
+    m_panelViews[cont] = panel;
+    panel->setContainment(cont);
+    cont->reactToScreenChange();
+
+    connect(cont, &QObject::destroyed, this, &ShellCorona::panelContainmentDestroyed);
 }
 
 void ShellCorona::panelContainmentDestroyed(QObject *cont)
@@ -1438,6 +1690,8 @@ QString ShellCorona::evaluateScript(const QString &script)
         }
     }
 
+    importAllDeferredContainments();
+
     WorkspaceScripting::ScriptEngine scriptEngine(this);
     QString buffer;
     QTextStream bufferStream(&buffer, QIODevice::WriteOnly | QIODevice::Text);
@@ -1496,6 +1750,15 @@ void ShellCorona::currentActivityChanged(const QString &newActivity)
 {
     //     qDebug() << "Activity changed:" << newActivity;
 
+    if (m_deferredContainments.contains(newActivity)) {
+        // The desktops keep showing the previous activity until the containments
+        // of the new one are ready, then this gets called again
+        QTimer::singleShot(0, this, [this, newActivity]() {
+            importNextDeferredContainment(newActivity);
+        });
+        return;
+    }
+
     for (auto it = m_desktopViewforId.constBegin(); it != m_desktopViewforId.constEnd(); ++it) {
         Plasma::Containment *c = createContainmentForActivity(newActivity, it.key());
 
@@ -1525,6 +1788,15 @@ void ShellCorona::activityRemoved(const QString &id)
     for (auto cont : containments) {
         cont->destroy();
     }
+
+    const QStringList deferred = m_deferredContainments.take(id);
+    if (!deferred.isEmpty()) {
+        KConfigGroup containmentsGroup(config(), "Containments");
+        for (const QString &group : deferred) {
+            KConfigGroup(&containmentsGroup, group).deleteGroup();
+        }
+        requestConfigSync();
+    }
 }
 
 void ShellCorona::insertActivity(const QString &id, const QString &plugin)
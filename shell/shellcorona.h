@@ -13,6 +13,7 @@
 
 #include <QDBusContext>
 #include <QDBusVariant>
+#include <QPointer>
 #include <QScopedPointer>
 #include <QSet>
 #include <QTimer>
@@ -219,6 +220,12 @@ private:
     void setupWaylandIntegration();
     void executeSetupPlasmoidScript(Plasma::Containment *containment, Plasma::Applet *applet);
     void checkAllDesktopsUiReady(bool ready);
+    /**
+     * Creates the views for the screens in m_pendingOutputs, as many as fit in a frame,
+     * and reschedules itself for the rest
+     */
+    void addPendingOutputs();
+    void createPanelView(Plasma::Containment *cont, QScreen *screen);
 
 #ifndef NDEBUG
     void screenInvariants() const;
@@ -226,6 +233,19 @@ private:
 
     void insertContainment(const QString &activity, int screenNum, Plasma::Containment *containment);
 
+    /**
+     * Moves the containment groups of activities other than the current one from
+     * @p layoutConfig to @p stash, remembering them as deferred
+     * @returns the number of deferred containments
+     */
+    int stashInactiveActivityContainments(const KSharedConfig::Ptr &layoutConfig, KConfigGroup &stash);
+    /**
+     * Instantiates the deferred containments stored in the given config @p groups
+     */
+    QList<Plasma::Containment *> importDeferredContainments(const QStringList &groups);
+    void importNextDeferredContainment(const QString &activity);
+    void importAllDeferredContainments();
+
     KSharedConfig::Ptr m_config;
     QString m_configPath;
 
@@ -238,7 +258,13 @@ private:
     KConfigGroup m_desktopDefaultsConfig;
     KConfigGroup m_lnfDefaultsConfig;
     QList<Plasma::Containment *> m_waitingPanels;
+    QList<QPointer<QScreen>> m_pendingOutputs;
+    // how long the last view took to create, to tell whether the next one still fits in a frame
+    qint64 m_lastViewCreationTime = 0;
+    bool m_desktopStageSent = false;
     QHash<QString, QString> m_activityContainmentPlugins;
+    // activity id -> config groups of its containments which are not instantiated yet
+    QHash<QString, QStringList> m_deferredContainments;
     QAction *m_addPanelAction;
     QScopedPointer<QMenu> m_addPanelsMenu;
     KPackage::Package m_lookAndFeelPackage;
@@ -0,0 +1,118 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include <QTest>
+#include <QX11Info>
+
+#include <xcb/xcb.h>
+#include <xcb/xcb_image.h>
+
+#include "imageutils.h"
+
+class ImageUtilsTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testIsTransparent_data();
+    void testIsTransparent();
+    void benchmarkIsTransparent();
+    void benchmarkCapture_data();
+    void benchmarkCapture();
+};
+
+static QImage filledImage(QImage::Format format, const QColor &color)
+{
+    QImage image(32, 32, format);
+    image.fill(color);
+    return image;
+}
+
+void ImageUtilsTest::testIsTransparent_data()
+{
+    QTest::addColumn<QImage>("image");
+    QTest::addColumn<bool>("transparent");
+
+    QTest::newRow("null") << QImage() << true;
+    QTest::newRow("transparent") << filledImage(QImage::Format_ARGB32, Qt::transparent) << true;
+    QTest::newRow("transparent premultiplied") << filledImage(QImage::Format_ARGB32_Premultiplied, Qt::transparent) << true;
+    QTest::newRow("opaque") << filledImage(QImage::Format_ARGB32, Qt::red) << false;
+    QTest::newRow("no alpha channel") << filledImage(QImage::Format_RGB32, Qt::black) << false;
+    QTest::newRow("other format with alpha") << filledImage(QImage::Format_RGBA8888, Qt::transparent) << true;
+
+    QImage lastPixel = filledImage(QImage::Format_ARGB32, Qt::transparent);
+    lastPixel.setPixel(31, 31, qRgba(0, 0, 0, 1));
+    QTest::newRow("last pixel barely opaque") << lastPixel << false;
+
+    QImage colorOnly = filledImage(QImage::Format_ARGB32, Qt::transparent);
+    colorOnly.setPixel(16, 16, qRgba(255, 255, 255, 0));
+    QTest::newRow("color without alpha") << colorOnly << true;
+}
+
+void ImageUtilsTest::testIsTransparent()
+{
+    QFETCH(QImage, image);
+    QFETCH(bool, transparent);
+
+    QCOMPARE(ImageUtils::isTransparent(image), transparent);
+}
+
+void ImageUtilsTest::benchmarkIsTransparent()
+{
+    // Transparent images are the worst case, every pixel needs to be looked at
+    const QImage image = filledImage(QImage::Format_ARGB32, Qt::transparent);
+
+    QBENCHMARK {
+        ImageUtils::isTransparent(image);
+    }
+}
+
+void ImageUtilsTest::benchmarkCapture_data()
+{
+    QTest::addColumn<QRect>("damage");
+
+    QTest::newRow("whole icon") << QRect();
+    QTest::newRow("damaged part") << QRect(8, 8, 8, 8);
+}
+
+void ImageUtilsTest::benchmarkCapture()
+{
+    QFETCH(QRect, damage);
+
+    if (!QX11Info::isPlatformX11()) {
+        QSKIP("Needs an X server, e.g. Xvfb");
+    }
+
+    xcb_connection_t *c = QX11Info::connection();
+    const xcb_window_t window = xcb_generate_id(c);
+    const uint32_t values[] = {QX11Info::appBlackPixel()};
+    xcb_create_window(c, XCB_COPY_FROM_PARENT, window, QX11Info::appRootWindow(), 0, 0, 32, 32, 0, XCB_WINDOW_CLASS_INPUT_OUTPUT, XCB_COPY_FROM_PARENT, XCB_CW_BACK_PIXEL, values);
+    xcb_map_window(c, window);
+    xcb_flush(c);
+
+    const QSize size(32, 32);
+    xcb_image_t *capture = nullptr;
+    QVERIFY(ImageUtils::captureWindow(c, window, size, QRect(), capture));
+
+    // What SNIProxy::captureWindow does on every damage event
+    QBENCHMARK {
+        QVERIFY(ImageUtils::captureWindow(c, window, size, damage, capture));
+        xcb_image_t *image = ImageUtils::copyImage(capture);
+        QVERIFY(image);
+        xcb_image_destroy(image);
+    }
+
+    QCOMPARE(int(capture->width), size.width());
+    QCOMPARE(int(capture->height), size.height());
+    xcb_image_destroy(capture);
+
+    xcb_destroy_window(c, window);
+    xcb_flush(c);
+}
+
+QTEST_MAIN(ImageUtilsTest)
+
+#include "imageutilstest.moc"
@@ -19,6 +19,7 @@
 #include <xcb/damage.h>
 #include <xcb/xcb_atom.h>
 #include <xcb/xcb_event.h>
+#include <xcb/xfixes.h>
 
 #include "sniproxy.h"
 #include "xcbutils.h"
@@ -58,6 +59,16 @@ void FdoSelectionManager::init()
         qApp->exit(-1);
     }
 
+    // XFixes regions tell which parts of the windows were damaged
+    xcb_prefetch_extension_data(c, &xcb_xfixes_id);
+    const auto *xfixesReply = xcb_get_extension_data(c, &xcb_xfixes_id);
+    m_hasXFixes = xfixesReply && xfixesReply->present;
+    if (m_hasXFixes) {
+        xcb_xfixes_query_version_unchecked(c, XCB_XFIXES_MAJOR_VERSION, XCB_XFIXES_MINOR_VERSION);
+    } else {
+        qCWarning(SNIPROXY) << "could not load xfixes extension, capturing whole windows on damage";
+    }
+
     qApp->installNativeEventFilter(this);
 
     connect(m_selectionOwner, &KSelectionOwner::claimedOwnership, this, &FdoSelectionManager::onClaimedOwnership);
@@ -100,6 +111,31 @@ bool FdoSelectionManager::addDamageWatch(xcb_window_t client)
     return true;
 }
 
+QRect FdoSelectionManager::takeDamage(xcb_window_t client)
+{
+    xcb_connection_t *c = QX11Info::connection();
+    const auto damageId = m_damageWatches.value(client);
+
+    if (!m_hasXFixes) {
+        xcb_damage_subtract(c, damageId, XCB_NONE, XCB_NONE);
+        return QRect();
+    }
+
+    // Move everything damaged so far into a region, not only the area of the event at hand,
+    // so that drawing after this point results in a new event
+    const xcb_xfixes_region_t parts = xcb_generate_id(c);
+    xcb_xfixes_create_region(c, parts, 0, nullptr);
+    xcb_damage_subtract(c, damageId, XCB_NONE, parts);
+    const auto cookie = xcb_xfixes_fetch_region_unchecked(c, parts);
+    xcb_xfixes_destroy_region(c, parts);
+
+    QScopedPointer<xcb_xfixes_fetch_region_reply_t, QScopedPointerPodDeleter> reply(xcb_xfixes_fetch_region_reply(c, cookie, nullptr));
+    if (!reply) {
+        return QRect();
+    }
+    return QRect(reply->extents.x, reply->extents.y, reply->extents.width, reply->extents.height);
+}
+
 bool FdoSelectionManager::nativeEventFilter(const QByteArray &eventType, void *message, long int *result)
 {
     Q_UNUSED(result)
@@ -131,11 +167,11 @@ bool FdoSelectionManager::nativeEventFilter(const QByteArray &eventType, void *m
             undock(destroyedWId);
         }
     } else if (responseType == m_damageEventBase + XCB_DAMAGE_NOTIFY) {
-        const auto damagedWId = reinterpret_cast<xcb_damage_notify_event_t *>(ev)->drawable;
+        const auto event = reinterpret_cast<xcb_damage_notify_event_t *>(ev);
+        const auto damagedWId = event->drawable;
         const auto sniProxy = m_proxies.value(damagedWId);
         if (sniProxy) {
-            sniProxy->update();
-            xcb_damage_subtract(QX11Info::connection(), m_damageWatches[damagedWId], XCB_NONE, XCB_NONE);
+            sniProxy->update(takeDamage(damagedWId));
         }
     } else if (responseType == XCB_CONFIGURE_REQUEST) {
         const auto event = reinterpret_cast<xcb_configure_request_event_t *>(ev);
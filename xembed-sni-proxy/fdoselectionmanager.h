@@ -10,6 +10,7 @@
 #include <QAbstractNativeEventFilter>
 #include <QHash>
 #include <QObject>
+#include <QRect>
 
 #include <xcb/xcb.h>
 
@@ -35,11 +36,17 @@ private Q_SLOTS:
 private:
     void init();
     bool addDamageWatch(xcb_window_t client);
+    /**
+     * Marks the damage of @p client as repaired
+     * @return the bounding rectangle of the damaged area, invalid if it is unknown
+     */
+    QRect takeDamage(xcb_window_t client);
     void dock(xcb_window_t embed_win);
     void undock(xcb_window_t client);
     void setSystemTrayVisual();
 
     uint8_t m_damageEventBase;
+    bool m_hasXFixes = false;
 
     QHash<xcb_window_t, u_int32_t> m_damageWatches;
     QHash<xcb_window_t, SNIProxy *> m_proxies;
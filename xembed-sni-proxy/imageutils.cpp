@@ -0,0 +1,92 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include "imageutils.h"
+
+#include <cstring>
+
+bool ImageUtils::isTransparent(const QImage &image)
+{
+    if (image.isNull()) {
+        return true;
+    }
+
+    if (!image.hasAlphaChannel()) {
+        return false;
+    }
+
+    QImage argbImage = image;
+    if (image.format() != QImage::Format_ARGB32 && image.format() != QImage::Format_ARGB32_Premultiplied) {
+        argbImage = image.convertToFormat(QImage::Format_ARGB32);
+    }
+
+    const int width = argbImage.width();
+    for (int y = 0; y < argbImage.height(); ++y) {
+        const quint32 *line = reinterpret_cast<const quint32 *>(argbImage.constScanLine(y));
+
+        // No branches in here, so that the compiler can vectorize the loop
+        quint32 pixels = 0;
+        for (int x = 0; x < width; ++x) {
+            pixels |= line[x];
+        }
+
+        if (qAlpha(pixels)) {
+            // Found an opaque pixel.
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool ImageUtils::captureWindow(xcb_connection_t *c, xcb_window_t window, const QSize &size, const QRect &damage, xcb_image_t *&capture)
+{
+    const QRect area = damage.intersected(QRect(QPoint(0, 0), size));
+
+    // Only fetch what changed since the last capture
+    if (capture && area.isValid() && capture->width == size.width() && capture->height == size.height() && capture->bpp % 8 == 0) {
+        xcb_image_t *patch = xcb_image_get(c, window, area.x(), area.y(), area.width(), area.height(), 0xFFFFFFFF, XCB_IMAGE_FORMAT_Z_PIXMAP);
+        const bool patched = patch && patch->bpp == capture->bpp && patch->depth == capture->depth;
+        if (patched) {
+            const int bytesPerPixel = patch->bpp / 8;
+            for (int y = 0; y < patch->height; ++y) {
+                memcpy(capture->data + (area.y() + y) * capture->stride + area.x() * bytesPerPixel, patch->data + y * patch->stride, patch->width * bytesPerPixel);
+            }
+        }
+        if (patch) {
+            xcb_image_destroy(patch);
+        }
+        if (patched) {
+            return true;
+        }
+    }
+
+    if (capture) {
+        xcb_image_destroy(capture);
+    }
+    capture = xcb_image_get(c, window, 0, 0, size.width(), size.height(), 0xFFFFFFFF, XCB_IMAGE_FORMAT_Z_PIXMAP);
+    return capture;
+}
+
+xcb_image_t *ImageUtils::copyImage(const xcb_image_t *image)
+{
+    xcb_image_t *copy = xcb_image_create(image->width,
+                                         image->height,
+                                         image->format,
+                                         image->scanline_pad,
+                                         image->depth,
+                                         image->bpp,
+                                         image->unit,
+                                         image->byte_order,
+                                         image->bit_order,
+                                         nullptr,
+                                         0,
+                                         nullptr);
+    if (copy) {
+        memcpy(copy->data, image->data, image->size);
+    }
+    return copy;
+}
@@ -0,0 +1,38 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#pragma once
+
+#include <QImage>
+#include <QRect>
+#include <QSize>
+
+#include <xcb/xcb.h>
+#include <xcb/xcb_image.h>
+
+namespace ImageUtils
+{
+/**
+ * @return whether all pixels of @p image are fully transparent
+ */
+bool isTransparent(const QImage &image);
+
+/**
+ * Brings @p capture up to date with the contents of @p window of the given @p size.
+ *
+ * If @p capture holds the window contents already and @p damage is valid, only the
+ * damaged part of it gets fetched from the X server, otherwise @p capture is replaced
+ * by a capture of the whole window.
+ *
+ * @return whether @p capture holds the window contents
+ */
+bool captureWindow(xcb_connection_t *c, xcb_window_t window, const QSize &size, const QRect &damage, xcb_image_t *&capture);
+
+/**
+ * @return a copy of @p image, to be destroyed with xcb_image_destroy
+ */
+xcb_image_t *copyImage(const xcb_image_t *image);
+}
@@ -13,6 +13,7 @@
 #include <xcb/xcb_event.h>
 
 #include "debug.h"
+#include "imageutils.h"
 #include "xcbutils.h"
 
 #include <QGuiApplication>
@@ -64,6 +65,7 @@ SNIProxy::SNIProxy(xcb_window_t wid, QObject *parent)
     // service closing instead lets use one DBus connection per SNI
     m_dbus(QDBusConnection::connectToBus(QDBusConnection::SessionBus, QStringLiteral("XembedSniProxy%1").arg(s_serviceCount++)))
     , m_windowId(wid)
+    , m_lastCapture(nullptr)
     , sendingClickEvent(false)
     , m_injectMode(Direct)
 {
@@ -173,20 +175,26 @@ SNIProxy::SNIProxy(xcb_window_t wid, QObject *parent)
     // there's no damage event for the first paint, and sometimes it's not drawn immediately
     // not ideal, but it works better than nothing
     // test with xchat before changing
-    QTimer::singleShot(500, this, &SNIProxy::update);
+    QTimer::singleShot(500, this, [this] {
+        update();
+    });
 }
 
 SNIProxy::~SNIProxy()
 {
     auto c = QX11Info::connection();
 
+    if (m_lastCapture) {
+        xcb_image_destroy(m_lastCapture);
+    }
+
     xcb_destroy_window(c, m_containerWid);
     QDBusConnection::disconnectFromBus(m_dbus.name());
 }
 
-void SNIProxy::update()
+void SNIProxy::update(const QRect &damage)
 {
-    const QImage image = getImageNonComposite();
+    const QImage image = getImageNonComposite(damage);
     if (image.isNull()) {
         qCDebug(SNIPROXY) << "No xembed icon for" << m_windowId << Title();
         return;
@@ -256,36 +264,21 @@ void sni_cleanup_xcb_image(void *data)
     xcb_image_destroy(static_cast<xcb_image_t *>(data));
 }
 
-bool SNIProxy::isTransparentImage(const QImage &image) const
+xcb_image_t *SNIProxy::captureWindow(const QSize &size, const QRect &damage)
 {
-    int w = image.width();
-    int h = image.height();
-
-    // check for the center and sub-center pixels first and avoid full image scan
-    if (!(qAlpha(image.pixel(w >> 1, h >> 1)) + qAlpha(image.pixel(w >> 2, h >> 2)) == 0))
-        return false;
-
-    // skip scan altogether if sub-center pixel found to be opaque
-    // and break out from the outer loop too on full scan
-    for (int x = 0; x < w; ++x) {
-        for (int y = 0; y < h; ++y) {
-            if (qAlpha(image.pixel(x, y))) {
-                // Found an opaque pixel.
-                return false;
-            }
-        }
+    if (!ImageUtils::captureWindow(QX11Info::connection(), m_windowId, size, damage, m_lastCapture)) {
+        return nullptr;
     }
 
-    return true;
+    // The conversion takes over, and possibly modifies, the image it gets, keep ours for patching
+    return ImageUtils::copyImage(m_lastCapture);
 }
 
-QImage SNIProxy::getImageNonComposite() const
+QImage SNIProxy::getImageNonComposite(const QRect &damage)
 {
-    auto c = QX11Info::connection();
-
     QSize clientWindowSize = calculateClientWindowSize();
 
-    xcb_image_t *image = xcb_image_get(c, m_windowId, 0, 0, clientWindowSize.width(), clientWindowSize.height(), 0xFFFFFFFF, XCB_IMAGE_FORMAT_Z_PIXMAP);
+    xcb_image_t *image = captureWindow(clientWindowSize, damage);
 
     // Don't hook up cleanup yet, we may use a different QImage after all
     QImage naiveConversion;
@@ -296,14 +289,14 @@ QImage SNIProxy::getImageNonComposite() const
         return QImage();
     }
 
-    if (isTransparentImage(naiveConversion)) {
+    if (ImageUtils::isTransparent(naiveConversion)) {
         QImage elaborateConversion = QImage(convertFromNative(image));
 
         // Update icon only if it is at least partially opaque.
         // This is just a workaround for X11 bug: xembed icon may suddenly
         // become transparent for a one or few frames. Reproducible at least
         // with WINE applications.
-        if (isTransparentImage(elaborateConversion)) {
+        if (ImageUtils::isTransparent(elaborateConversion)) {
             qCDebug(SNIPROXY) << "Skip transparent xembed icon for" << m_windowId << Title();
             return QImage();
         } else
@@ -399,9 +392,9 @@ QPoint SNIProxy::calculateClickPoint() const
         return clickPoint;
     }
 
-    const QImage image = getImageNonComposite();
+    const QSize clientWindowSize = calculateClientWindowSize();
 
-    double minLength = sqrt(pow(image.height(), 2) + pow(image.width(), 2));
+    double minLength = sqrt(pow(clientWindowSize.height(), 2) + pow(clientWindowSize.width(), 2));
     const int nRectangles = xcb_shape_get_rectangles_rectangles_length(rectanglesReply.get());
     for (int i = 0; i < nRectangles; ++i) {
         double length = sqrt(pow(rectangles[i].x, 2) + pow(rectangles[i].y, 2));
@@ -14,6 +14,7 @@
 #include <QObject>
 #include <QPixmap>
 #include <QPoint>
+#include <QRect>
 
 #include <xcb/xcb.h>
 #include <xcb/xcb_image.h>
@@ -35,7 +36,10 @@ public:
     explicit SNIProxy(xcb_window_t wid, QObject *parent = nullptr);
     ~SNIProxy() override;
 
-    void update();
+    /**
+     * Captures the window again, if @p damage is valid only the damaged part of it
+     */
+    void update(const QRect &damage = QRect());
     void resizeWindow(const uint16_t width, const uint16_t height) const;
     void hideContainerWindow(xcb_window_t windowId) const;
 
@@ -137,8 +141,8 @@ private:
 
     QSize calculateClientWindowSize() const;
     void sendClick(uint8_t mouseButton, int x, int y);
-    QImage getImageNonComposite() const;
-    bool isTransparentImage(const QImage &image) const;
+    QImage getImageNonComposite(const QRect &damage = QRect());
+    xcb_image_t *captureWindow(const QSize &size, const QRect &damage);
     QImage convertFromNative(xcb_image_t *xcbImage) const;
     QPoint calculateClickPoint() const;
     void stackContainerWindow(const uint32_t stackMode) const;
@@ -148,6 +152,8 @@ private:
     xcb_window_t m_containerWid;
     static int s_serviceCount;
     QPixmap m_pixmap;
+    // Contents of the window as of the last update, patched with the damaged areas
+    xcb_image_t *m_lastCapture;
     bool sendingClickEvent;
     InjectMode m_injectMode;
 };